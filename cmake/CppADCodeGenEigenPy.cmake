@@ -0,0 +1,145 @@
+# Build CppADCodeGenEigenPy models into static libraries.
+#
+# Including this file provides the function
+#
+#   cppadcg_add_model(<target>
+#                     MODEL_HEADER <header>
+#                     MODEL_CLASS <class>
+#                     MODEL_NAME <name>
+#                     [ORDER Zero|First|Second]
+#                     [SCALAR <type>]
+#                     [INCLUDE_DIRECTORIES <dir>...]
+#                     [COMPILE_OPTIONS <option>...])
+#
+# which generates the C sources of the model <class> (an ADModel subclass,
+# e.g. MyModel<double>, defined in <header>) at configure time and compiles
+# them into the static library <target>. Linking against <target> provides
+# the header <name>.h, which defines the type <name>Kernels for use with
+# CppADCodeGenEigenPy::StaticModel.
+#
+# Interprocedural optimization is enabled for <target> when supported; it
+# should also be enabled for the targets using the model so that the generated
+# code can be inlined into them.
+#
+# The sources are regenerated when <header> changes, but not when other files
+# it includes change: re-run CMake in that case.
+
+enable_language(C)
+include(CheckIPOSupported)
+
+set(CPPADCG_EIGENPY_CMAKE_DIR ${CMAKE_CURRENT_LIST_DIR})
+
+# This file is either in the source tree or installed to
+# <prefix>/share/CppADCodeGenEigenPy/cmake
+find_path(
+  CPPADCG_EIGENPY_INCLUDE_DIR CppADCodeGenEigenPy/ADModel.h
+  HINTS ${CMAKE_CURRENT_LIST_DIR}/../include
+        ${CMAKE_CURRENT_LIST_DIR}/../../../include
+)
+
+check_ipo_supported(RESULT CPPADCG_EIGENPY_IPO_SUPPORTED LANGUAGES C CXX)
+
+function(cppadcg_add_model target)
+  cmake_parse_arguments(
+    ARG
+    ""
+    "MODEL_HEADER;MODEL_CLASS;MODEL_NAME;ORDER;SCALAR"
+    "INCLUDE_DIRECTORIES;COMPILE_OPTIONS"
+    ${ARGN}
+  )
+  foreach(arg MODEL_HEADER MODEL_CLASS MODEL_NAME)
+    if(NOT ARG_${arg})
+      message(FATAL_ERROR "cppadcg_add_model: ${arg} is required")
+    endif()
+  endforeach()
+  if(NOT ARG_ORDER)
+    set(ARG_ORDER Second)
+  endif()
+  if(NOT ARG_SCALAR)
+    set(ARG_SCALAR double)
+  endif()
+  if(NOT ARG_COMPILE_OPTIONS)
+    # same as the defaults of ADModel::compile
+    set(ARG_COMPILE_OPTIONS -O3 -march=native -mtune=native -ffast-math)
+  endif()
+
+  # kernels generated for each derivative order
+  if(ARG_ORDER STREQUAL "Zero")
+    set(kernels forward_zero)
+  elseif(ARG_ORDER STREQUAL "First")
+    set(kernels forward_zero jacobian)
+  elseif(ARG_ORDER STREQUAL "Second")
+    set(kernels forward_zero jacobian hessian)
+  else()
+    message(FATAL_ERROR "cppadcg_add_model: ORDER must be Zero, First, or Second")
+  endif()
+
+  get_filename_component(MODEL_HEADER ${ARG_MODEL_HEADER} ABSOLUTE)
+  set(MODEL_CLASS ${ARG_MODEL_CLASS})
+  set(MODEL_NAME ${ARG_MODEL_NAME})
+  set(ORDER ${ARG_ORDER})
+  set(SCALAR ${ARG_SCALAR})
+
+  set(gen_dir ${CMAKE_CURRENT_BINARY_DIR}/${target})
+  set(source_dir ${gen_dir}/src)
+  set(include_dir ${gen_dir}/include)
+  set(include_dirs ${CPPADCG_EIGENPY_INCLUDE_DIR} ${ARG_INCLUDE_DIRECTORIES})
+  file(REMOVE_RECURSE ${source_dir})
+  file(MAKE_DIRECTORY ${source_dir} ${include_dir})
+
+  # build and run a program which generates the model sources
+  configure_file(
+    ${CPPADCG_EIGENPY_CMAKE_DIR}/ModelSourceGenerator.cpp.in
+    ${gen_dir}/generator.cpp
+    @ONLY
+  )
+  message(STATUS "Generating sources for model ${MODEL_NAME}")
+  try_run(
+    run_result compile_result
+    ${gen_dir}/generator ${gen_dir}/generator.cpp
+    CMAKE_FLAGS "-DINCLUDE_DIRECTORIES=${include_dirs}"
+    LINK_LIBRARIES ${CMAKE_DL_LIBS}
+    CXX_STANDARD 11
+    COMPILE_OUTPUT_VARIABLE compile_output
+    RUN_OUTPUT_VARIABLE run_output
+    ARGS ${source_dir}
+  )
+  if(NOT compile_result)
+    message(FATAL_ERROR "Failed to build source generator for model ${MODEL_NAME}:\n${compile_output}")
+  endif()
+  if(NOT run_result EQUAL 0)
+    message(FATAL_ERROR "Failed to generate sources for model ${MODEL_NAME}:\n${run_output}")
+  endif()
+  set_property(DIRECTORY APPEND PROPERTY CMAKE_CONFIGURE_DEPENDS ${MODEL_HEADER})
+
+  # generate the header declaring the kernels
+  set(KERNEL_DECLARATIONS "")
+  set(KERNEL_DEFINITIONS "")
+  foreach(kernel IN LISTS kernels)
+    string(APPEND KERNEL_DECLARATIONS
+      "void cppad_cg_${MODEL_NAME}_${kernel}(\n"
+      "    ${SCALAR} const* const* in, ${SCALAR}* const* out,\n"
+      "    CppAD::cg::LangCAtomicFun atomic_fun);\n"
+    )
+    string(APPEND KERNEL_DEFINITIONS
+      "\n"
+      "    static void ${kernel}(const Scalar* const* in, Scalar* const* out) {\n"
+      "        cppad_cg_${MODEL_NAME}_${kernel}(\n"
+      "            in, out, CppAD::cg::LangCAtomicFun());\n"
+      "    }\n"
+    )
+  endforeach()
+  configure_file(
+    ${CPPADCG_EIGENPY_CMAKE_DIR}/ModelKernels.h.in
+    ${include_dir}/${MODEL_NAME}.h
+    @ONLY
+  )
+
+  file(GLOB sources ${source_dir}/*.c)
+  add_library(${target} STATIC ${sources})
+  target_compile_options(${target} PRIVATE ${ARG_COMPILE_OPTIONS})
+  target_include_directories(${target} PUBLIC ${include_dir} ${include_dirs})
+  if(CPPADCG_EIGENPY_IPO_SUPPORTED)
+    set_property(TARGET ${target} PROPERTY INTERPROCEDURAL_OPTIMIZATION TRUE)
+  endif()
+endfunction()
@@ -30,6 +30,16 @@ struct DynamicsModel : public ad::ADModel<Scalar> {
         return p;
     }
 
+    // Name the state and system input parts of the input, so that the
+    // Jacobian blocks w.r.t. each can be computed separately
+    std::vector<ad::Segment> input_segments() const override {
+        return {{"state", 0, STATE_DIM}, {"input", STATE_DIM, INPUT_DIM}};
+    }
+
+    std::vector<ad::Segment> output_segments() const override {
+        return {{"acceleration", 0, 6}};
+    }
+
     ADScalar get_mass(const ADVector& parameters) const {
         return parameters(0);
     }
@@ -42,43 +42,51 @@ struct RigidBody {
         StateVec<Scalar> x = x0;
         std::vector<StateVec<Scalar>> xs;
         for (InputVec<Scalar> u : us) {
-            Vec6<Scalar> A = forward_dynamics(x, u);
-
-            // Integrate linear portion of state
-            Vec3<Scalar> r0 = position(x);
-            Vec3<Scalar> v0 = linear_velocity(x);
-            Vec3<Scalar> a = A.head(3);
-
-            Vec3<Scalar> r1 = r0 + dt * v0 + 0.5 * dt * dt * a;
-            Vec3<Scalar> v1 = v0 + dt * a;
-
-            // Integrate rotation portion
-            Eigen::Quaternion<Scalar> q0 = orientation(x);
-            Vec3<Scalar> omega0 = angular_velocity(x);
-            Vec3<Scalar> alpha = A.tail(3);
-            Vec3<Scalar> omega1 = omega0 + dt * alpha;
-
-            // First term of the Magnus expansion
-            Vec3<Scalar> aa_vec = 0.5 * dt * (omega0 + omega1);
-
-            // Map to a quaternion via exponential map (note this
-            // implementation is not robust against numerical problems as angle
-            // -> 0)
-            Scalar angle = aa_vec.norm();
-            Vec3<Scalar> axis = aa_vec / angle;
-            Scalar c = cos(0.5 * angle);
-            Scalar s = sin(0.5 * angle);
-
-            Eigen::Quaternion<Scalar> qw;
-            qw.coeffs() << s * axis, c;
-            Eigen::Quaternion<Scalar> q1 = qw * q0;
-
-            x << r1, q1.coeffs(), v1, omega1;
+            x = integrate(x, forward_dynamics(x, u), dt);
             xs.push_back(x);
         }
         return xs;
     }
 
+    // Integrate the state over a time step of dt seconds, given the
+    // acceleration A computed by forward_dynamics. The orientation is
+    // integrated on the unit quaternions, so it stays normalized.
+    static StateVec<Scalar> integrate(const StateVec<Scalar>& x,
+                                      const Vec6<Scalar>& A, const Scalar dt) {
+        // Integrate linear portion of state
+        Vec3<Scalar> r0 = position(x);
+        Vec3<Scalar> v0 = linear_velocity(x);
+        Vec3<Scalar> a = A.head(3);
+
+        Vec3<Scalar> r1 = r0 + dt * v0 + 0.5 * dt * dt * a;
+        Vec3<Scalar> v1 = v0 + dt * a;
+
+        // Integrate rotation portion
+        Eigen::Quaternion<Scalar> q0 = orientation(x);
+        Vec3<Scalar> omega0 = angular_velocity(x);
+        Vec3<Scalar> alpha = A.tail(3);
+        Vec3<Scalar> omega1 = omega0 + dt * alpha;
+
+        // First term of the Magnus expansion
+        Vec3<Scalar> aa_vec = 0.5 * dt * (omega0 + omega1);
+
+        // Map to a quaternion via exponential map (note this
+        // implementation is not robust against numerical problems as angle
+        // -> 0)
+        Scalar angle = aa_vec.norm();
+        Vec3<Scalar> axis = aa_vec / angle;
+        Scalar c = cos(0.5 * angle);
+        Scalar s = sin(0.5 * angle);
+
+        Eigen::Quaternion<Scalar> qw;
+        qw.coeffs() << s * axis, c;
+        Eigen::Quaternion<Scalar> q1 = qw * q0;
+
+        StateVec<Scalar> x1;
+        x1 << r1, q1.coeffs(), v1, omega1;
+        return x1;
+    }
+
     static StateVec<Scalar> zero_state() {
         StateVec<Scalar> x = StateVec<Scalar>::Zero();
         x(6) = 1;  // w of quaternion
@@ -44,6 +44,17 @@ struct RolloutCostModel : public ad::ADModel<Scalar> {
         return p;
     }
 
+    // Name the initial state and wrench parts of the input, so that the
+    // gradient w.r.t. each can be computed separately
+    std::vector<ad::Segment> input_segments() const override {
+        return {{"initial_state", 0, STATE_DIM},
+                {"wrenches", STATE_DIM, NUM_INPUT}};
+    }
+
+    std::vector<ad::Segment> output_segments() const override {
+        return {{"cost", 0, 1}};
+    }
+
     static ADScalar get_mass(const ADVector& parameters) {
         return parameters(0);
     }
@@ -45,9 +45,9 @@ class CppDynamicsModelWrapper:
     def jacobians(self, x, u):
         """Compute derivatives of forward dynamics w.r.t. state x and force input u."""
         inp = np.concatenate((x, u))
-        J = self._model.jacobian(inp, self._params())
-        dfdx = J[:, :STATE_DIM]
-        dfdu = J[:, STATE_DIM:]
+        params = self._params()
+        dfdx = self._model.jacobian_block("acceleration", "state", inp, params)
+        dfdu = self._model.jacobian_block("acceleration", "input", inp, params)
         return dfdx, dfdu
 
 
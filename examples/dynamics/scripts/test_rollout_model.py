@@ -52,9 +52,10 @@ class CppRolloutCostModelWrapper:
 
     def jacobians(self, x0, us, xds):
         """Compute derivatives of forward dynamics w.r.t. state x and force input u."""
-        J = self._model.jacobian(self._input(x0, us), self._params(xds))
-        dfdx0 = J[:, :STATE_DIM]
-        dfdus = J[:, STATE_DIM:]
+        inp = self._input(x0, us)
+        params = self._params(xds)
+        dfdx0 = self._model.jacobian_block("cost", "initial_state", inp, params)
+        dfdus = self._model.jacobian_block("cost", "wrenches", inp, params)
         return dfdx0, dfdus
 
 
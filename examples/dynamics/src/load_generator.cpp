@@ -0,0 +1,175 @@
+// Load generator comparing a shared EvaluationServer against evaluating the
+// model in each client process.
+//
+// Usage: load_generator <directory> [num_clients] [num_requests]
+//                       [pipeline_depth] [num_server_threads]
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <CppADCodeGenEigenPy/CompiledModel.h>
+#include <CppADCodeGenEigenPy/EvaluationClient.h>
+#include <CppADCodeGenEigenPy/EvaluationServer.h>
+#include <Eigen/Eigen>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ad = CppADCodeGenEigenPy;
+
+using Clock = std::chrono::steady_clock;
+using Vector = ad::CompiledModel<double>::Vector;
+
+const std::string MODEL_NAME = "DynamicsModel";
+const std::string SERVER_NAME = "load_generator";
+
+// Memory shared with the client processes: a flag to start them all at once,
+// followed by the latency of each request in microseconds.
+struct SharedResults {
+    std::atomic<int> start;
+    double latencies[1];
+};
+
+struct Summary {
+    double throughput;  // requests per second, over all clients
+    double p50_us;
+    double p99_us;
+};
+
+double elapsed_us(Clock::time_point start, Clock::time_point end) {
+    return std::chrono::duration<double, std::micro>(end - start).count();
+}
+
+// Run the given client function in each of num_clients processes, starting
+// them at the same time, and summarize the latencies they record. The
+// function start_server is called after forking, so that the clients are not
+// forked from a process with running server threads.
+template <typename ClientFn, typename StartFn>
+Summary run_clients(size_t num_clients, size_t num_requests,
+                    ClientFn client_fn, StartFn start_server) {
+    const size_t num_latencies = num_clients * num_requests;
+    const size_t size = sizeof(SharedResults) + num_latencies * sizeof(double);
+    void* region = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    SharedResults* results = new (region) SharedResults();
+
+    for (size_t i = 0; i < num_clients; ++i) {
+        if (fork() == 0) {
+            while (!results->start.load()) {
+                usleep(100);
+            }
+            client_fn(i, results->latencies + i * num_requests);
+            _exit(0);
+        }
+    }
+
+    start_server();
+    auto start = Clock::now();
+    results->start.store(1);
+    for (size_t i = 0; i < num_clients; ++i) {
+        wait(nullptr);
+    }
+    auto end = Clock::now();
+
+    std::vector<double> latencies(results->latencies,
+                                  results->latencies + num_latencies);
+    munmap(region, size);
+
+    std::sort(latencies.begin(), latencies.end());
+    Summary summary;
+    summary.throughput = num_latencies / (elapsed_us(start, end) * 1e-6);
+    summary.p50_us = latencies[num_latencies / 2];
+    summary.p99_us = latencies[num_latencies * 99 / 100];
+    return summary;
+}
+
+void print_summary(const std::string& name, const Summary& summary) {
+    std::printf("%-12s %14.0f %10.2f %10.2f\n", name.c_str(),
+                summary.throughput, summary.p50_us, summary.p99_us);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: load_generator <directory> [num_clients] "
+                     "[num_requests] [pipeline_depth] [num_server_threads]"
+                  << std::endl;
+        return 1;
+    }
+    const std::string lib_path = std::string(argv[1]) + "/lib" + MODEL_NAME;
+    const size_t num_clients = argc > 2 ? std::stoul(argv[2]) : 8;
+    const size_t num_requests = argc > 3 ? std::stoul(argv[3]) : 20000;
+    const size_t depth = argc > 4 ? std::stoul(argv[4]) : 1;
+    const size_t num_server_threads = argc > 5 ? std::stoul(argv[5]) : 1;
+
+    // Only needed for the dimensions; clients load their own copies
+    const size_t input_size =
+        ad::CompiledModel<double>(MODEL_NAME, lib_path).get_input_size();
+    const Vector input = Vector::Ones(input_size);
+
+    std::printf("%zu clients, %zu requests each, pipeline depth %zu\n\n",
+                num_clients, num_requests, depth);
+    std::printf("%-12s %14s %10s %10s\n", "mode", "requests/s", "p50 (us)",
+                "p99 (us)");
+
+    // Each client loads the library and evaluates the model itself
+    Summary in_process = run_clients(
+        num_clients, num_requests,
+        [&](size_t, double* latencies) {
+            ad::CompiledModel<double> model(MODEL_NAME, lib_path);
+            for (size_t i = 0; i < num_requests; ++i) {
+                auto start = Clock::now();
+                model.evaluate(input);
+                latencies[i] = elapsed_us(start, Clock::now());
+            }
+        },
+        [] {});
+    print_summary("in-process", in_process);
+
+    // Each client submits its requests to the server, keeping up to depth
+    // requests in flight. Latency is measured from submission to collection.
+    std::unique_ptr<ad::EvaluationServer<double>> server;
+    ad::ServerOptions options;
+    options.num_threads = num_server_threads;
+    options.ring_capacity = std::max<size_t>(depth, 1);
+    Summary served = run_clients(
+        num_clients, num_requests,
+        [&](size_t, double* latencies) {
+            ad::EvaluationClient<double> client(SERVER_NAME, 10.0);
+            std::deque<std::pair<uint64_t, Clock::time_point>> in_flight;
+            size_t num_done = 0;
+            for (size_t i = 0; i < num_requests; ++i) {
+                if (in_flight.size() == depth) {
+                    client.collect(in_flight.front().first);
+                    latencies[num_done++] =
+                        elapsed_us(in_flight.front().second, Clock::now());
+                    in_flight.pop_front();
+                }
+                auto start = Clock::now();
+                in_flight.emplace_back(
+                    client.submit(0, ad::Kernel::Evaluate, input), start);
+            }
+            while (!in_flight.empty()) {
+                client.collect(in_flight.front().first);
+                latencies[num_done++] =
+                    elapsed_us(in_flight.front().second, Clock::now());
+                in_flight.pop_front();
+            }
+        },
+        [&] {
+            std::vector<ad::CompiledModel<double>> models{
+                ad::CompiledModel<double>(MODEL_NAME, lib_path)};
+            server.reset(
+                new ad::EvaluationServer<double>(SERVER_NAME, models, options));
+        });
+    print_summary("server", served);
+    std::printf("\nmean server batch size: %.2f\n",
+                static_cast<double>(server->get_num_requests()) /
+                    server->get_num_batches());
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <iostream>
+
+// This has to be included before other CppAD-related headers. It defines some
+// things required for auto-diff types to work with Pinocchio.
+#include <pinocchio/codegen/cppadcg.hpp>
+
+#include <CppADCodeGenEigenPy/ADModel.h>
+#include <Eigen/Eigen>
+
+#include <pinocchio/algorithm/aba.hpp>
+#include <pinocchio/algorithm/joint-configuration.hpp>
+
+namespace ad = CppADCodeGenEigenPy;
+
+template <typename Scalar>
+struct ForwardDynamicsModel : public ad::ADModel<Scalar> {
+    using typename ad::ADModel<Scalar>::ADScalar;
+    using typename ad::ADModel<Scalar>::ADVector;
+
+    // Template Pinocchio types for auto-diff.
+    using Model =
+        pinocchio::ModelTpl<ADScalar, 0, pinocchio::JointCollectionDefaultTpl>;
+    using Data =
+        pinocchio::DataTpl<ADScalar, 0, pinocchio::JointCollectionDefaultTpl>;
+
+    ForwardDynamicsModel(const pinocchio::Model& model)
+        : model_(model.template cast<ADScalar>()),
+          ad::ADModel<Scalar>() {
+    }
+
+    // Generate the input used when differentiating the function
+    ADVector input() const override {
+        ADVector input(model_.nq + 2 * model_.nv);
+        input << pinocchio::neutral(model_), ADVector::Zero(2 * model_.nv);
+        return input;
+    }
+
+    /**
+     * Forward dynamics: compute the acceleration resulting from applied
+     * torques given position and velocity, using the articulated body
+     * algorithm (ABA).
+     */
+    ADVector function(const ADVector& input) const override {
+        Data data(model_);
+
+        ADVector q = input.head(model_.nq);
+        ADVector v = input.segment(model_.nq, model_.nv);
+        ADVector tau = input.tail(model_.nv);
+
+        return pinocchio::aba(model_, data, q, v, tau);
+    }
+
+    Model model_;
+};
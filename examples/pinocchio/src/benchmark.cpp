@@ -0,0 +1,187 @@
+#include <pinocchio/algorithm/aba-derivatives.hpp>
+#include <pinocchio/algorithm/aba.hpp>
+#include <pinocchio/algorithm/joint-configuration.hpp>
+#include <pinocchio/algorithm/rnea-derivatives.hpp>
+#include <pinocchio/algorithm/rnea.hpp>
+#include <pinocchio/parsers/urdf.hpp>
+
+#include <CppADCodeGenEigenPy/CompiledModel.h>
+#include <Eigen/Eigen>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace ad = CppADCodeGenEigenPy;
+
+using Vector = ad::CompiledModel<double>::Vector;
+using Matrix = ad::CompiledModel<double>::Matrix;
+
+struct Timing {
+    double latency_us;  // median latency of a single call
+    double throughput;  // calls per second, back to back
+};
+
+// Results are accumulated here so that the calls are not optimized away.
+volatile double sink = 0;
+
+// Time a function of the sample index over all samples. The latency is timed
+// per call, while the throughput is timed over repeated passes through all of
+// the samples.
+template <typename F>
+Timing benchmark(F f, size_t num_samples, size_t num_passes) {
+    using Clock = std::chrono::steady_clock;
+
+    // warm up the caches
+    for (size_t i = 0; i < num_samples; ++i) {
+        sink = sink + f(i);
+    }
+
+    std::vector<double> latencies(num_samples);
+    for (size_t i = 0; i < num_samples; ++i) {
+        auto start = Clock::now();
+        sink = sink + f(i);
+        auto end = Clock::now();
+        latencies[i] =
+            std::chrono::duration<double, std::micro>(end - start).count();
+    }
+    std::nth_element(latencies.begin(),
+                     latencies.begin() + num_samples / 2, latencies.end());
+
+    auto start = Clock::now();
+    for (size_t pass = 0; pass < num_passes; ++pass) {
+        for (size_t i = 0; i < num_samples; ++i) {
+            sink = sink + f(i);
+        }
+    }
+    auto end = Clock::now();
+    double seconds = std::chrono::duration<double>(end - start).count();
+
+    return {latencies[num_samples / 2], num_passes * num_samples / seconds};
+}
+
+void print_timing(const std::string& name, const Timing& timing) {
+    std::printf("  %-36s %10.3f us %14.0f calls/s\n", name.c_str(),
+                timing.latency_us, timing.throughput);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "Usage: benchmark <directory> <urdf_path> [num_samples]"
+                  << std::endl;
+        return 1;
+    }
+    std::string lib_dir_path = argv[1];
+    std::string urdf_path = argv[2];
+    size_t num_samples = argc > 3 ? std::stoul(argv[3]) : 1000;
+    size_t num_passes = 10;
+
+    pinocchio::Model model;
+    pinocchio::urdf::buildModel(urdf_path, model);
+    pinocchio::Data data(model);
+
+    ad::CompiledModel<double> id_model(
+        "InverseDynamicsModel",
+        get_library_generic_path("InverseDynamicsModel", lib_dir_path));
+    ad::CompiledModel<double> fd_model(
+        "ForwardDynamicsModel",
+        get_library_generic_path("ForwardDynamicsModel", lib_dir_path));
+
+    // Random states. The compiled models take the whole state as a single
+    // input, which is assembled up front so that this is not timed.
+    std::vector<Vector> qs, vs, us, inputs;
+    for (size_t i = 0; i < num_samples; ++i) {
+        qs.push_back(pinocchio::randomConfiguration(model));
+        vs.push_back(Vector::Random(model.nv));
+        us.push_back(Vector::Random(model.nv));
+
+        Vector input(model.nq + 2 * model.nv);
+        input << qs.back(), vs.back(), us.back();
+        inputs.push_back(input);
+    }
+
+    // Check that both backends agree before timing them. The derivatives
+    // with respect to q differ for continuous joints, since the compiled
+    // models are differentiated with respect to their (cos, sin)
+    // parameterization, so the velocity derivatives are compared instead.
+    double value_error = 0;
+    double derivative_error = 0;
+    for (size_t i = 0; i < num_samples; ++i) {
+        pinocchio::rnea(model, data, qs[i], vs[i], us[i]);
+        value_error = std::max(
+            value_error,
+            (id_model.evaluate(inputs[i]) - data.tau)
+                .lpNorm<Eigen::Infinity>());
+        pinocchio::computeRNEADerivatives(model, data, qs[i], vs[i], us[i]);
+        Matrix J = id_model.jacobian(inputs[i]);
+        derivative_error = std::max(
+            derivative_error,
+            (J.middleCols(model.nq, model.nv) - data.dtau_dv)
+                .lpNorm<Eigen::Infinity>());
+
+        pinocchio::aba(model, data, qs[i], vs[i], us[i]);
+        value_error = std::max(
+            value_error,
+            (fd_model.evaluate(inputs[i]) - data.ddq)
+                .lpNorm<Eigen::Infinity>());
+        pinocchio::computeABADerivatives(model, data, qs[i], vs[i], us[i]);
+        J = fd_model.jacobian(inputs[i]);
+        derivative_error = std::max(
+            derivative_error,
+            (J.middleCols(model.nq, model.nv) - data.ddq_dv)
+                .lpNorm<Eigen::Infinity>());
+    }
+
+    std::printf("%s: nq = %d, nv = %d, %zu samples\n", urdf_path.c_str(),
+                model.nq, model.nv, num_samples);
+    std::printf("  max value error = %g, max derivative error = %g\n",
+                value_error, derivative_error);
+
+    auto rnea = [&](size_t i) {
+        return pinocchio::rnea(model, data, qs[i], vs[i], us[i])(0);
+    };
+    auto rnea_derivatives = [&](size_t i) {
+        pinocchio::computeRNEADerivatives(model, data, qs[i], vs[i], us[i]);
+        return data.dtau_dq(0, 0);
+    };
+    auto aba = [&](size_t i) {
+        return pinocchio::aba(model, data, qs[i], vs[i], us[i])(0);
+    };
+    auto aba_derivatives = [&](size_t i) {
+        pinocchio::computeABADerivatives(model, data, qs[i], vs[i], us[i]);
+        return data.ddq_dq(0, 0);
+    };
+    auto id_evaluate = [&](size_t i) {
+        return id_model.evaluate(inputs[i])(0);
+    };
+    auto id_jacobian = [&](size_t i) {
+        return id_model.jacobian(inputs[i])(0, 0);
+    };
+    auto fd_evaluate = [&](size_t i) {
+        return fd_model.evaluate(inputs[i])(0);
+    };
+    auto fd_jacobian = [&](size_t i) {
+        return fd_model.jacobian(inputs[i])(0, 0);
+    };
+
+    std::printf("Inverse dynamics (RNEA)\n");
+    print_timing("pinocchio rnea", benchmark(rnea, num_samples, num_passes));
+    print_timing("compiled evaluate",
+                 benchmark(id_evaluate, num_samples, num_passes));
+    print_timing("pinocchio computeRNEADerivatives",
+                 benchmark(rnea_derivatives, num_samples, num_passes));
+    print_timing("compiled jacobian",
+                 benchmark(id_jacobian, num_samples, num_passes));
+
+    std::printf("Forward dynamics (ABA)\n");
+    print_timing("pinocchio aba", benchmark(aba, num_samples, num_passes));
+    print_timing("compiled evaluate",
+                 benchmark(fd_evaluate, num_samples, num_passes));
+    print_timing("pinocchio computeABADerivatives",
+                 benchmark(aba_derivatives, num_samples, num_passes));
+    print_timing("compiled jacobian",
+                 benchmark(fd_jacobian, num_samples, num_passes));
+}
@@ -1,5 +1,6 @@
 #include <pinocchio/parsers/urdf.hpp>
 
+#include "forward_dynamics_model.h"
 #include "inverse_dynamics_model.h"
 
 namespace ad = CppADCodeGenEigenPy;
@@ -17,4 +18,6 @@ int main(int argc, char **argv) {
     pinocchio::urdf::buildModel(urdf_path, model);
     InverseDynamicsModel<double>(model).compile(
         "InverseDynamicsModel", output_dir_path, ad::DerivativeOrder::First);
+    ForwardDynamicsModel<double>(model).compile(
+        "ForwardDynamicsModel", output_dir_path, ad::DerivativeOrder::First);
 }
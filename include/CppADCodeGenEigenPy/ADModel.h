@@ -1,9 +1,25 @@
 #pragma once
 
+#include <sys/stat.h>
+
 #include <Eigen/Eigen>
+#include <cctype>
+#include <chrono>
 #include <cppad/cg.hpp>
+#include <fstream>
+#include <future>
+#include <iomanip>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
 
+#include <CppADCodeGenEigenPy/AsyncModel.h>
+#include <CppADCodeGenEigenPy/CompileReport.h>
 #include <CppADCodeGenEigenPy/CompiledModel.h>
 #include <CppADCodeGenEigenPy/Util.h>
 
@@ -12,6 +28,145 @@ namespace CppADCodeGenEigenPy {
 /** Derivative order */
 enum class DerivativeOrder { Zero, First, Second };
 
+/** A named, contiguous segment of a model's input or output vector. */
+struct Segment {
+    /** Name of the segment. Must be a valid C identifier not containing a
+     *  double underscore and not beginning or ending with an underscore. */
+    std::string name;
+
+    /** Index of the first element of the segment. */
+    size_t start;
+
+    /** Number of elements in the segment. */
+    size_t size;
+};
+
+/** Multithreading in the generated code. */
+enum class Multithreading {
+    /** Single-threaded. */
+    None,
+
+    /** Parallelized with OpenMP. */
+    OpenMP,
+
+    /** Parallelized with a pool of POSIX threads. */
+    ThreadPool,
+};
+
+/** Compiler used to compile the generated code. */
+enum class Compiler { GCC, Clang };
+
+/** Auto-differentiation mode used to generate the Jacobian. */
+enum class JacobianMode {
+    /** Forward mode if the model has at least as many outputs as inputs
+     *  (including parameters), otherwise reverse mode. */
+    Automatic,
+
+    /** Forward mode, which propagates one input direction at a time. */
+    Forward,
+
+    /** Reverse mode, which propagates one output direction at a time. This
+     *  is best for models with few outputs, such as cost functions. */
+    Reverse,
+};
+
+/** Options for compiling a model. */
+struct CompileOptions {
+    /** Maximum derivative order to generate. */
+    DerivativeOrder order = DerivativeOrder::Second;
+
+    /** Print additional information. */
+    bool verbose = false;
+
+    /** Save the C files generated by CppADCodeGen. */
+    bool save_sources = false;
+
+    /** Flags to pass to the compiler to compile the library. */
+    std::vector<std::string> compile_flags = {"-O3", "-march=native",
+                                              "-mtune=native", "-ffast-math"};
+
+    /** Generate multithreaded code for the Jacobian and Hessian. The
+     *  derivatives are then computed one direction at a time, with the
+     *  directions distributed over threads. This only pays off for large
+     *  models. The number of threads is set at runtime with
+     *  CompiledModel::set_num_threads. */
+    Multithreading multithreading = Multithreading::None;
+
+    /** Auto-differentiation mode used to generate the Jacobian. */
+    JacobianMode jacobian_mode = JacobianMode::Automatic;
+
+    /** Generate only the lower triangle of the Hessian, which is symmetric.
+     *  This halves the code and memory traffic of the Hessian for large
+     *  second-order models. CompiledModel::hessian mirrors the triangle to
+     *  return the full matrix, while CompiledModel::hessian_packed returns
+     *  the triangle without expanding it. */
+    bool symmetric_hessian = false;
+
+    /** Generate kernels for the derivatives with respect to the parameters:
+     *  the Jacobian with respect to the parameters if the order is at least
+     *  one, and the mixed second derivatives with respect to the input and
+     *  parameters if it is two. These are available from
+     *  CompiledModel::parameter_jacobian and CompiledModel::mixed_hessian,
+     *  and compute only the required elements rather than the full
+     *  derivatives with respect to both. */
+    bool parameter_derivatives = false;
+
+    /** Compiler used to compile the generated code. */
+    Compiler compiler = Compiler::GCC;
+
+    /** Path to the compiler executable. If empty, the default path for the
+     *  chosen compiler is used. */
+    std::string compiler_path;
+};
+
+/** A compiler and set of flags to try when autotuning. */
+struct CompilerConfiguration {
+    Compiler compiler;
+    std::vector<std::string> compile_flags;
+};
+
+/** Get the compiler configurations tried by default when autotuning. The
+ *  first, a conservative configuration, is the reference against which the
+ *  results of the others are checked.
+ *
+ * @returns The default configurations.
+ */
+inline std::vector<CompilerConfiguration> default_compiler_configurations() {
+    return {
+        {Compiler::GCC, {"-O2"}},
+        {Compiler::GCC, {"-O3", "-march=native", "-mtune=native"}},
+        {Compiler::GCC,
+         {"-O3", "-march=native", "-mtune=native", "-ffast-math"}},
+        {Compiler::GCC,
+         {"-O2", "-march=native", "-mtune=native", "-ffast-math",
+          "-freorder-blocks-and-partition"}},
+        {Compiler::Clang, {"-O2"}},
+        {Compiler::Clang,
+         {"-O3", "-march=native", "-mtune=native", "-ffast-math"}},
+    };
+}
+
+/** Options for autotuning the compilation of a model. */
+struct AutotuneOptions {
+    /** Options for compiling each configuration. Their compiler and compile
+     *  flags are replaced by those of the configuration. */
+    CompileOptions compile_options;
+
+    /** Configurations to try. The first is the reference: it must compile
+     *  successfully, and configurations whose results differ from it are
+     *  rejected. */
+    std::vector<CompilerConfiguration> configurations =
+        default_compiler_configurations();
+
+    /** Number of times to run all of the sample inputs when timing each
+     *  configuration. */
+    size_t repetitions = 100;
+
+    /** Maximum difference from the reference results, relative to their
+     *  magnitude. */
+    double tolerance = 1e-6;
+};
+
 /** Abstract base class for a function to be auto-differentiated and then
  *  compiled.
  *
@@ -37,6 +192,13 @@ class ADModel {
     using ADMatrix = Eigen::Matrix<ADScalar, Eigen::Dynamic, Eigen::Dynamic,
                                    Eigen::RowMajor>;
 
+    /** Dynamic vector type of the compiled model. */
+    using Vector = typename CompiledModel<Scalar>::Vector;
+
+    /** A Jacobian block, identified by the names of its (output, input)
+     *  segments. */
+    using JacobianBlock = std::pair<std::string, std::string>;
+
     /** Constructor. */
     ADModel() {}
 
@@ -51,6 +213,13 @@ class ADModel {
      * @param[in] compile_flags  Flags to pass to the compiler to compile the
      *                           library.
      *
+     * If the order is at least first, a separate kernel is also generated
+     * for each of the `jacobian_blocks`, which only computes the elements of
+     * that block.
+     *
+     * @throws std::runtime_error if the segments or Jacobian blocks are
+     * invalid.
+     *
      * @returns The compiled model.
      */
     CompiledModel<Scalar> compile(
@@ -60,6 +229,158 @@ class ADModel {
         std::vector<std::string> compile_flags = {
             "-O3", "-march=native", "-mtune=native", "-ffast-math"}) const;
 
+    /** Compile the library into a dynamic library.
+     *
+     * @param[in] model_name     Name of the compiled model.
+     * @param[in] directory_path Path of directory where model library should
+     *                           go. The directory must exist; it will not be
+     *                           created automatically.
+     * @param[in] options        Compilation options.
+     *
+     * @throws std::runtime_error if the segments or Jacobian blocks are
+     * invalid.
+     *
+     * @returns The compiled model.
+     */
+    CompiledModel<Scalar> compile(const std::string& model_name,
+                                  const std::string& directory_path,
+                                  const CompileOptions& options) const;
+
+    /** Compile the function alone first, and its derivatives later.
+     *
+     * The function is recorded once. A library containing only the function
+     * is compiled and returned right away, so that it can be evaluated
+     * without waiting for the derivatives, which take much longer to compile
+     * for large models. A second library with all kernels up to the
+     * requested order is compiled from the same recording, either on a
+     * background thread or on the first call that needs a derivative. Calls
+     * for derivatives wait for it to be compiled and are served by it, until
+     * CompiledModel::wait_for_derivatives switches the model to it. Copying
+     * or destroying the model also waits for it.
+     *
+     * The sources of both libraries are generated from the tape on the
+     * calling thread, since CppAD is not thread-safe, so that only the C
+     * compiler runs in the background.
+     *
+     * @param[in] model_name     Name of the compiled model.
+     * @param[in] directory_path Path of directory where model libraries
+     *                           should go. The directory must exist; it will
+     *                           not be created automatically. The derivative
+     *                           library is named lib<model_name>__derivatives.
+     * @param[in] options        Compilation options. These apply to both
+     *                           libraries, except that the function library
+     *                           is zero-order and single-threaded.
+     * @param[in] background     Compile the derivatives on a background
+     *                           thread right away. Otherwise, they are
+     *                           compiled on the thread of the first call
+     *                           that needs them.
+     *
+     * @throws std::runtime_error if the segments or Jacobian blocks are
+     * invalid. Errors compiling the derivatives are thrown by the calls that
+     * wait for them.
+     *
+     * @returns The compiled model.
+     */
+    CompiledModel<Scalar> compile_lazy(
+        const std::string& model_name, const std::string& directory_path,
+        const CompileOptions& options = CompileOptions(),
+        bool background = true) const;
+
+    /** Compile the library on a background thread, returning a handle that
+     *  can be used right away.
+     *
+     * The function is recorded and the sources are generated on the calling
+     * thread, since CppAD is not thread-safe, leaving only the compiler and
+     * loading the library to the background. Until the library is loaded,
+     * the handle interprets the recorded tape. See AsyncModel.
+     *
+     * @param[in] model_name     Name of the compiled model.
+     * @param[in] directory_path Path of directory where model library should
+     *                           go. The directory must exist; it will not be
+     *                           created automatically.
+     * @param[in] options        Compilation options.
+     *
+     * @throws std::runtime_error if the segments or Jacobian blocks are
+     * invalid. Errors compiling the library are thrown by AsyncModel::wait.
+     *
+     * @returns The handle to the model.
+     */
+    std::unique_ptr<AsyncModel<Scalar>> compile_async(
+        const std::string& model_name, const std::string& directory_path,
+        const CompileOptions& options = CompileOptions()) const;
+
+    /** Compile the library into a dynamic library using profile-guided
+     *  optimization.
+     *
+     * The library is first compiled with instrumentation and the profile
+     * inputs are run through it, computing all derivatives up to the
+     * compiled order. The library is then recompiled, optimized using the
+     * recorded profile. This requires the GCC compiler.
+     *
+     * @param[in] model_name      Name of the compiled model.
+     * @param[in] directory_path  Path of directory where model library
+     *                            should go. The directory must exist; it
+     *                            will not be created automatically.
+     * @param[in] profile_inputs  Representative inputs, each including the
+     *                            parameters (if any).
+     * @param[in] options         Compilation options.
+     *
+     * @throws std::runtime_error if the segments or Jacobian blocks are
+     * invalid, if the size of a profile input does not match the model, or
+     * if the compiler is not GCC.
+     *
+     * @returns The optimized compiled model.
+     */
+    CompiledModel<Scalar> compile_with_profile(
+        const std::string& model_name, const std::string& directory_path,
+        const std::vector<Vector>& profile_inputs,
+        const CompileOptions& options = CompileOptions()) const;
+
+    /** Compile the library into a dynamic library, choosing the compiler
+     *  and flags by benchmarking.
+     *
+     * The library is compiled with each of the candidate configurations,
+     * and each is timed evaluating the function and all derivatives up to
+     * the compiled order at the sample inputs. The fastest configuration
+     * whose results match the reference configuration is kept. A report of
+     * the timings and the chosen configuration is written next to the
+     * library, to `lib<model_name>.autotune.txt`.
+     *
+     * @param[in] model_name      Name of the compiled model.
+     * @param[in] directory_path  Path of directory where model library
+     *                            should go. The directory must exist; it
+     *                            will not be created automatically.
+     * @param[in] sample_inputs   Representative inputs, each including the
+     *                            parameters (if any).
+     * @param[in] options         Autotuning options.
+     *
+     * @throws std::runtime_error if the reference configuration fails to
+     * compile or the size of a sample input does not match the model.
+     *
+     * @returns The compiled model using the fastest configuration.
+     */
+    CompiledModel<Scalar> autotune(
+        const std::string& model_name, const std::string& directory_path,
+        const std::vector<Vector>& sample_inputs,
+        const AutotuneOptions& options = AutotuneOptions()) const;
+
+    /** Generate the C sources of the model without compiling them, so that
+     *  they can be built as part of another project. This is used by the
+     *  `cppadcg_add_model` CMake function to link models statically.
+     *
+     * @param[in] model_name     Name of the model.
+     * @param[in] directory_path Path of directory where the sources should
+     *                           go. The directory must exist; it will not be
+     *                           created automatically.
+     * @param[in] order          Maximum derivative order to generate.
+     *
+     * @throws std::runtime_error if the segments or Jacobian blocks are
+     * invalid, or if a source file cannot be written.
+     */
+    void generate_sources(
+        const std::string& model_name, const std::string& directory_path,
+        DerivativeOrder order = DerivativeOrder::Second) const;
+
    protected:
     /** Defines this model's (parameterless) function.
      *
@@ -107,6 +428,95 @@ class ADModel {
      * @returns The parameter vector to use for auto-differentiation
      */
     virtual ADVector parameters() const;
+
+    /** Defines named segments of the input vector, which can be used to
+     *  request Jacobian blocks. Segments must lie within the input (they
+     *  cannot include parameters) but need not cover all of it. Need only be
+     *  overridden by the derived class if Jacobian blocks are desired.
+     *
+     * @returns The input segments.
+     */
+    virtual std::vector<Segment> input_segments() const;
+
+    /** Defines named segments of the output vector, which can be used to
+     *  request Jacobian blocks. Need only be overridden by the derived class
+     *  if Jacobian blocks are desired.
+     *
+     * @returns The output segments.
+     */
+    virtual std::vector<Segment> output_segments() const;
+
+    /** Defines the Jacobian blocks for which dedicated kernels should be
+     *  generated, as (output segment, input segment) name pairs. By default,
+     *  a kernel is generated for every pair of output and input segments.
+     *
+     * @returns The Jacobian blocks to generate.
+     */
+    virtual std::vector<JacobianBlock> jacobian_blocks() const;
+
+   private:
+    // Everything required to generate the sources of a model library. The
+    // source generators refer to the recorded function, so they are kept
+    // together with it.
+    struct LibrarySourceGen {
+        CppAD::ADFun<ADScalarBase> ad_func;
+        std::vector<std::unique_ptr<CppAD::cg::ModelCSourceGen<Scalar>>>
+            model_source_gens;
+        std::unique_ptr<CppAD::cg::ModelLibraryCSourceGen<Scalar>>
+            lib_source_gen;
+
+        // Size of the input, excluding the parameters
+        size_t input_size = 0;
+
+        // Filled in with the phases of compilation as they happen
+        CompileReport report;
+    };
+
+    // Compile the library, passing extra flags to the compiler in addition
+    // to those in the options
+    CompiledModel<Scalar> compile_library(
+        const std::string& model_name, const std::string& directory_path,
+        const CompileOptions& options,
+        const std::vector<std::string>& extra_flags) const;
+
+    // Generate and compile the sources of a model library, then load it.
+    // This does not use the model itself, so it can run after the model is
+    // gone.
+    static CompiledModel<Scalar> compile_sources(
+        LibrarySourceGen& sources, const std::string& model_name,
+        const std::string& lib_generic_path, const CompileOptions& options,
+        const std::vector<std::string>& extra_flags);
+
+    // Record the function and set up the source generators for the model
+    // library
+    std::unique_ptr<LibrarySourceGen> create_library_source_gen(
+        const std::string& model_name, DerivativeOrder order,
+        Multithreading multithreading = Multithreading::None,
+        JacobianMode jacobian_mode = JacobianMode::Automatic,
+        bool symmetric_hessian = false,
+        bool parameter_derivatives = false) const;
+
+    // Record the function, filling in the tape and its part of the report.
+    void record_function(LibrarySourceGen& sources,
+                         const std::string& model_name) const;
+
+    // Set up the source generators for the kernels of the given order.
+    void add_source_gens(LibrarySourceGen& sources,
+                         const std::string& model_name, DerivativeOrder order,
+                         Multithreading multithreading,
+                         JacobianMode jacobian_mode,
+                         bool symmetric_hessian,
+                         bool parameter_derivatives) const;
+
+    // Check that segments are valid, have distinct names and lie within a
+    // vector of the given size
+    static void check_segments(const std::vector<Segment>& segments,
+                               size_t size, const std::string& kind);
+
+    // Find the segment with the given name
+    static const Segment& find_segment(const std::vector<Segment>& segments,
+                                       const std::string& name,
+                                       const std::string& kind);
 };  // class ADModel
 
 #include "impl/ADModel.tpp"
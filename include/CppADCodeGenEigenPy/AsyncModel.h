@@ -0,0 +1,149 @@
+#pragma once
+
+#include <Eigen/Eigen>
+#include <atomic>
+#include <cppad/cg.hpp>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <CppADCodeGenEigenPy/CompiledModel.h>
+
+namespace CppADCodeGenEigenPy {
+
+template <typename Scalar>
+class ADModel;
+
+/** A handle to a model whose library is still being compiled, returned by
+ *  ADModel::compile_async.
+ *
+ * Until the library is loaded, calls are served by interpreting the recorded
+ * CppAD tape, which is much slower than the generated code but available as
+ * soon as the function is recorded. The library is compiled on a background
+ * thread and swapped in atomically between calls once loaded, after which
+ * calls are forwarded to it.
+ *
+ * The fallback provides the same derivatives as the compiled model will, so
+ * callers do not need to know which one served a call. If compilation fails,
+ * the fallback remains in use and wait() throws the error.
+ *
+ * As with CompiledModel, the methods may only be called from one thread at a
+ * time. Since CppAD is not thread-safe, no other models should be recorded or
+ * evaluated with CppAD while the fallback is in use.
+ *
+ * @tparam Scalar  The scalar type to use. Typically float or double.
+ */
+template <typename Scalar>
+class AsyncModel {
+   public:
+    using Vector = typename CompiledModel<Scalar>::Vector;
+    using Matrix = typename CompiledModel<Scalar>::Matrix;
+
+    /** Destructor. Waits for the compilation to finish. */
+    ~AsyncModel();
+
+    AsyncModel(const AsyncModel&) = delete;
+    AsyncModel& operator=(const AsyncModel&) = delete;
+
+    /** Check if the compiled library has been loaded and is serving calls.
+     *
+     * @returns True if the library is loaded, false if the tape is still in
+     *          use.
+     */
+    bool is_compiled() const;
+
+    /** Wait for the compilation to finish.
+     *
+     * @throws std::exception the error that compiling or loading the library
+     * failed with. The tape remains in use in this case.
+     */
+    void wait();
+
+    /** Get the compiled model.
+     *
+     * @returns The compiled model, or null if it has not been loaded yet.
+     */
+    std::shared_ptr<const CompiledModel<Scalar>> get_model() const;
+
+    /** Evaluate the function. See CompiledModel::evaluate. */
+    Vector evaluate(const Eigen::Ref<const Vector>& input) const;
+
+    /** Evaluate the function with parameters. See
+     *  CompiledModel::evaluate. */
+    Vector evaluate(const Eigen::Ref<const Vector>& input,
+                    const Eigen::Ref<const Vector>& parameters) const;
+
+    /** Compute the Jacobian. See CompiledModel::jacobian. */
+    Matrix jacobian(const Eigen::Ref<const Vector>& input) const;
+
+    /** Compute the Jacobian with parameters. See CompiledModel::jacobian. */
+    Matrix jacobian(const Eigen::Ref<const Vector>& input,
+                    const Eigen::Ref<const Vector>& parameters) const;
+
+    /** Compute a Hessian. See CompiledModel::hessian. */
+    Matrix hessian(const Eigen::Ref<const Vector>& input,
+                   size_t output_dim = 0) const;
+
+    /** Compute a Hessian with parameters. See CompiledModel::hessian. */
+    Matrix hessian(const Eigen::Ref<const Vector>& input,
+                   const Eigen::Ref<const Vector>& parameters,
+                   size_t output_dim = 0) const;
+
+    /** Get the input size of the model, including parameters. */
+    size_t get_input_size() const;
+
+    /** Get the output size of the model. */
+    size_t get_output_size() const;
+
+   private:
+    // Created by ADModel::compile_async
+    friend class ADModel<Scalar>;
+
+    using TapeScalar = CppAD::cg::CG<Scalar>;
+
+    // Start compiling on the background thread. The tape is copied, so it
+    // must not be in use elsewhere while this runs.
+    AsyncModel(const std::string& model_name,
+               const CppAD::ADFun<TapeScalar>& tape, bool jacobian_available,
+               bool hessian_available,
+               const std::function<CompiledModel<Scalar>()>& compile);
+
+    // Interpreted versions of the kernels, used until the library is loaded
+    Vector tape_evaluate(const Eigen::Ref<const Vector>& input) const;
+    Matrix tape_jacobian(const Eigen::Ref<const Vector>& input) const;
+    Matrix tape_hessian(const Eigen::Ref<const Vector>& input,
+                        size_t output_dim) const;
+
+    // Convert the input to constants for the tape, checking its size
+    std::vector<TapeScalar> tape_input(
+        const Eigen::Ref<const Vector>& input) const;
+
+    std::string model_name_;
+    size_t input_size_;
+    size_t output_size_;
+    bool jacobian_available_;
+    bool hessian_available_;
+
+    // Evaluating the tape updates its internal state
+    mutable CppAD::ADFun<TapeScalar> tape_;
+
+    // Only accessed atomically, since it is set while callers read it
+    std::shared_ptr<const CompiledModel<Scalar>> model_;
+
+    // Compiles and loads the library. It owns the generated sources, which
+    // hold CppAD objects, so it is kept until this is destroyed rather than
+    // being released on the background thread, where freeing them would
+    // race with the tape.
+    std::function<CompiledModel<Scalar>()> compile_;
+
+    std::thread compile_thread_;
+    std::exception_ptr error_;
+};
+
+#include "impl/AsyncModel.tpp"
+
+}  // namespace CppADCodeGenEigenPy
@@ -0,0 +1,190 @@
+#pragma once
+
+#include <Eigen/Eigen>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <CppADCodeGenEigenPy/CompiledModel.h>
+
+namespace CppADCodeGenEigenPy {
+
+/** Options for a BatchDispatcher. */
+struct DispatcherOptions {
+    /** Maximum number of requests evaluated in a single batch. A batch is
+     *  started as soon as this many requests are waiting. */
+    size_t max_batch_size = 64;
+
+    /** Maximum time a request waits for others to batch with, in seconds.
+     *  A batch is started when its oldest request has waited this long,
+     *  even if it is not full. With zero, requests are batched only with
+     *  those that arrived while the workers were busy. */
+    double max_wait_time = 50e-6;
+
+    /** Number of worker threads evaluating batches. */
+    size_t num_threads = 1;
+};
+
+/** Statistics of a BatchDispatcher, for tuning the batch size and wait
+ *  time. */
+struct DispatcherStatistics {
+    /** Number of requests completed. */
+    size_t num_requests = 0;
+
+    /** Number of batches evaluated. */
+    size_t num_batches = 0;
+
+    /** Mean number of requests per batch. */
+    double mean_batch_size = 0;
+
+    /** Number of requests in the largest batch. */
+    size_t max_batch_size = 0;
+
+    /** Mean time requests waited in the queue before their batch started,
+     *  in seconds. */
+    double mean_wait_time = 0;
+
+    /** Number of requests currently waiting in the queue. */
+    size_t queue_depth = 0;
+
+    /** Largest number of requests waiting in the queue at once. */
+    size_t max_queue_depth = 0;
+};
+
+/** Coalesces single-point requests from many threads into batches.
+ *
+ * Callers submit single inputs and get a future for the result, while the
+ * dispatcher's worker threads collect waiting requests into batches and
+ * evaluate them with CompiledModel::evaluate_batch and
+ * CompiledModel::jacobian_batch. This trades a bounded amount of latency
+ * (see DispatcherOptions::max_wait_time) for the throughput of batched
+ * evaluation.
+ *
+ * Unlike CompiledModel, the dispatcher may be used from multiple threads at
+ * once. Each worker thread uses its own copy of the model.
+ *
+ * @tparam Scalar  The scalar type to use. Typically float or double.
+ */
+template <typename Scalar>
+class BatchDispatcher {
+   public:
+    using Vector = typename CompiledModel<Scalar>::Vector;
+    using Matrix = typename CompiledModel<Scalar>::Matrix;
+
+    /** Constructor. Starts the worker threads.
+     *
+     * @param[in] model    The compiled model. It is copied for each worker.
+     * @param[in] options  Dispatcher options.
+     *
+     * @throws std::runtime_error if the batch size or number of threads is
+     * zero, or the wait time is negative.
+     */
+    BatchDispatcher(const CompiledModel<Scalar>& model,
+                    const DispatcherOptions& options = DispatcherOptions());
+
+    /** Destructor. Completes the waiting requests and stops the workers. */
+    ~BatchDispatcher();
+
+    BatchDispatcher(const BatchDispatcher&) = delete;
+    BatchDispatcher& operator=(const BatchDispatcher&) = delete;
+
+    /** Submit a request to evaluate the function.
+     *
+     * @param[in] input  The input, including the parameters if the function
+     *                   has any.
+     *
+     * @throws std::runtime_error if the input size does not match the model.
+     *
+     * @returns A future for the output. If evaluating the batch fails, the
+     *          future holds the exception.
+     */
+    std::future<Vector> evaluate(const Eigen::Ref<const Vector>& input);
+
+    /** Submit a request to compute the function's Jacobian.
+     *
+     * @param[in] input  The input, including the parameters if the function
+     *                   has any.
+     *
+     * @throws std::runtime_error if the input size does not match the model.
+     * @throws std::runtime_error if the order of the model is not at least
+     * one.
+     *
+     * @returns A future for the Jacobian, with respect to the input and
+     *          parameters.
+     */
+    std::future<Matrix> jacobian(const Eigen::Ref<const Vector>& input);
+
+    /** Get the statistics gathered since the dispatcher was created or the
+     *  statistics were last reset.
+     *
+     * @returns The statistics.
+     */
+    DispatcherStatistics get_statistics() const;
+
+    /** Reset the statistics, except for the current queue depth. */
+    void reset_statistics();
+
+    /** Get the options of the dispatcher.
+     *
+     * @returns The options.
+     */
+    const DispatcherOptions& get_options() const;
+
+   private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Request {
+        bool is_jacobian;
+        Vector input;
+        Clock::time_point submit_time;
+        std::promise<Vector> value;
+        std::promise<Matrix> jacobian;
+    };
+
+    const size_t input_size_;
+    const size_t output_size_;
+    const DispatcherOptions options_;
+    const Clock::duration max_wait_;
+    bool jacobian_available_;
+
+    // Waiting requests, oldest first, guarded by mutex_. The workers wait
+    // on cv_ for requests to arrive or the oldest one to time out.
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<Request> queue_;
+    bool stopping_ = false;
+
+    // Statistics, guarded by mutex_
+    size_t num_requests_ = 0;
+    size_t num_batches_ = 0;
+    size_t max_batch_size_ = 0;
+    double total_wait_time_ = 0;
+    size_t max_queue_depth_ = 0;
+
+    std::vector<std::unique_ptr<CompiledModel<Scalar>>> models_;
+    std::vector<std::thread> workers_;
+
+    // Add a request to the queue and wake a worker.
+    void submit(Request&& request);
+
+    // Main loop of each worker thread.
+    void run(size_t thread_index);
+
+    // Evaluate a batch of requests of the same kind, fulfilling their
+    // promises. The wait time is the total time the requests spent in the
+    // queue, added to the statistics along with the batch.
+    void process(CompiledModel<Scalar>& model, std::vector<Request>& batch,
+                 double wait_time);
+};  // class BatchDispatcher
+
+#include "impl/BatchDispatcher.tpp"
+
+}  // namespace CppADCodeGenEigenPy
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <fstream>
+#include <map>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace CppADCodeGenEigenPy {
+
+/** Information about the compilation of a model, to keep track of the cost of
+ *  compiling it and the complexity of the generated code.
+ *
+ * A report is saved alongside the library when a model is compiled, so that
+ * it can be retrieved whenever the model is loaded.
+ */
+struct CompileReport {
+    /** Name of the model. */
+    std::string model_name;
+
+    /** Wall time to record the function, including calling input() and
+     *  function(), in seconds. */
+    double record_time = 0;
+
+    /** Wall time to optimize the recorded operation sequence, in seconds. */
+    double optimize_time = 0;
+
+    /** Wall time to generate the C sources, in seconds. */
+    double source_generation_time = 0;
+
+    /** Wall time to compile and link the library, in seconds. */
+    double compile_time = 0;
+
+    /** Wall time to load the compiled model from the library, in seconds. */
+    double load_time = 0;
+
+    /** Number of operations in the recorded operation sequence, before
+     *  optimization. */
+    size_t num_operations = 0;
+
+    /** Number of operations in the recorded operation sequence, after
+     *  optimization. */
+    size_t num_optimized_operations = 0;
+
+    /** Size in bytes of each generated source file, by file name. Each file
+     *  contains a single kernel, such as the Jacobian of a model. */
+    std::map<std::string, size_t> source_sizes;
+
+    /** Size in bytes of the compiled library. */
+    size_t library_size = 0;
+
+    /** Input (including parameters) at which the function was recorded, as
+     *  returned by ADModel::input and ADModel::parameters. */
+    std::vector<double> nominal_input;
+
+    /** Get the total wall time of all compilation phases.
+     *
+     * @returns The total time, in seconds.
+     */
+    double total_time() const;
+
+    /** Save the report to a file, overwriting it if it exists.
+     *
+     * @param[in] path  Path to the file.
+     *
+     * @throws std::runtime_error if the file cannot be written.
+     */
+    void save(const std::string& path) const;
+
+    /** Load a report from a file.
+     *
+     * @param[in] path  Path to the file.
+     *
+     * @throws std::runtime_error if the file cannot be read or is not a
+     * valid report.
+     *
+     * @returns The report.
+     */
+    static CompileReport load(const std::string& path);
+};
+
+/** Print a report in human-readable form. */
+std::ostream& operator<<(std::ostream& out, const CompileReport& report);
+
+#include "impl/CompileReport.tpp"
+
+}  // namespace CppADCodeGenEigenPy
@@ -1,13 +1,77 @@
 #pragma once
 
+#include <dlfcn.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
 #include <Eigen/Eigen>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
 #include <cppad/cg.hpp>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <stdexcept>
 #include <string>
+#include <utility>
+#include <vector>
 
+#include <CppADCodeGenEigenPy/CompileReport.h>
+#include <CppADCodeGenEigenPy/ThreadPool.h>
 #include <CppADCodeGenEigenPy/Util.h>
 
 namespace CppADCodeGenEigenPy {
 
+/** Options for loading a compiled model, to make the latency of the first
+ *  calls the same as that of later calls. */
+struct LoadOptions {
+    /** Resolve all symbols of the library when it is loaded (RTLD_NOW),
+     *  rather than on first use (RTLD_LAZY). */
+    bool bind_now = true;
+
+    /** Read all pages of the library into memory when it is loaded, rather
+     *  than faulting them in on the first calls. */
+    bool prefault = false;
+
+    /** Lock the pages of the library in memory, so that they are never paged
+     *  out. This implies prefault, and may require raising the limit on
+     *  locked memory (RLIMIT_MEMLOCK). */
+    bool lock_memory = false;
+
+    /** Call each available kernel when the model is loaded, so that caches
+     *  and branch predictors are warm on the first real call. */
+    bool warmup = false;
+
+    /** Number of times each kernel is called during warmup. */
+    size_t warmup_iterations = 10;
+
+    /** Input (including parameters) used for warmup. If empty, the nominal
+     *  input saved in the compile report is used, or zeros if there is
+     *  none. */
+    std::vector<double> warmup_input;
+};
+
+/** Latency of a kernel measured during warmup. */
+struct WarmupLatency {
+    /** Name of the kernel: "evaluate", "jacobian", "hessian",
+     *  "jacobian_block:<output segment>,<input segment>",
+     *  "parameter_jacobian", or "mixed_hessian". */
+    std::string kernel;
+
+    /** Time taken by the first call, in seconds. */
+    double first_call_time;
+
+    /** Mean time taken by the subsequent calls, in seconds. */
+    double steady_state_time;
+};
+
+template <typename Scalar>
+class ADModel;
+
 /** A CompiledModel wraps a dynamic library that has been compiled from derived
  * class
  *  of ADModel. It provides methods for evaluating the function and available
@@ -25,6 +89,27 @@ class CompiledModel {
     using Matrix =
         Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
 
+    /** A Jacobian block, identified by the names of its (output, input)
+     *  segments. */
+    using JacobianBlock = std::pair<std::string, std::string>;
+
+    /** Sums over a dataset, computed by reduce. J_i is the Jacobian of the
+     *  output of the i-th sample with respect to either the input or the
+     *  parameters. */
+    struct Reduction {
+        /** Sum of the outputs. */
+        Vector output_sum;
+
+        /** Sum of the squared norms of the outputs. */
+        Scalar squared_output_sum = 0;
+
+        /** Sum of J_i^T w_i. */
+        Vector gradient;
+
+        /** Sum of J_i^T J_i, if requested; otherwise empty. */
+        Matrix gauss_newton;
+    };
+
     /** Constructor.
      *
      * @param[in] model_name  The name of the model being loaded from the
@@ -35,6 +120,35 @@ class CompiledModel {
     CompiledModel(const std::string& model_name,
                   const std::string& library_generic_path);
 
+    /** Constructor.
+     *
+     * @param[in] model_name  The name of the model being loaded from the
+     *                        dynamic library.
+     * @param[in] library_generic_path  The full path to the dynamic library,
+     *                                  without the file extension.
+     * @param[in] options  Options for loading the library.
+     *
+     * @throws std::runtime_error if the library cannot be loaded or read, if
+     * its pages cannot be locked in memory when requested, or if the warmup
+     * input has the wrong size.
+     */
+    CompiledModel(const std::string& model_name,
+                  const std::string& library_generic_path,
+                  const LoadOptions& options);
+
+    /** Copy constructor. The copy shares the loaded library but has its own
+     *  instance of the model, so the original and the copy may be used
+     *  concurrently from different threads. A single CompiledModel should
+     *  not be used from multiple threads at once. Copying a model returned
+     *  by ADModel::compile_lazy waits for its derivatives, which the copy
+     *  then uses.
+     *
+     * @param[in] other  The model to copy.
+     */
+    CompiledModel(const CompiledModel& other);
+
+    CompiledModel(CompiledModel&& other) = default;
+
     // ~CompiledModel() = default;
 
     /** Evaluate the function. This overload should be called if the modelled
@@ -93,6 +207,39 @@ class CompiledModel {
     Matrix jacobian(const Eigen::Ref<const Vector>& input,
                     const Eigen::Ref<const Vector>& parameters) const;
 
+    /** Compute the gradient of a function with a single output. This
+     *  overload should be called if the modelled function has no parameters.
+     *
+     * @param[in] input  The input at which to evaluate the gradient.
+     *
+     * @throws std::runtime_error if the provided input size does not match
+     * that of the model.
+     * @throws std::runtime_error if the model does not have a single output.
+     * @throws std::runtime_error if the order of the model is not at least
+     * one.
+     *
+     * @returns The gradient vector.
+     */
+    Vector gradient(const Eigen::Ref<const Vector>& input) const;
+
+    /** Compute the gradient of a function with a single output, with respect
+     *  to the input only. This overload should be called if the modelled
+     *  function has parameters.
+     *
+     * @param[in] input       The input at which to evaluate the gradient.
+     * @param[in] parameters  The parameters for the function.
+     *
+     * @throws std::runtime_error if the combined size of the provided input
+     * and parameters does not match the input size of the model.
+     * @throws std::runtime_error if the model does not have a single output.
+     * @throws std::runtime_error if the order of the model is not at least
+     * one.
+     *
+     * @returns The gradient vector.
+     */
+    Vector gradient(const Eigen::Ref<const Vector>& input,
+                    const Eigen::Ref<const Vector>& parameters) const;
+
     /** Compute the function's Hessian (second-order derivative) for a given
      *  output dimension. This overload should be called if the modelled
      *  function has no parameters.
@@ -131,6 +278,201 @@ class CompiledModel {
                    const Eigen::Ref<const Vector>& parameters,
                    size_t output_dim = 0) const;
 
+    /** Compute the lower triangle of the function's Hessian for a given
+     *  output dimension, packed row by row: element (i, j), for j <= i, is
+     *  at index i * (i + 1) / 2 + j. This is the order of numpy's
+     *  tril_indices. If the model was compiled with
+     *  CompileOptions::symmetric_hessian, only the triangle is computed.
+     *  This overload should be called if the modelled function has no
+     *  parameters.
+     *
+     * @param[in] input       The input at which to evaluate the Hessian.
+     * @param[in] output_dim  The output dimension for which to evaluate the
+     *                        Hessian.
+     *
+     * @throws std::runtime_error if the provided input size does not match
+     * that of the model.
+     * @throws std::runtime_error if the order of the model is not at least
+     * two.
+     *
+     * @returns The packed lower triangle, of size n * (n + 1) / 2 for input
+     *          size n.
+     */
+    Vector hessian_packed(const Eigen::Ref<const Vector>& input,
+                          size_t output_dim = 0) const;
+
+    /** Compute the lower triangle of the function's Hessian for a given
+     *  output dimension, packed row by row (see above). This overload should
+     *  be called if the modelled function has parameters.
+     *
+     * @param[in] input       The input at which to evaluate the Hessian.
+     * @param[in] parameters  The parameters for the function.
+     * @param[in] output_dim  The output dimension for which to evaluate the
+     *                        Hessian.
+     *
+     * @throws std::runtime_error if the combined size of the provided input
+     * and parameters does not match the input size of the model.
+     * @throws std::runtime_error if the order of the model is not at least
+     * two.
+     *
+     * @returns The packed lower triangle of the Hessian with respect to the
+     *          input.
+     */
+    Vector hessian_packed(const Eigen::Ref<const Vector>& input,
+                          const Eigen::Ref<const Vector>& parameters,
+                          size_t output_dim = 0) const;
+
+    /** Compute a single block of the function's Jacobian. Only the elements
+     *  of the block are computed. This overload should be called if the
+     *  modelled function has no parameters.
+     *
+     * @param[in] output_segment  Name of the output segment of the block.
+     * @param[in] input_segment   Name of the input segment of the block.
+     * @param[in] input           The input at which to evaluate the Jacobian.
+     *
+     * @throws std::runtime_error if the provided input size does not match
+     * that of the model.
+     * @throws std::runtime_error if no kernel was generated for the block.
+     *
+     * @returns The Jacobian block matrix.
+     */
+    Matrix jacobian_block(const std::string& output_segment,
+                          const std::string& input_segment,
+                          const Eigen::Ref<const Vector>& input) const;
+
+    /** Compute a single block of the function's Jacobian. Only the elements
+     *  of the block are computed. This overload should be called if the
+     *  modelled function has parameters.
+     *
+     * @param[in] output_segment  Name of the output segment of the block.
+     * @param[in] input_segment   Name of the input segment of the block.
+     * @param[in] input           The input at which to evaluate the Jacobian.
+     * @param[in] parameters      The parameters for the function.
+     *
+     * @throws std::runtime_error if the combined size of the provided input
+     * and parameters does not match the input size of the model.
+     * @throws std::runtime_error if no kernel was generated for the block.
+     *
+     * @returns The Jacobian block matrix.
+     */
+    Matrix jacobian_block(const std::string& output_segment,
+                          const std::string& input_segment,
+                          const Eigen::Ref<const Vector>& input,
+                          const Eigen::Ref<const Vector>& parameters) const;
+
+    /** Compute the Jacobian of the function with respect to its parameters.
+     *  Only the parameter columns are computed.
+     *
+     * @param[in] input       The input at which to evaluate the Jacobian.
+     * @param[in] parameters  The parameters for the function.
+     *
+     * @throws std::runtime_error if the sizes of the provided input and
+     * parameters do not match those of the model.
+     * @throws std::runtime_error if the model was not compiled with
+     * CompileOptions::parameter_derivatives to at least first order.
+     *
+     * @returns The Jacobian with respect to the parameters, of shape
+     *          (output size, parameter size).
+     */
+    Matrix parameter_jacobian(const Eigen::Ref<const Vector>& input,
+                              const Eigen::Ref<const Vector>& parameters) const;
+
+    /** Compute the mixed second derivatives of the function with respect to
+     *  its input and parameters for a given output dimension. Only this
+     *  block of the Hessian is computed.
+     *
+     * @param[in] input       The input at which to evaluate the derivatives.
+     * @param[in] parameters  The parameters for the function.
+     * @param[in] output_dim  The output dimension for which to evaluate the
+     *                        derivatives.
+     *
+     * @throws std::runtime_error if the sizes of the provided input and
+     * parameters do not match those of the model.
+     * @throws std::runtime_error if the model was not compiled with
+     * CompileOptions::parameter_derivatives to second order.
+     *
+     * @returns The matrix of mixed derivatives, with element (i, j) the
+     *          derivative with respect to input i and parameter j.
+     */
+    Matrix mixed_hessian(const Eigen::Ref<const Vector>& input,
+                         const Eigen::Ref<const Vector>& parameters,
+                         size_t output_dim = 0) const;
+
+    /** Evaluate the function at each of a batch of inputs.
+     *
+     * @param[in] inputs  The inputs, one per row. Each input includes the
+     *                    parameters, if the function has any.
+     *
+     * @throws std::runtime_error if the number of columns of inputs does not
+     * match the input size of the model.
+     *
+     * @returns The outputs, one per row.
+     */
+    Matrix evaluate_batch(const Eigen::Ref<const Matrix>& inputs) const;
+
+    /** Compute the function's Jacobian at each of a batch of inputs.
+     *
+     * @param[in] inputs  The inputs, one per row. Each input includes the
+     *                    parameters, if the function has any.
+     *
+     * @throws std::runtime_error if the number of columns of inputs does not
+     * match the input size of the model.
+     * @throws std::runtime_error if the order of the model is not at least
+     * one.
+     *
+     * @returns The Jacobians, one per row, each flattened in row-major
+     *          order.
+     */
+    Matrix jacobian_batch(const Eigen::Ref<const Matrix>& inputs) const;
+
+    /** Compute sums over a dataset of N samples without storing the outputs
+     *  or Jacobians of the samples. The samples are split over threads,
+     *  each accumulating its own sums, which are then added up pairwise.
+     *
+     * For fitting, the quantity being fitted is either the input, with the
+     * data as parameters, or the parameters, with the data as input. With
+     * the outputs as weights, the gradient is that of half the squared
+     * output sum, and the Gauss-Newton matrix approximates its Hessian.
+     *
+     * @param[in] inputs        The inputs, with shape (N, n), or (1, n) for
+     *                          an input shared by all samples.
+     * @param[in] parameters    The parameters, with shape (N, p), or (1, p)
+     *                          for parameters shared by all samples. May be
+     *                          empty if the function has no parameters.
+     * @param[in] weights       The weights w_i of the gradient, with shape
+     *                          (N, m) or (1, m). If empty, the outputs are
+     *                          used.
+     * @param[in] gauss_newton  Also compute the sum of J_i^T J_i, of size
+     *                          (n, n), or (p, p) with respect to the
+     *                          parameters.
+     * @param[in] with_respect_to_parameters  Take the Jacobians with respect
+     *                          to the parameters rather than the input. The
+     *                          parameter kernel is used if the model was
+     *                          compiled with parameter derivatives.
+     * @param[in] num_threads   The number of threads. If zero, the number
+     *                          of hardware threads is used.
+     *
+     * @throws std::runtime_error if the shapes are inconsistent with each
+     * other or the model, or if there are no parameters to take the
+     * Jacobians with respect to.
+     * @throws std::runtime_error if the order of the model is not at least
+     * one.
+     *
+     * @returns The sums.
+     */
+    Reduction reduce(const Eigen::Ref<const Matrix>& inputs,
+                     const Eigen::Ref<const Matrix>& parameters = Matrix(),
+                     const Eigen::Ref<const Matrix>& weights = Matrix(),
+                     bool gauss_newton = false,
+                     bool with_respect_to_parameters = false,
+                     size_t num_threads = 0) const;
+
+    /** Get the Jacobian blocks for which kernels are available.
+     *
+     * @returns The (output segment, input segment) name pairs.
+     */
+    std::vector<JacobianBlock> get_jacobian_blocks() const;
+
     /** Get the input size of the model. Note that this includes both normal
      *  inputs and parameters.
      *
@@ -144,13 +486,169 @@ class CompiledModel {
      */
     size_t get_output_size() const;
 
+    /** Set the number of threads used to compute derivatives. This only has
+     *  an effect if the model was compiled with multithreading, and applies
+     *  to all copies of the model, since they share the library.
+     *
+     * @param[in] num_threads  The number of threads.
+     */
+    void set_num_threads(size_t num_threads);
+
+    /** Get the number of threads used to compute derivatives.
+     *
+     * @returns The number of threads. This is always 1 if the model was
+     *          compiled without multithreading.
+     */
+    size_t get_num_threads() const;
+
+    /** Check if the derivatives of the model are available without
+     *  waiting. This is only false for models returned by
+     *  ADModel::compile_lazy whose derivatives are still being compiled.
+     *
+     * @returns True if the derivatives are ready, false otherwise.
+     */
+    bool derivatives_ready() const;
+
+    /** Wait for the derivatives of a model returned by ADModel::compile_lazy
+     *  to be compiled, and switch to the library containing them. Until
+     *  then, methods computing derivatives wait for them and forward to
+     *  that library without modifying the model. It has no effect for other
+     *  models.
+     *
+     * @throws std::runtime_error if compiling the derivatives failed.
+     */
+    void wait_for_derivatives();
+
+    /** Get the underlying CppADCodeGen model, for use with its lower-level
+     *  interface. This waits for the derivatives of a lazily compiled model
+     *  (see wait_for_derivatives), returning the model that contains them.
+     *  The reference stays valid when the model switches to it.
+     *
+     * @returns The CppADCodeGen model.
+     */
+    CppAD::cg::GenericModel<Scalar>& get_generic_model() const;
+
+    /** Get the name of the model.
+     *
+     * @returns The name of the model.
+     */
+    const std::string& get_model_name() const;
+
+    /** Get the absolute path to the dynamic library the model was loaded
+     *  from, without the file extension.
+     *
+     * @returns The path to the library.
+     */
+    const std::string& get_library_path() const;
+
+    /** Get a hash of the contents of the dynamic library the model was loaded
+     *  from. It is computed when the library is loaded, so that it describes
+     *  that library even if the file is replaced afterwards.
+     *
+     * @returns The hash, as a hex string.
+     */
+    const std::string& get_library_hash() const;
+
+    /** Get the latency of each kernel measured during warmup.
+     *
+     * @returns The latencies, which are empty if the model was not warmed
+     *          up when loaded.
+     */
+    const std::vector<WarmupLatency>& get_warmup_latencies() const;
+
+    /** Get the report saved when the model was compiled, which contains the
+     *  time taken by each phase of compilation and the size of the generated
+     *  code.
+     *
+     * @throws std::runtime_error if there is no report for the library,
+     * which is the case if it was not compiled with ADModel::compile.
+     *
+     * @returns The report.
+     */
+    CompileReport get_compile_report() const;
+
    private:
-    std::unique_ptr<CppAD::cg::DynamicLib<Scalar>> lib_;
+    // Sets derivative_model_ and derivative_sources_
+    friend class ADModel<Scalar>;
+
+    // The library is shared between copies of the model. It is replaced by
+    // the derivative library by wait_for_derivatives.
+    std::shared_ptr<CppAD::cg::DynamicLib<Scalar>> lib_;
     std::unique_ptr<CppAD::cg::GenericModel<Scalar>> model_;
+    std::string model_name_;
+    std::string library_path_;
+
+    // Sources of the derivative library of a lazily compiled model. They
+    // are only released by the thread owning the model, since they hold
+    // CppAD objects, so this must be declared before derivative_model_,
+    // whose destruction waits for the compilation.
+    std::shared_ptr<void> derivative_sources_;
+
+    // Model with all derivatives, still being compiled, if this model was
+    // compiled lazily; otherwise invalid. Only this model uses it, so that
+    // its kernels can be moved here by wait_for_derivatives.
+    std::shared_future<std::shared_ptr<CompiledModel>> derivative_model_;
+
+    // Hash of the library file when it was loaded
+    std::string library_hash_;
+
+    // Kernel computing only the elements of a single Jacobian block, along
+    // with the position of the block in the full Jacobian.
+    struct BlockKernel {
+        std::unique_ptr<CppAD::cg::GenericModel<Scalar>> model;
+        size_t row_offset;
+        size_t col_offset;
+        size_t rows;
+        size_t cols;
+    };
+    std::map<JacobianBlock, BlockKernel> block_kernels_;
+
+    // Kernel computing the derivatives with respect to the parameters, if
+    // it is available, and the number of parameters it was generated for
+    std::unique_ptr<CppAD::cg::GenericModel<Scalar>> parameter_kernel_;
+    size_t parameter_size_ = 0;
+
+    // Number of elements computed by the sparse Hessian, if it is available
+    size_t hessian_nnz_ = 0;
 
     size_t input_size_;
     size_t output_size_;
 
+    std::vector<WarmupLatency> warmup_latencies_;
+
+    // Read the pages of the loaded library into memory, and optionally lock
+    // them there
+    void prefault(bool lock_memory) const;
+
+    // Call each kernel a number of times, recording its latency
+    void warmup(const LoadOptions& options);
+
+    // Load the kernels for the Jacobian blocks from the library.
+    void load_block_kernels(const std::string& model_name);
+
+    // Add the sums of the samples [begin, end) to those of a reduction.
+    void accumulate(size_t begin, size_t end,
+                    const Eigen::Ref<const Matrix>& inputs,
+                    const Eigen::Ref<const Matrix>& parameters,
+                    const Eigen::Ref<const Matrix>& weights,
+                    bool with_respect_to_parameters, Reduction& sums) const;
+
+    // Load the parameter derivative kernel, if the library has one.
+    void load_parameter_kernel(const std::string& model_name);
+
+    // The model serving the derivatives: the derivative model of a lazily
+    // compiled model, waiting for it if needed, or otherwise this one.
+    const CompiledModel& derivative_source() const;
+
+    // Check that the sizes match the parameter kernel and combine the
+    // input and parameters into a single vector.
+    Vector parameter_kernel_input(
+        const Eigen::Ref<const Vector>& input,
+        const Eigen::Ref<const Vector>& parameters) const;
+
+    // Error if the Hessian is not available for the given output dimension.
+    void check_hessian_available(size_t output_dim) const;
+
     // Error if input size is wrong. If it is too small,the user may have
     // meant to pass parameters as well.
     void check_input_size(size_t size) const;
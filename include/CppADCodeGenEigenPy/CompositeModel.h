@@ -0,0 +1,167 @@
+#pragma once
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <Eigen/Eigen>
+
+#include <CppADCodeGenEigenPy/CompiledModel.h>
+
+namespace CppADCodeGenEigenPy {
+
+/** A function composed of compiled models, whose derivatives are computed
+ *  from those of the models using the chain rule.
+ *
+ * The models are evaluated in the order they were added. Each one takes its
+ * input (including its parameters) from a vector of values, which starts with
+ * the input of the composite and is extended by the outputs of each model in
+ * turn. A model can therefore take its input from any combination of the
+ * composite input and the outputs of earlier models. The output of the
+ * composite is the output of the last model.
+ *
+ * All intermediate results are stored in buffers allocated when the models
+ * are added. A CompositeModel keeps its own copy of each model, but a single
+ * composite should not be used from multiple threads at once.
+ *
+ * @tparam Scalar  The scalar type to use. Typically float or double.
+ */
+template <typename Scalar>
+class CompositeModel {
+   public:
+    using Vector = typename CompiledModel<Scalar>::Vector;
+    using Matrix = typename CompiledModel<Scalar>::Matrix;
+
+    /** Constructor.
+     *
+     * @param[in] input_size  The size of the input of the composite.
+     */
+    explicit CompositeModel(size_t input_size);
+
+    /** Add a model to the composite.
+     *
+     * @param[in] model          The compiled model. It is copied.
+     * @param[in] input_indices  For each element of the model's input
+     *                           (including parameters), its index in the
+     *                           vector of values: either an index of the
+     *                           composite input, or the offset of an
+     *                           earlier model's output plus an index of that
+     *                           output.
+     *
+     * @throws std::runtime_error if the indices do not match the model input
+     * size, or refer to values that are not yet available.
+     *
+     * @returns The offset of this model's output in the vector of values.
+     */
+    size_t add_model(const CompiledModel<Scalar>& model,
+                     const std::vector<size_t>& input_indices);
+
+    /** Evaluate the function.
+     *
+     * @param[in] input  The input at which to evaluate the function.
+     *
+     * @throws std::runtime_error if the input size is wrong or the composite
+     * has no models.
+     *
+     * @returns The function output.
+     */
+    Vector evaluate(const Eigen::Ref<const Vector>& input);
+
+    /** Compute the function's Jacobian.
+     *
+     * @param[in] input  The input at which to evaluate the Jacobian.
+     *
+     * @throws std::runtime_error if the input size is wrong, the composite
+     * has no models, or a model is not at least first-order.
+     *
+     * @returns The Jacobian matrix.
+     */
+    Matrix jacobian(const Eigen::Ref<const Vector>& input);
+
+    /** Compute the function's Hessian for a given output dimension.
+     *
+     * @param[in] input       The input at which to evaluate the Hessian.
+     * @param[in] output_dim  The output dimension for which to evaluate the
+     *                        Hessian.
+     *
+     * @throws std::runtime_error if the input size is wrong, the composite
+     * has no models, the output dimension is out of range, or a model on
+     * which the output depends is not second-order.
+     *
+     * @returns The Hessian matrix.
+     */
+    Matrix hessian(const Eigen::Ref<const Vector>& input,
+                   size_t output_dim = 0);
+
+    /** Get the input size of the composite.
+     *
+     * @returns The size of the input.
+     */
+    size_t get_input_size() const;
+
+    /** Get the output size of the composite, which is that of the last
+     *  model.
+     *
+     * @returns The size of the output.
+     */
+    size_t get_output_size() const;
+
+    /** Get the number of models in the composite.
+     *
+     * @returns The number of models.
+     */
+    size_t get_num_models() const;
+
+   private:
+    struct Stage {
+        CompiledModel<Scalar> model;
+        std::vector<size_t> input_indices;
+        size_t output_offset;
+
+        // Gathered input of the model
+        Vector input;
+
+        // Jacobian of the model with respect to its input
+        Matrix jacobian;
+
+        // Derivative of the model's input with respect to the composite
+        // input
+        Matrix input_tangent;
+
+        // Derivative of the composite output with respect to the model's
+        // input
+        Vector input_adjoint;
+
+        // Hessian of the model's outputs weighted by their adjoints, and its
+        // product with the input tangent
+        Matrix weighted_hessian;
+        Matrix hessian_tangent;
+    };
+
+    size_t input_size_;
+    std::vector<Stage> stages_;
+
+    // Composite input followed by the outputs of each model, their
+    // derivatives with respect to the composite input, and the derivatives
+    // of a composite output with respect to them
+    Vector values_;
+    Matrix tangents_;
+    Vector adjoints_;
+
+    Matrix hessian_;
+
+    // Check the input and evaluate the models in order, also propagating
+    // the derivatives with respect to the composite input if requested
+    void forward(const Eigen::Ref<const Vector>& input, bool tangents);
+
+    // Compute the Jacobian of a stage's model at its input.
+    void compute_jacobian(Stage& stage) const;
+
+    // Compute the Hessian of a stage's model at its input, weighted by the
+    // adjoints of its outputs.
+    void compute_weighted_hessian(Stage& stage) const;
+};  // class CompositeModel
+
+#include "impl/CompositeModel.tpp"
+
+}  // namespace CppADCodeGenEigenPy
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <signal.h>
+
+#include <Eigen/Eigen>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <CppADCodeGenEigenPy/EvaluationProtocol.h>
+#include <CppADCodeGenEigenPy/RealtimeModel.h>
+
+namespace CppADCodeGenEigenPy {
+
+/** Client of an EvaluationServer running in another process (or the same
+ *  one).
+ *
+ * A client claims one of the server's slots when it connects, and submits
+ * requests to the ring buffer of that slot. Requests may be evaluated
+ * synchronously using evaluate() and jacobian(), or pipelined by submitting
+ * several requests before collecting their results, up to the ring capacity
+ * of the server.
+ *
+ * A client should not be used from multiple threads at once; use one client
+ * per thread instead.
+ *
+ * @tparam Scalar  The scalar type to use, which must match the server's.
+ */
+template <typename Scalar>
+class EvaluationClient {
+   public:
+    using Vector = Eigen::Matrix<Scalar, Eigen::Dynamic, 1>;
+    using Matrix =
+        Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+    /** Constructor. Connects to the server.
+     *
+     * @param[in] server_name      Name of the server to connect to.
+     * @param[in] connect_timeout  Time in seconds to wait for the server to
+     *                             start, if it is not running yet.
+     * @param[in] spin_iterations  Number of times to poll for a response
+     *                             before sleeping until the server signals
+     *                             it. Spinning is disabled on machines with
+     *                             a single CPU.
+     *
+     * @throws std::runtime_error if the server is not running, is
+     *         incompatible, or has no free slots.
+     */
+    EvaluationClient(const std::string& server_name,
+                     double connect_timeout = 0,
+                     size_t spin_iterations = 10000);
+
+    /** Destructor. Waits for outstanding requests and releases the slot. */
+    ~EvaluationClient();
+
+    EvaluationClient(const EvaluationClient&) = delete;
+    EvaluationClient& operator=(const EvaluationClient&) = delete;
+
+    /** Get the index of a model hosted by the server.
+     *
+     * @param[in] model_name  The name of the model.
+     *
+     * @returns The index of the model.
+     *
+     * @throws std::runtime_error if the server does not host the model.
+     */
+    size_t get_model_index(const std::string& model_name) const;
+
+    /** Get the names of the models hosted by the server.
+     *
+     * @returns The model names, in order of their indices.
+     */
+    std::vector<std::string> get_model_names() const;
+
+    /** Get the input size of a model, including its parameters.
+     *
+     * @param[in] model  The index of the model.
+     *
+     * @returns The input size.
+     */
+    size_t get_input_size(size_t model) const;
+
+    /** Get the output size of a model.
+     *
+     * @param[in] model  The index of the model.
+     *
+     * @returns The output size.
+     */
+    size_t get_output_size(size_t model) const;
+
+    /** Get the maximum number of outstanding requests.
+     *
+     * @returns The ring capacity of the server.
+     */
+    size_t get_ring_capacity() const;
+
+    /** Submit a request without waiting for its result.
+     *
+     * @param[in] model   The index of the model.
+     * @param[in] kernel  The kernel to evaluate.
+     * @param[in] input   The input, including any parameters.
+     *
+     * @returns A ticket to collect the result with.
+     *
+     * @throws std::runtime_error if the request is invalid, or if the
+     *         maximum number of outstanding requests has been reached.
+     */
+    uint64_t submit(size_t model, Kernel kernel,
+                    const Eigen::Ref<const Vector>& input);
+
+    /** Wait for the result of a request.
+     *
+     * @param[in] ticket  The ticket returned when submitting the request.
+     *
+     * @returns The output of the function, or the Jacobian flattened in
+     *          row-major order.
+     *
+     * @throws std::runtime_error if the ticket is invalid, the request
+     *         failed, or the server has stopped.
+     */
+    Vector collect(uint64_t ticket);
+
+    /** Evaluate a model on the server.
+     *
+     * @param[in] model  The index of the model.
+     * @param[in] input  The input, including any parameters.
+     *
+     * @returns The output of the function.
+     */
+    Vector evaluate(size_t model, const Eigen::Ref<const Vector>& input);
+
+    /** Compute the Jacobian of a model on the server.
+     *
+     * @param[in] model  The index of the model.
+     * @param[in] input  The input, including any parameters.
+     *
+     * @returns The Jacobian with respect to the full input.
+     */
+    Matrix jacobian(size_t model, const Eigen::Ref<const Vector>& input);
+
+   private:
+    protocol::Header* header_ = nullptr;
+    size_t region_size_ = 0;
+    size_t slot_ = 0;
+    size_t spin_iterations_;
+
+    // Number of requests submitted to the slot
+    uint64_t head_ = 0;
+
+    // Map the region of a running server, returning false if it is not
+    // ready yet.
+    bool try_map(const std::string& shm_name);
+
+    // Claim a free slot, or one left behind by a client that has exited.
+    bool try_claim(size_t slot);
+
+    // Wait until the server is done with an entry.
+    void wait(protocol::EntryHeader* entry);
+};  // class EvaluationClient
+
+#include "impl/EvaluationClient.tpp"
+
+}  // namespace CppADCodeGenEigenPy
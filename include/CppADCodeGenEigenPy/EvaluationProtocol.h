@@ -0,0 +1,223 @@
+#pragma once
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace CppADCodeGenEigenPy {
+
+/** Kernel requested from an EvaluationServer. */
+enum class Kernel : uint32_t {
+    /** Evaluate the function. */
+    Evaluate,
+
+    /** Compute the Jacobian with respect to the full input, including any
+     *  parameters. */
+    Jacobian,
+};
+
+/** Layout of the shared memory used by EvaluationServer and
+ *  EvaluationClient.
+ *
+ * The shared memory region consists of a Header followed by a number of
+ * client slots. Each slot is a ring of request entries, which is written by a
+ * single client and read by the server. An entry consists of an EntryHeader
+ * followed by space for the input and the output (or row-major Jacobian) of
+ * the largest model.
+ *
+ * Signaling is done using atomic state words in shared memory. Waiters spin
+ * briefly and then sleep on the state word using a futex, so that no locks are
+ * shared between processes.
+ */
+namespace protocol {
+
+const uint64_t MAGIC = 0x43474550594e5356;  // "CGEPYSRV"
+const uint32_t VERSION = 1;
+
+const size_t MAX_MODELS = 32;
+const size_t MAX_MODEL_NAME_LENGTH = 64;
+const size_t CACHE_LINE_SIZE = 64;
+
+static_assert(ATOMIC_INT_LOCK_FREE == 2 && ATOMIC_LLONG_LOCK_FREE == 2,
+              "Shared memory signaling requires lock-free atomic integers.");
+
+/** State of a request entry. */
+enum class EntryState : uint32_t {
+    /** Free for the client to write a new request. */
+    Empty,
+
+    /** Written by the client and waiting for the server. */
+    Submitted,
+
+    /** Picked up by the server. */
+    InProgress,
+
+    /** The output has been written by the server. */
+    Done,
+
+    /** The request failed; the status field holds the reason. */
+    Failed,
+};
+
+/** Store a state in an entry's state word. */
+inline void set_state(std::atomic<uint32_t>& word, EntryState state) {
+    word.store(static_cast<uint32_t>(state), std::memory_order_release);
+}
+
+/** Load the state from an entry's state word. */
+inline EntryState get_state(const std::atomic<uint32_t>& word) {
+    return static_cast<EntryState>(word.load(std::memory_order_acquire));
+}
+
+/** Description of a model hosted by the server. */
+struct ModelInfo {
+    char name[MAX_MODEL_NAME_LENGTH];
+    uint32_t input_size;
+    uint32_t output_size;
+};
+
+struct alignas(CACHE_LINE_SIZE) Header {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t scalar_size;
+    int32_t server_pid;
+
+    uint32_t num_models;
+    uint32_t num_slots;
+    uint32_t ring_capacity;
+
+    // Number of scalars of data per entry, and bytes per entry and per slot
+    uint32_t entry_data_size;
+    uint64_t entry_size;
+    uint64_t slot_size;
+
+    // Cleared by the server when it shuts down
+    std::atomic<uint32_t> running;
+
+    // Incremented by clients after submitting requests. The server sleeps on
+    // this word when there is no work.
+    alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> doorbell;
+    std::atomic<uint32_t> server_sleeping;
+
+    alignas(CACHE_LINE_SIZE) ModelInfo models[MAX_MODELS];
+};
+
+// Leading fields of the Header, which can be read from a region with read()
+// since they do not include the atomics
+struct HeaderPrefix {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t scalar_size;
+    int32_t server_pid;
+};
+
+static_assert(offsetof(Header, magic) == offsetof(HeaderPrefix, magic) &&
+                  offsetof(Header, server_pid) ==
+                      offsetof(HeaderPrefix, server_pid),
+              "HeaderPrefix does not match the layout of Header.");
+
+struct alignas(CACHE_LINE_SIZE) SlotHeader {
+    // Process ID of the client that owns the slot, or zero if it is free
+    std::atomic<uint32_t> owner;
+
+    // Number of requests picked up from this slot by the server. A client
+    // claiming the slot continues submitting from here, so that it stays in
+    // step with the server even if the previous owner exited without
+    // releasing the slot.
+    std::atomic<uint64_t> tail;
+};
+
+struct alignas(CACHE_LINE_SIZE) EntryHeader {
+    std::atomic<uint32_t> state;
+
+    // Set by the client while it sleeps waiting for this entry
+    std::atomic<uint32_t> client_waiting;
+
+    uint32_t model;
+    uint32_t kernel;
+
+    // Status of a failed request (see RealtimeModel's Status)
+    uint32_t status;
+};
+
+/** Round a size up to a multiple of the cache line size. */
+inline size_t align_to_cache_line(size_t size) {
+    return (size + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE;
+}
+
+/** Get the total size of the shared memory region. */
+inline size_t get_region_size(const Header& header) {
+    return align_to_cache_line(sizeof(Header)) +
+           header.num_slots * header.slot_size;
+}
+
+/** Get the header of a slot. */
+inline SlotHeader* get_slot(Header* header, size_t slot) {
+    char* base = reinterpret_cast<char*>(header) +
+                 align_to_cache_line(sizeof(Header)) +
+                 slot * header->slot_size;
+    return reinterpret_cast<SlotHeader*>(base);
+}
+
+/** Get the header of an entry of a slot. */
+inline EntryHeader* get_entry(Header* header, size_t slot, size_t index) {
+    char* base = reinterpret_cast<char*>(get_slot(header, slot)) +
+                 align_to_cache_line(sizeof(SlotHeader)) +
+                 (index % header->ring_capacity) * header->entry_size;
+    return reinterpret_cast<EntryHeader*>(base);
+}
+
+/** Get the data following an entry's header. */
+template <typename Scalar>
+Scalar* get_entry_data(EntryHeader* entry) {
+    return reinterpret_cast<Scalar*>(reinterpret_cast<char*>(entry) +
+                                     align_to_cache_line(sizeof(EntryHeader)));
+}
+
+/** Get the name of the shared memory object for a server name. */
+inline std::string get_shm_name(const std::string& server_name) {
+    return "/CppADCodeGenEigenPy." + server_name;
+}
+
+/** Hint to the CPU that the calling thread is spinning. */
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+/** Sleep until the word no longer holds the expected value, it is woken, or
+ *  the timeout (in nanoseconds) expires. */
+inline void futex_wait(std::atomic<uint32_t>* word, uint32_t expected,
+                       long timeout_ns) {
+    struct timespec timeout;
+    timeout.tv_sec = timeout_ns / 1000000000L;
+    timeout.tv_nsec = timeout_ns % 1000000000L;
+    // The word is shared between processes, so the private futex operations
+    // cannot be used
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT, expected,
+            &timeout, nullptr, 0);
+}
+
+/** Wake all threads sleeping on the word. */
+inline void futex_wake(std::atomic<uint32_t>* word) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE,
+            INT32_MAX, nullptr, nullptr, 0);
+}
+
+}  // namespace protocol
+}  // namespace CppADCodeGenEigenPy
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <signal.h>
+
+#include <Eigen/Eigen>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <CppADCodeGenEigenPy/CompiledModel.h>
+#include <CppADCodeGenEigenPy/EvaluationProtocol.h>
+#include <CppADCodeGenEigenPy/RealtimeModel.h>
+#include <CppADCodeGenEigenPy/ThreadPool.h>
+
+namespace CppADCodeGenEigenPy {
+
+/** Options for an EvaluationServer. */
+struct ServerOptions {
+    /** Number of threads evaluating requests, including the dispatching
+     *  thread. */
+    size_t num_threads = 1;
+
+    /** CPUs to pin the threads to: the dispatching thread is pinned to
+     *  cpus[0] and evaluating thread i to cpus[i % size]. If empty, no
+     *  threads are pinned. */
+    std::vector<int> cpus;
+
+    /** Maximum number of clients connected at once. */
+    size_t num_slots = 64;
+
+    /** Maximum number of outstanding requests per client. */
+    size_t ring_capacity = 16;
+
+    /** Maximum number of requests evaluated in a single batch. */
+    size_t max_batch_size = 1024;
+
+    /** Number of times the server polls for requests before going to sleep
+     *  until a client signals it. Spinning is disabled on machines with a
+     *  single CPU. */
+    size_t spin_iterations = 10000;
+};
+
+/** Hosts compiled models for evaluation by clients in other processes.
+ *
+ * Clients (see EvaluationClient) connect to the server by name and submit
+ * requests through a ring buffer in shared memory, so that a single copy of
+ * each model is loaded and kept warm no matter how many processes use it.
+ *
+ * The server runs a dispatching thread, which collects all requests that
+ * have been submitted by the time it polls and evaluates them together as a
+ * batch on a pool of (optionally pinned) threads. Inputs are read from and
+ * outputs written to shared memory directly, so the server does not copy or
+ * allocate per request.
+ *
+ * @tparam Scalar  The scalar type to use. Typically float or double.
+ */
+template <typename Scalar>
+class EvaluationServer {
+   public:
+    using Vector = typename CompiledModel<Scalar>::Vector;
+    using Matrix = typename CompiledModel<Scalar>::Matrix;
+
+    /** Constructor. Creates the shared memory and starts serving requests.
+     *
+     * @param[in] name     Name used by clients to connect to the server.
+     * @param[in] models   The models to host. Clients refer to them by their
+     *                     model names, which must be unique. Each evaluating
+     *                     thread uses its own copy of each model.
+     * @param[in] options  Server options.
+     *
+     * @throws std::runtime_error if the models are invalid, or if the shared
+     *         memory cannot be created (e.g. because another server with the
+     *         same name is running).
+     */
+    EvaluationServer(const std::string& name,
+                     const std::vector<CompiledModel<Scalar>>& models,
+                     const ServerOptions& options = ServerOptions());
+
+    /** Destructor. Stops the server. */
+    ~EvaluationServer();
+
+    EvaluationServer(const EvaluationServer&) = delete;
+    EvaluationServer& operator=(const EvaluationServer&) = delete;
+
+    /** Stop serving requests and remove the shared memory. Clients waiting
+     *  for a response are notified that the server has stopped. */
+    void stop();
+
+    /** Check if the server is serving requests.
+     *
+     * @returns True if the server is running, false otherwise.
+     */
+    bool is_running() const;
+
+    /** Get the name of the server.
+     *
+     * @returns The name used by clients to connect.
+     */
+    const std::string& get_name() const;
+
+    /** Get the number of requests evaluated so far.
+     *
+     * @returns The number of requests.
+     */
+    size_t get_num_requests() const;
+
+    /** Get the number of batches evaluated so far. The mean batch size is
+     *  get_num_requests() / get_num_batches().
+     *
+     * @returns The number of batches.
+     */
+    size_t get_num_batches() const;
+
+   private:
+    // How long the dispatcher sleeps between checks for shutdown
+    static const long SLEEP_TIMEOUT_NS = 10000000L;
+
+    std::string name_;
+    std::string shm_name_;
+    ServerOptions options_;
+
+    // Copies of the models for each evaluating thread
+    std::vector<std::vector<std::unique_ptr<RealtimeModel<Scalar>>>>
+        thread_models_;
+
+    protocol::Header* header_ = nullptr;
+    size_t region_size_ = 0;
+
+    std::unique_ptr<ThreadPool> pool_;
+    std::thread dispatcher_;
+    std::atomic<bool> stopping_;
+    bool stopped_ = false;
+
+    // Slot to start polling from
+    size_t next_slot_ = 0;
+
+    // Requests of the current batch
+    std::vector<protocol::EntryHeader*> batch_;
+
+    std::atomic<size_t> num_requests_;
+    std::atomic<size_t> num_batches_;
+
+    // Create and initialize the shared memory region.
+    void create_shared_memory(const std::vector<CompiledModel<Scalar>>& models);
+
+    // Main loop of the dispatching thread.
+    void run();
+
+    // Pick up submitted requests from the client slots, adding them to the
+    // batch.
+    void collect();
+
+    // Evaluate the requests [begin, end) of the batch.
+    void process(size_t begin, size_t end, size_t thread_index);
+};  // class EvaluationServer
+
+#include "impl/EvaluationServer.tpp"
+
+}  // namespace CppADCodeGenEigenPy
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <Eigen/Eigen>
+#include <cppad/cg.hpp>
+
+#include <CppADCodeGenEigenPy/CompiledModel.h>
+
+namespace CppADCodeGenEigenPy {
+
+/** Compiled model with input, output, and parameter sizes fixed at compile
+ *  time.
+ *
+ * Inputs and outputs are fixed-size Eigen types, which live on the stack, so
+ * evaluating the model does not allocate and calling the overload for the
+ * wrong number of parameters fails to compile. The sizes of the loaded model
+ * are checked against the template arguments once, at construction.
+ *
+ * @tparam Scalar     The scalar type to use. Typically float or double.
+ * @tparam NumInput   The size of the model input, excluding parameters.
+ * @tparam NumOutput  The size of the model output.
+ * @tparam NumParam   The number of model parameters.
+ */
+template <typename Scalar, int NumInput, int NumOutput, int NumParam = 0>
+class FixedSizeCompiledModel {
+    static_assert(NumInput > 0, "Model must have at least one input.");
+    static_assert(NumOutput > 0, "Model must have at least one output.");
+    static_assert(NumParam >= 0, "Number of parameters cannot be negative.");
+
+    // Eigen does not allow row-major storage for column vectors
+    template <int Rows, int Cols>
+    using RowMajorMatrix =
+        Eigen::Matrix<Scalar, Rows, Cols,
+                      Cols == 1 ? Eigen::ColMajor : Eigen::RowMajor>;
+
+   public:
+    using Input = Eigen::Matrix<Scalar, NumInput, 1>;
+    using Parameters = Eigen::Matrix<Scalar, NumParam, 1>;
+    using Output = Eigen::Matrix<Scalar, NumOutput, 1>;
+    using Jacobian = RowMajorMatrix<NumOutput, NumInput>;
+    using Hessian = RowMajorMatrix<NumInput, NumInput>;
+
+    /** Constructor.
+     *
+     * @param[in] model_name  Name of model to load.
+     * @param[in] library_generic_path  Path to the compiled shared library
+     *                                  without the file extension.
+     *
+     * @throws std::runtime_error if the model's sizes do not match the
+     *         template arguments.
+     */
+    FixedSizeCompiledModel(const std::string& model_name,
+                           const std::string& library_generic_path);
+
+    /** Evaluate the function. This overload can only be used if the modelled
+     *  function has no parameters.
+     *
+     * @param[in] input  The input at which to evaluate the function.
+     *
+     * @returns The function output.
+     */
+    Output evaluate(const Input& input) const;
+
+    /** Evaluate the function. This overload can only be used if the modelled
+     *  function has parameters.
+     *
+     * @param[in] input       The input at which to evaluate the function.
+     * @param[in] parameters  The parameters for the function.
+     *
+     * @returns The function output.
+     */
+    Output evaluate(const Input& input, const Parameters& parameters) const;
+
+    /** Compute the function's Jacobian. This overload can only be used if the
+     *  modelled function has no parameters.
+     *
+     * @param[in] input  The input at which to evaluate the Jacobian.
+     *
+     * @returns The Jacobian matrix.
+     */
+    Jacobian jacobian(const Input& input) const;
+
+    /** Compute the function's Jacobian. This overload can only be used if the
+     *  modelled function has parameters.
+     *
+     * @param[in] input       The input at which to evaluate the Jacobian.
+     * @param[in] parameters  The parameters for the function.
+     *
+     * @returns The Jacobian matrix, with respect to the input only.
+     */
+    Jacobian jacobian(const Input& input, const Parameters& parameters) const;
+
+    /** Compute the function's Hessian for a given output dimension. This
+     *  overload can only be used if the modelled function has no parameters.
+     *
+     * @param[in] input       The input at which to evaluate the Hessian.
+     * @param[in] output_dim  The output dimension for which to evaluate the
+     *                        Hessian.
+     *
+     * @returns The Hessian matrix.
+     */
+    Hessian hessian(const Input& input, size_t output_dim = 0) const;
+
+    /** Compute the function's Hessian for a given output dimension. This
+     *  overload can only be used if the modelled function has parameters.
+     *
+     * @param[in] input       The input at which to evaluate the Hessian.
+     * @param[in] parameters  The parameters for the function.
+     * @param[in] output_dim  The output dimension for which to evaluate the
+     *                        Hessian.
+     *
+     * @returns The Hessian matrix, with respect to the input only.
+     */
+    Hessian hessian(const Input& input, const Parameters& parameters,
+                    size_t output_dim = 0) const;
+
+    /** Get the underlying dynamically-sized compiled model.
+     *
+     * @returns The compiled model.
+     */
+    const CompiledModel<Scalar>& get_compiled_model() const;
+
+   private:
+    static const int NumCombined = NumInput + NumParam;
+    using CombinedInput = Eigen::Matrix<Scalar, NumCombined, 1>;
+
+    CompiledModel<Scalar> model_;
+    bool jacobian_available_;
+    bool hessian_available_;
+
+    // Models compiled with multithreading or a symmetric Hessian only have
+    // the sparse kernels, which compute this many elements
+    bool sparse_jacobian_ = false;
+    bool sparse_hessian_ = false;
+    size_t jacobian_nnz_ = 0;
+    size_t hessian_nnz_ = 0;
+
+    CombinedInput combine(const Input& input,
+                          const Parameters& parameters) const;
+
+    Output evaluate_combined(const CombinedInput& xp) const;
+    Jacobian jacobian_combined(const CombinedInput& xp) const;
+    Hessian hessian_combined(const CombinedInput& xp, size_t output_dim) const;
+};  // class FixedSizeCompiledModel
+
+#include "impl/FixedSizeCompiledModel.tpp"
+
+}  // namespace CppADCodeGenEigenPy
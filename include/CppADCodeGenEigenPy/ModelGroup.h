@@ -0,0 +1,132 @@
+#pragma once
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <Eigen/Eigen>
+
+#include <CppADCodeGenEigenPy/CompiledModel.h>
+#include <CppADCodeGenEigenPy/ThreadPool.h>
+
+namespace CppADCodeGenEigenPy {
+
+/** A group of compiled models evaluated together on a shared input.
+ *
+ * Each member model takes its input (including its parameters) from a
+ * subset of the elements of a single flat input vector, given by a list of
+ * indices. A single call evaluates every member and its requested
+ * derivatives, optionally running the members in parallel.
+ *
+ * A ModelGroup keeps its own copy of each member model, but a single group
+ * should not be used from multiple threads at once.
+ *
+ * @tparam Scalar  The scalar type to use. Typically float or double.
+ */
+template <typename Scalar>
+class ModelGroup {
+   public:
+    using Vector = typename CompiledModel<Scalar>::Vector;
+    using Matrix = typename CompiledModel<Scalar>::Matrix;
+
+    /** Results for a single member model. Derivatives are with respect to
+     *  the member's own input vector, including its parameters. */
+    struct Result {
+        /** Name of the member. */
+        std::string name;
+
+        /** Value of the function. */
+        Vector value;
+
+        /** Jacobian, if requested; otherwise empty. */
+        Matrix jacobian;
+
+        /** Hessians of the requested output dimensions, in the order they
+         *  were requested. */
+        std::vector<Matrix> hessians;
+    };
+
+    /** Constructor.
+     *
+     * @param[in] input_size   The size of the flat input vector.
+     * @param[in] num_threads  The number of threads used to evaluate the
+     *                         members. If zero, the number of hardware
+     *                         threads is used.
+     */
+    explicit ModelGroup(size_t input_size, size_t num_threads = 1);
+
+    /** Add a member model to the group.
+     *
+     * @param[in] name             Name of the member, used to identify its
+     *                             results. It must be unique in the group.
+     * @param[in] model            The compiled model. It is copied.
+     * @param[in] input_indices    For each element of the model's input
+     *                             (including parameters), its index in the
+     *                             flat input vector.
+     * @param[in] jacobian         Compute the Jacobian of the member.
+     * @param[in] hessian_outputs  Output dimensions of the member for which
+     *                             to compute the Hessian.
+     *
+     * @throws std::runtime_error if the group already has a member with the
+     * name, if the indices do not match the model input size or exceed the
+     * flat input size, or if an output dimension exceeds the model output
+     * size.
+     */
+    void add_model(const std::string& name, const CompiledModel<Scalar>& model,
+                   const std::vector<size_t>& input_indices,
+                   bool jacobian = false,
+                   const std::vector<size_t>& hessian_outputs = {});
+
+    /** Evaluate all member models and their requested derivatives.
+     *
+     * @param[in] input  The flat input vector.
+     *
+     * @throws std::runtime_error if the input size is wrong.
+     *
+     * @returns The results of each member, in the order the members were
+     *          added. The results remain valid until the next call.
+     */
+    const std::vector<Result>& evaluate(const Eigen::Ref<const Vector>& input);
+
+    /** Get the size of the flat input vector.
+     *
+     * @returns The size of the input.
+     */
+    size_t get_input_size() const;
+
+    /** Get the number of member models.
+     *
+     * @returns The number of members.
+     */
+    size_t get_num_models() const;
+
+    /** Get the number of threads used to evaluate the members.
+     *
+     * @returns The number of threads.
+     */
+    size_t get_num_threads() const;
+
+   private:
+    struct Member {
+        CompiledModel<Scalar> model;
+        std::vector<size_t> input_indices;
+        bool jacobian;
+        std::vector<size_t> hessian_outputs;
+
+        // Gathered input of the member
+        Vector input;
+    };
+
+    size_t input_size_;
+    std::vector<Member> members_;
+    std::vector<Result> results_;
+    std::unique_ptr<ThreadPool> pool_;
+
+    // Evaluate a single member into its results.
+    void evaluate_member(size_t index, const Eigen::Ref<const Vector>& input);
+};  // class ModelGroup
+
+#include "impl/ModelGroup.tpp"
+
+}  // namespace CppADCodeGenEigenPy
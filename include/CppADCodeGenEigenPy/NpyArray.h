@@ -0,0 +1,138 @@
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace CppADCodeGenEigenPy {
+
+/** A memory-mapped array stored in NumPy's .npy format.
+ *
+ * Only little-endian, C-ordered arrays of the given scalar type are
+ * supported. The array is viewed as a sequence of rows along its first
+ * dimension, where each row contains the product of the remaining
+ * dimensions. Pages of the mapping can be prefetched and released by row so
+ * that arrays larger than memory can be streamed through.
+ *
+ * @tparam Scalar  The scalar type of the array elements. Typically float or
+ *                 double.
+ */
+template <typename Scalar>
+class NpyArray {
+   public:
+    /** Open an existing .npy file.
+     *
+     * @param[in] path      Path to the file.
+     * @param[in] writable  Whether to map the file for writing.
+     *
+     * @throws std::runtime_error if the file cannot be opened or mapped, or
+     * if its format is not supported.
+     */
+    NpyArray(const std::string& path, bool writable = false);
+
+    /** Create a new .npy file, overwriting any existing file, and map it
+     *  for writing.
+     *
+     * @param[in] path   Path to the file.
+     * @param[in] shape  Shape of the array.
+     *
+     * @throws std::runtime_error if the file cannot be created or mapped.
+     */
+    NpyArray(const std::string& path, const std::vector<size_t>& shape);
+
+    ~NpyArray();
+
+    NpyArray(const NpyArray&) = delete;
+    NpyArray& operator=(const NpyArray&) = delete;
+
+    /** Get the shape of the array.
+     *
+     * @returns The shape of the array.
+     */
+    const std::vector<size_t>& get_shape() const;
+
+    /** Get the number of rows, i.e. the size of the first dimension. A
+     *  zero-dimensional array has one row.
+     *
+     * @returns The number of rows.
+     */
+    size_t get_rows() const;
+
+    /** Get the number of elements in each row.
+     *
+     * @returns The size of a row.
+     */
+    size_t get_row_size() const;
+
+    /** Get a pointer to the start of a row.
+     *
+     * @param[in] row  The index of the row.
+     *
+     * @returns A pointer to the row.
+     */
+    Scalar* row(size_t row);
+    const Scalar* row(size_t row) const;
+
+    /** Advise the kernel that the rows [begin, end) will be needed soon, so
+     *  that they can be read ahead asynchronously.
+     *
+     * @param[in] begin  The first row.
+     * @param[in] end    One past the last row.
+     */
+    void prefetch(size_t begin, size_t end) const;
+
+    /** Release the pages holding the rows [begin, end) from this process's
+     *  memory. Written data is scheduled to be flushed to the file first.
+     *  The rows can still be accessed afterward, in which case they are read
+     *  back from the file.
+     *
+     * @param[in] begin  The first row.
+     * @param[in] end    One past the last row.
+     */
+    void release(size_t begin, size_t end) const;
+
+   private:
+    std::string path_;
+    std::vector<size_t> shape_;
+    size_t rows_;
+    size_t row_size_;
+
+    int fd_ = -1;
+    bool writable_;
+    void* mapping_ = nullptr;
+    size_t mapping_size_ = 0;
+    size_t data_offset_ = 0;
+
+    // Map the file once it is open and the header has been parsed.
+    void map();
+
+    // Apply madvise to the pages covering the rows [begin, end).
+    void advise(size_t begin, size_t end, int advice) const;
+
+    // Parse the header of an existing file.
+    void read_header();
+
+    // Write the header of a new file.
+    void write_header();
+
+    void compute_rows();
+
+    [[noreturn]] void error(const std::string& msg);
+
+    // The .npy type descriptor for the scalar type.
+    static std::string descr();
+};  // class NpyArray
+
+#include "impl/NpyArray.tpp"
+
+}  // namespace CppADCodeGenEigenPy
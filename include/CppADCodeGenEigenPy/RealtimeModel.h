@@ -0,0 +1,200 @@
+#pragma once
+
+#include <Eigen/Eigen>
+#include <cppad/cg.hpp>
+#include <vector>
+
+#include <CppADCodeGenEigenPy/CompiledModel.h>
+
+namespace CppADCodeGenEigenPy {
+
+/** Status code returned by the real-time interface. */
+enum class Status {
+    Success,
+    InputSizeMismatch,
+    OutputSizeMismatch,
+    DerivativeUnavailable,
+    InvalidOutputDimension,
+    InvalidRequest,
+};
+
+/** Get a description of a status code.
+ *
+ * @param[in] status  The status code.
+ *
+ * @returns A static string describing the status.
+ */
+inline const char* status_description(Status status) noexcept {
+    switch (status) {
+        case Status::Success:
+            return "Success.";
+        case Status::InputSizeMismatch:
+            return "Input and parameter sizes do not match the model domain.";
+        case Status::OutputSizeMismatch:
+            return "Output buffer size does not match the model.";
+        case Status::DerivativeUnavailable:
+            return "Derivative is not available at the compiled order.";
+        case Status::InvalidOutputDimension:
+            return "Output dimension exceeds the model range.";
+        case Status::InvalidRequest:
+            return "Request does not refer to a valid model and kernel.";
+    }
+    return "Unknown status.";
+}
+
+/** Real-time interface to a compiled model, for use in hard real-time loops.
+ *
+ * All memory required to evaluate the model is allocated up front when
+ * constructing the RealtimeModel. After that, its methods never allocate or
+ * throw: errors are reported by returning a Status and results are written
+ * into buffers provided by the caller, which must already have the correct
+ * size. The exception is a model compiled with multithreading, whose
+ * generated code allocates when handing the derivative directions to its
+ * threads, so such models should not be used in real-time loops.
+ *
+ * A RealtimeModel uses its own instance of the compiled model, so it may be
+ * used concurrently with the CompiledModel it was created from. As with
+ * CompiledModel, a single RealtimeModel should not be used from multiple
+ * threads at once.
+ *
+ * @tparam Scalar  The scalar type to use. Typically float or double.
+ */
+template <typename Scalar>
+class RealtimeModel {
+   public:
+    using Vector = typename CompiledModel<Scalar>::Vector;
+    using Matrix = typename CompiledModel<Scalar>::Matrix;
+
+    /** Constructor. Allocates the workspace.
+     *
+     * @param[in] model  The compiled model to evaluate.
+     */
+    explicit RealtimeModel(const CompiledModel<Scalar>& model);
+
+    /** Evaluate the function. This overload should be called if the modelled
+     *  function has no parameters.
+     *
+     * @param[in]  input   The input at which to evaluate the function.
+     * @param[out] output  The function output.
+     *
+     * @returns Status::Success, or the reason for failure.
+     */
+    Status evaluate(const Eigen::Ref<const Vector>& input,
+                    Eigen::Ref<Vector> output) noexcept;
+
+    /** Evaluate the function. This overload should be called if the modelled
+     *  function has parameters.
+     *
+     * @param[in]  input       The input at which to evaluate the function.
+     * @param[in]  parameters  The parameters for the function.
+     * @param[out] output      The function output.
+     *
+     * @returns Status::Success, or the reason for failure.
+     */
+    Status evaluate(const Eigen::Ref<const Vector>& input,
+                    const Eigen::Ref<const Vector>& parameters,
+                    Eigen::Ref<Vector> output) noexcept;
+
+    /** Compute the function's Jacobian. This overload should be called if
+     *  the modelled function has no parameters.
+     *
+     * @param[in]  input     The input at which to evaluate the Jacobian.
+     * @param[out] jacobian  The Jacobian matrix.
+     *
+     * @returns Status::Success, or the reason for failure.
+     */
+    Status jacobian(const Eigen::Ref<const Vector>& input,
+                    Eigen::Ref<Matrix> jacobian) noexcept;
+
+    /** Compute the function's Jacobian. This overload should be called if
+     *  the modelled function has parameters.
+     *
+     * @param[in]  input       The input at which to evaluate the Jacobian.
+     * @param[in]  parameters  The parameters for the function.
+     * @param[out] jacobian    The Jacobian matrix, with respect to the input
+     *                         only.
+     *
+     * @returns Status::Success, or the reason for failure.
+     */
+    Status jacobian(const Eigen::Ref<const Vector>& input,
+                    const Eigen::Ref<const Vector>& parameters,
+                    Eigen::Ref<Matrix> jacobian) noexcept;
+
+    /** Compute the function's Hessian for a given output dimension. This
+     *  overload should be called if the modelled function has no parameters.
+     *
+     * @param[in]  input       The input at which to evaluate the Hessian.
+     * @param[in]  output_dim  The output dimension for which to evaluate the
+     *                         Hessian.
+     * @param[out] hessian     The Hessian matrix.
+     *
+     * @returns Status::Success, or the reason for failure.
+     */
+    Status hessian(const Eigen::Ref<const Vector>& input, size_t output_dim,
+                   Eigen::Ref<Matrix> hessian) noexcept;
+
+    /** Compute the function's Hessian for a given output dimension. This
+     *  overload should be called if the modelled function has parameters.
+     *
+     * @param[in]  input       The input at which to evaluate the Hessian.
+     * @param[in]  parameters  The parameters for the function.
+     * @param[in]  output_dim  The output dimension for which to evaluate the
+     *                         Hessian.
+     * @param[out] hessian     The Hessian matrix, with respect to the input
+     *                         only.
+     *
+     * @returns Status::Success, or the reason for failure.
+     */
+    Status hessian(const Eigen::Ref<const Vector>& input,
+                   const Eigen::Ref<const Vector>& parameters,
+                   size_t output_dim, Eigen::Ref<Matrix> hessian) noexcept;
+
+    /** Get the input size of the model. Note that this includes both normal
+     *  inputs and parameters.
+     *
+     * @returns The combined size of the model input and parameters.
+     */
+    size_t get_input_size() const noexcept;
+
+    /** Get the output size of the model.
+     *
+     * @returns The size of the model output.
+     */
+    size_t get_output_size() const noexcept;
+
+   private:
+    CompiledModel<Scalar> model_;
+    CppAD::cg::GenericModel<Scalar>& generic_model_;
+
+    size_t input_size_;
+    size_t output_size_;
+    bool jacobian_available_;
+    bool hessian_available_;
+
+    // Models compiled with multithreading or a symmetric Hessian only have
+    // the sparse kernels
+    bool sparse_jacobian_ = false;
+    bool sparse_hessian_ = false;
+
+    // Preallocated workspace. The dense derivatives are kept zero outside
+    // the sparsity patterns of the sparse kernels, whose elements are
+    // computed into J_nnz_ and H_nnz_.
+    Vector xp_;
+    Vector w_;
+    Vector J_vec_;
+    Vector H_vec_;
+    Vector J_nnz_;
+    Vector H_nnz_;
+
+    // Copy the input and parameters into the combined workspace vector.
+    // Returns false if their combined size does not match the model.
+    bool set_input(const Eigen::Ref<const Vector>& input,
+                   const Eigen::Ref<const Vector>& parameters) noexcept;
+
+    // Empty parameter vector, for the overloads without parameters.
+    static Eigen::Map<const Vector> no_parameters() noexcept;
+};  // class RealtimeModel
+
+#include "impl/RealtimeModel.tpp"
+
+}  // namespace CppADCodeGenEigenPy
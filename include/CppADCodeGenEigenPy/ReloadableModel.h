@@ -0,0 +1,177 @@
+#pragma once
+
+#include <unistd.h>
+
+#include <Eigen/Eigen>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <exception>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <CppADCodeGenEigenPy/CompiledModel.h>
+#include <CppADCodeGenEigenPy/Util.h>
+
+namespace CppADCodeGenEigenPy {
+
+/** A handle to a CompiledModel whose library can be replaced while it is in
+ *  use, for example after recompiling the model.
+ *
+ * The new library is loaded on a background thread and swapped in atomically
+ * between calls, so callers are never blocked by loading it. The old library
+ * is unloaded, also in the background, only once the calls that were using
+ * it have finished.
+ *
+ * Since the dynamic loader caches libraries by path, each new version of the
+ * library is copied to a unique path alongside the original before it is
+ * loaded, together with its compile report. The copy is deleted once the
+ * version is no longer in use.
+ *
+ * The evaluation methods may be called concurrently with a reload, but, as
+ * with CompiledModel, only from one thread at a time.
+ *
+ * @tparam Scalar  The scalar type to use. Typically float or double.
+ */
+template <typename Scalar>
+class ReloadableModel {
+   public:
+    using Vector = typename CompiledModel<Scalar>::Vector;
+    using Matrix = typename CompiledModel<Scalar>::Matrix;
+
+    /** Constructor. The initial version of the library is loaded on the
+     *  calling thread.
+     *
+     * @param[in] model_name  The name of the model being loaded from the
+     *                        dynamic library.
+     * @param[in] library_generic_path  The full path to the dynamic library,
+     *                                  without the file extension.
+     */
+    ReloadableModel(const std::string& model_name,
+                    const std::string& library_generic_path);
+
+    /** Destructor. Waits for any reload in progress to finish. */
+    ~ReloadableModel();
+
+    ReloadableModel(const ReloadableModel&) = delete;
+    ReloadableModel& operator=(const ReloadableModel&) = delete;
+
+    /** Start loading a new version of the library from the original path in
+     *  the background. It is swapped in once loaded, if its input and output
+     *  sizes match those of the current version.
+     *
+     * @throws std::runtime_error if a reload is already in progress.
+     */
+    void reload();
+
+    /** Start loading a new version of the library from a different path in
+     *  the background.
+     *
+     * @param[in] library_generic_path  The full path to the dynamic library,
+     *                                  without the file extension.
+     *
+     * @throws std::runtime_error if a reload is already in progress.
+     */
+    void reload(const std::string& library_generic_path);
+
+    /** Check if a reload is in progress. The reload is in progress until the
+     *  previous version has been unloaded.
+     *
+     * @returns True if a reload is in progress, false otherwise.
+     */
+    bool is_reloading() const;
+
+    /** Wait for the reload in progress, if any, to finish.
+     *
+     * @throws std::runtime_error if the last reload failed, for example
+     * because the library could not be loaded or its sizes did not match.
+     * The current version remains in use in this case.
+     */
+    void wait();
+
+    /** Get the number of times a new version has been swapped in.
+     *
+     * @returns The version number, which is 0 for the initial version.
+     */
+    size_t get_version() const;
+
+    /** Get the current version of the model. The previous version is kept
+     *  loaded after a reload until all pointers to it are released, so this
+     *  should only be held for the duration of a call. Versions loaded by
+     *  a reload report the path of the copy they were loaded from as their
+     *  library path.
+     *
+     * @returns The current version of the model.
+     */
+    std::shared_ptr<const CompiledModel<Scalar>> get_model() const;
+
+    /** Evaluate the function using the current version of the model. See
+     *  CompiledModel::evaluate. */
+    Vector evaluate(const Eigen::Ref<const Vector>& input) const;
+
+    /** Evaluate the function with parameters using the current version of
+     *  the model. See CompiledModel::evaluate. */
+    Vector evaluate(const Eigen::Ref<const Vector>& input,
+                    const Eigen::Ref<const Vector>& parameters) const;
+
+    /** Compute the Jacobian using the current version of the model. See
+     *  CompiledModel::jacobian. */
+    Matrix jacobian(const Eigen::Ref<const Vector>& input) const;
+
+    /** Compute the Jacobian with parameters using the current version of
+     *  the model. See CompiledModel::jacobian. */
+    Matrix jacobian(const Eigen::Ref<const Vector>& input,
+                    const Eigen::Ref<const Vector>& parameters) const;
+
+    /** Compute a Hessian using the current version of the model. See
+     *  CompiledModel::hessian. */
+    Matrix hessian(const Eigen::Ref<const Vector>& input,
+                   size_t output_dim = 0) const;
+
+    /** Compute a Hessian with parameters using the current version of the
+     *  model. See CompiledModel::hessian. */
+    Matrix hessian(const Eigen::Ref<const Vector>& input,
+                   const Eigen::Ref<const Vector>& parameters,
+                   size_t output_dim = 0) const;
+
+    /** Get the input size of the model, including parameters. This is the
+     *  same for all versions. */
+    size_t get_input_size() const;
+
+    /** Get the output size of the model. This is the same for all
+     *  versions. */
+    size_t get_output_size() const;
+
+   private:
+    // Load a new version and swap it in, then wait for the old version to
+    // be released. Runs on the reload thread.
+    void load(const std::string& library_generic_path);
+
+    // Delete a copy of the library and its compile report.
+    static void remove_copy(const std::string& copy_path);
+
+    std::string model_name_;
+    std::string library_generic_path_;
+    size_t input_size_;
+    size_t output_size_;
+
+    // Only accessed atomically, since it is replaced while callers read it
+    std::shared_ptr<const CompiledModel<Scalar>> model_;
+
+    // Path of the copy of the library the current version was loaded from,
+    // or empty if it was loaded from the original path
+    std::string copy_path_;
+    size_t num_copies_ = 0;
+
+    std::thread reload_thread_;
+    std::atomic<bool> reloading_{false};
+    std::atomic<bool> stopping_{false};
+    std::atomic<size_t> version_{0};
+    std::exception_ptr error_;
+};
+
+#include "impl/ReloadableModel.tpp"
+
+}  // namespace CppADCodeGenEigenPy
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <Eigen/Eigen>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <CppADCodeGenEigenPy/CompiledModel.h>
+#include <CppADCodeGenEigenPy/RealtimeModel.h>
+#include <CppADCodeGenEigenPy/ThreadPool.h>
+
+namespace CppADCodeGenEigenPy {
+
+/** Built-in integration schemes for RolloutEngine. */
+enum class Integrator {
+    /** Explicit Euler: x' = x + dt * f(x, u). */
+    Euler,
+
+    /** Classical fourth-order Runge-Kutta, holding the control constant over
+     *  the step. */
+    RK4,
+};
+
+/** Simulates many environments in parallel using a compiled model of
+ *  continuous-time dynamics.
+ *
+ * The model's input is the state followed by the control input, and its
+ * parameters (if any) are per-environment or shared constants such as masses.
+ * With the built-in integrators, the model's output must be the time
+ * derivative of the state. Other schemes, such as ones that keep a quaternion
+ * part of the state normalized or models that only output accelerations, can
+ * be supplied as a custom step function.
+ *
+ * Environments are split over a pool of threads, each of which uses its own
+ * copy of the model. A single RolloutEngine should not be used from multiple
+ * threads at once.
+ *
+ * @tparam Scalar  The scalar type to use. Typically float or double.
+ */
+template <typename Scalar>
+class RolloutEngine {
+   public:
+    using Vector = typename CompiledModel<Scalar>::Vector;
+    using Matrix = typename CompiledModel<Scalar>::Matrix;
+
+    /** Evaluates the model for the current environment at a state and
+     *  control input, writing its output. */
+    using Dynamics = std::function<void(const Eigen::Ref<const Vector>& state,
+                                        const Eigen::Ref<const Vector>& control,
+                                        Eigen::Ref<Vector> output)>;
+
+    /** Advances a state by one time step of length dt, with the control held
+     *  constant. The function is called concurrently from multiple threads.
+     */
+    using StepFunction = std::function<void(
+        const Dynamics& dynamics, const Eigen::Ref<const Vector>& state,
+        const Eigen::Ref<const Vector>& control, Scalar dt,
+        Eigen::Ref<Vector> next_state)>;
+
+    /** Constructor for a built-in integrator.
+     *
+     * @param[in] model         The compiled dynamics model.
+     * @param[in] state_size    The size of the state.
+     * @param[in] control_size  The size of the control input.
+     * @param[in] integrator    The integration scheme.
+     * @param[in] num_threads   The number of threads. If zero, the number of
+     *                          hardware threads is used.
+     *
+     * @throws std::runtime_error if the sizes do not match the model.
+     */
+    RolloutEngine(const CompiledModel<Scalar>& model, size_t state_size,
+                  size_t control_size, Integrator integrator,
+                  size_t num_threads = 0);
+
+    /** Constructor for a custom integration scheme.
+     *
+     * @param[in] model         The compiled dynamics model.
+     * @param[in] state_size    The size of the state.
+     * @param[in] control_size  The size of the control input.
+     * @param[in] step          Function advancing the state by one step.
+     * @param[in] num_threads   The number of threads. If zero, the number of
+     *                          hardware threads is used.
+     *
+     * @throws std::runtime_error if the sizes do not match the model.
+     */
+    RolloutEngine(const CompiledModel<Scalar>& model, size_t state_size,
+                  size_t control_size, const StepFunction& step,
+                  size_t num_threads = 0);
+
+    /** Roll out N environments for K steps each.
+     *
+     * @param[in]  initial_states  The initial state of each environment,
+     *                             with shape (N, state_size).
+     * @param[in]  controls        The controls of each environment, with
+     *                             shape (N, K * control_size): row i holds
+     *                             the controls of environment i for each step
+     *                             in turn.
+     * @param[in]  dt              The length of each step.
+     * @param[out] trajectories    The state of each environment after each
+     *                             step, with shape (N, K * state_size), laid
+     *                             out like the controls. This is the
+     *                             row-major (N, K, state_size) array of
+     *                             states.
+     * @param[in]  parameters      The model parameters, with shape (N, p) for
+     *                             per-environment parameters or (1, p) for
+     *                             parameters shared by all environments. May
+     *                             be empty if the model has no parameters.
+     *
+     * @throws std::runtime_error if the shapes are inconsistent, or if
+     *         evaluating the model fails.
+     */
+    void rollout(const Eigen::Ref<const Matrix>& initial_states,
+                 const Eigen::Ref<const Matrix>& controls, Scalar dt,
+                 Eigen::Ref<Matrix> trajectories,
+                 const Eigen::Ref<const Matrix>& parameters = Matrix());
+
+    /** Get the size of the state.
+     *
+     * @returns The state size.
+     */
+    size_t get_state_size() const;
+
+    /** Get the size of the control input.
+     *
+     * @returns The control size.
+     */
+    size_t get_control_size() const;
+
+    /** Get the number of model parameters.
+     *
+     * @returns The parameter size.
+     */
+    size_t get_parameter_size() const;
+
+    /** Get the number of threads.
+     *
+     * @returns The number of threads.
+     */
+    size_t get_num_threads() const;
+
+   private:
+    // Model and workspace of each thread
+    struct Worker {
+        std::unique_ptr<RealtimeModel<Scalar>> model;
+        Vector input;  // (state, control, parameters)
+    };
+
+    size_t state_size_;
+    size_t control_size_;
+    size_t parameter_size_;
+    StepFunction step_;
+
+    std::unique_ptr<ThreadPool> pool_;
+    std::vector<Worker> workers_;
+
+    // Create the workers and check the sizes against the model.
+    void init(const CompiledModel<Scalar>& model);
+
+    // Roll out the environments [begin, end) on the given thread.
+    void rollout_range(size_t begin, size_t end, size_t thread_index,
+                       const Eigen::Ref<const Matrix>& initial_states,
+                       const Eigen::Ref<const Matrix>& controls, Scalar dt,
+                       Eigen::Ref<Matrix> trajectories,
+                       const Eigen::Ref<const Matrix>& parameters);
+
+    // Built-in integration schemes.
+    static void euler_step(const Dynamics& dynamics,
+                           const Eigen::Ref<const Vector>& state,
+                           const Eigen::Ref<const Vector>& control, Scalar dt,
+                           Eigen::Ref<Vector> next_state);
+    static void rk4_step(const Dynamics& dynamics,
+                         const Eigen::Ref<const Vector>& state,
+                         const Eigen::Ref<const Vector>& control, Scalar dt,
+                         Eigen::Ref<Vector> next_state);
+};  // class RolloutEngine
+
+#include "impl/RolloutEngine.tpp"
+
+}  // namespace CppADCodeGenEigenPy
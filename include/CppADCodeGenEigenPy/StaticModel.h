@@ -0,0 +1,131 @@
+#pragma once
+
+#include <stdexcept>
+#include <string>
+
+#include <Eigen/Eigen>
+#include <cppad/cg.hpp>
+
+namespace CppADCodeGenEigenPy {
+
+/** Model whose generated code is linked statically into the program.
+ *
+ * The kernels of the model are generated and compiled at build time by the
+ * `cppadcg_add_model` CMake function (see cmake/CppADCodeGenEigenPy.cmake),
+ * which also generates the Kernels type for the model. The generated code is
+ * called directly rather than through a dynamically-loaded library, so it can
+ * be inlined into the caller with link-time optimization.
+ *
+ * The interface is the same as that of CompiledModel. Derivatives not
+ * generated for the model cannot be called: doing so is a compile error.
+ *
+ * @tparam Kernels  The generated kernels of the model.
+ */
+template <typename Kernels>
+class StaticModel {
+   public:
+    using Scalar = typename Kernels::Scalar;
+
+    /** Dynamic vector type. */
+    using Vector = Eigen::Matrix<Scalar, Eigen::Dynamic, 1>;
+
+    /** Dynamic matrix type. */
+    // Row major to match the generated code and numpy
+    using Matrix =
+        Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+    /** Constructor. */
+    StaticModel();
+
+    /** Evaluate the function. This overload should be called if the modelled
+     *  function has no parameters.
+     *
+     * @param[in] input  The input at which to evaluate the function.
+     *
+     * @returns The function output.
+     */
+    Vector evaluate(const Eigen::Ref<const Vector>& input) const;
+
+    /** Evaluate the function. This overload should be called if the modelled
+     *  function has parameters.
+     *
+     * @param[in] input       The input at which to evaluate the function.
+     * @param[in] parameters  The parameters for the function.
+     *
+     * @returns The function output.
+     */
+    Vector evaluate(const Eigen::Ref<const Vector>& input,
+                    const Eigen::Ref<const Vector>& parameters) const;
+
+    /** Compute the function's Jacobian. This overload should be called if
+     *  the modelled function has no parameters.
+     *
+     * @param[in] input  The input at which to evaluate the Jacobian.
+     *
+     * @returns The Jacobian matrix.
+     */
+    Matrix jacobian(const Eigen::Ref<const Vector>& input) const;
+
+    /** Compute the function's Jacobian. This overload should be called if
+     *  the modelled function has parameters.
+     *
+     * @param[in] input       The input at which to evaluate the Jacobian.
+     * @param[in] parameters  The parameters for the function.
+     *
+     * @returns The Jacobian matrix, with respect to the input only.
+     */
+    Matrix jacobian(const Eigen::Ref<const Vector>& input,
+                    const Eigen::Ref<const Vector>& parameters) const;
+
+    /** Compute the function's Hessian for a given output dimension. This
+     *  overload should be called if the modelled function has no parameters.
+     *
+     * @param[in] input       The input at which to evaluate the Hessian.
+     * @param[in] output_dim  The output dimension for which to evaluate the
+     *                        Hessian.
+     *
+     * @returns The Hessian matrix.
+     */
+    Matrix hessian(const Eigen::Ref<const Vector>& input,
+                   size_t output_dim = 0) const;
+
+    /** Compute the function's Hessian for a given output dimension. This
+     *  overload should be called if the modelled function has parameters.
+     *
+     * @param[in] input       The input at which to evaluate the Hessian.
+     * @param[in] parameters  The parameters for the function.
+     * @param[in] output_dim  The output dimension for which to evaluate the
+     *                        Hessian.
+     *
+     * @returns The Hessian matrix, with respect to the input only.
+     */
+    Matrix hessian(const Eigen::Ref<const Vector>& input,
+                   const Eigen::Ref<const Vector>& parameters,
+                   size_t output_dim = 0) const;
+
+    /** Get the input size of the model. Note that this includes both normal
+     *  inputs and parameters.
+     *
+     * @returns The combined size of the model input and parameters.
+     */
+    size_t get_input_size() const;
+
+    /** Get the output size of the model.
+     *
+     * @returns The size of the model output.
+     */
+    size_t get_output_size() const;
+
+   private:
+    size_t input_size_;
+    size_t output_size_;
+
+    void check_input_size(size_t size) const;
+
+    void check_input_size_with_params(size_t input_size,
+                                      size_t param_size) const;
+};  // class StaticModel
+
+#include "impl/StaticModel.tpp"
+
+}  // namespace CppADCodeGenEigenPy
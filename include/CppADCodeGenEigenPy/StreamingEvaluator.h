@@ -0,0 +1,88 @@
+#pragma once
+
+#include <unistd.h>
+
+#include <Eigen/Eigen>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <CppADCodeGenEigenPy/CompiledModel.h>
+#include <CppADCodeGenEigenPy/NpyArray.h>
+#include <CppADCodeGenEigenPy/ThreadPool.h>
+
+namespace CppADCodeGenEigenPy {
+
+/** Evaluates a CompiledModel over datasets stored as memory-mapped .npy
+ *  files, which may be larger than memory.
+ *
+ * The dataset is processed in chunks of rows. The rows of each chunk are
+ * split over a pool of worker threads, while the next chunk is read ahead
+ * from disk. Once a chunk is done, its pages are released, so that memory use
+ * stays bounded regardless of the size of the dataset.
+ *
+ * @tparam Scalar  The scalar type to use. Typically float or double.
+ */
+template <typename Scalar>
+class StreamingEvaluator {
+   public:
+    using Vector = typename CompiledModel<Scalar>::Vector;
+    using Matrix = typename CompiledModel<Scalar>::Matrix;
+
+    /** Constructor.
+     *
+     * @param[in] model        The model to evaluate. Each worker thread uses
+     *                         its own copy.
+     * @param[in] num_threads  The number of worker threads. If zero, the
+     *                         number of hardware threads is used.
+     * @param[in] chunk_size   The number of rows per chunk. If zero, the
+     *                         chunk size is chosen so that the data for each
+     *                         thread fits in its L2 cache.
+     */
+    StreamingEvaluator(const CompiledModel<Scalar>& model,
+                       size_t num_threads = 0, size_t chunk_size = 0);
+
+    /** Evaluate the model over a dataset.
+     *
+     * @param[in] input_path       Path to a .npy file of shape (N, n)
+     *                             containing an input in each row.
+     * @param[in] output_path      Path to the .npy file of shape (N, m) to
+     *                             create for the outputs.
+     * @param[in] jacobian_path    Path to the .npy file of shape (N, m, n) to
+     *                             create for the Jacobians. If empty, the
+     *                             Jacobians are not computed.
+     * @param[in] parameters_path  Path to a .npy file containing parameters,
+     *                             either of shape (N, p) for per-row
+     *                             parameters or of shape (p,) for parameters
+     *                             shared by all rows. If empty, the model is
+     *                             evaluated without parameters.
+     *
+     * @throws std::runtime_error if a file cannot be read or written, or if
+     * the shapes of the input and parameters do not match the model.
+     */
+    void evaluate(const std::string& input_path,
+                  const std::string& output_path,
+                  const std::string& jacobian_path = "",
+                  const std::string& parameters_path = "");
+
+    /** Get the number of worker threads.
+     *
+     * @returns The number of threads.
+     */
+    size_t get_num_threads() const;
+
+   private:
+    ThreadPool pool_;
+
+    // One copy of the model for each thread
+    std::vector<CompiledModel<Scalar>> models_;
+
+    size_t chunk_size_;
+
+    // Choose the chunk size for rows of the given size in bytes.
+    size_t compute_chunk_size(size_t row_bytes) const;
+};  // class StreamingEvaluator
+
+#include "impl/StreamingEvaluator.tpp"
+
+}  // namespace CppADCodeGenEigenPy
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <CppADCodeGenEigenPy/Util.h>
+
+namespace CppADCodeGenEigenPy {
+
+/** A fixed-size pool of worker threads for data-parallel work.
+ *
+ * The pool splits a range of indices into contiguous chunks, one per thread.
+ * The calling thread processes the first chunk itself, so a pool of one
+ * thread runs everything on the calling thread.
+ */
+class ThreadPool {
+   public:
+    /** Function processing the indices [begin, end) on the given thread. */
+    using RangeFunction =
+        std::function<void(size_t begin, size_t end, size_t thread_index)>;
+
+    /** Constructor.
+     *
+     * @param[in] num_threads  The number of threads, including the calling
+     *                         thread. If zero, the number of hardware
+     *                         threads is used.
+     * @param[in] cpus         CPUs to pin the worker threads to: the thread
+     *                         with index i is pinned to cpus[i % size]. The
+     *                         calling thread (index 0) is not pinned by the
+     *                         pool. If empty, no threads are pinned.
+     */
+    explicit ThreadPool(size_t num_threads = 0,
+                        const std::vector<int>& cpus = std::vector<int>());
+
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /** Process the indices [0, n) in parallel, blocking until all threads
+     *  are done. Only one call may be active at a time.
+     *
+     * @param[in] n   The number of indices.
+     * @param[in] fn  The function to apply to each chunk of indices.
+     *
+     * @throws The first exception thrown by any of the threads.
+     */
+    void parallel_for(size_t n, const RangeFunction& fn);
+
+    /** Get the number of threads, including the calling thread.
+     *
+     * @returns The number of threads.
+     */
+    size_t get_num_threads() const;
+
+   private:
+    std::vector<std::thread> workers_;
+    size_t num_threads_;
+    std::vector<int> cpus_;
+
+    std::mutex mutex_;
+    std::condition_variable work_cv_;
+    std::condition_variable done_cv_;
+
+    // Current job; generation_ is incremented for each new job
+    const RangeFunction* fn_ = nullptr;
+    size_t n_ = 0;
+    size_t generation_ = 0;
+    size_t num_pending_ = 0;
+    bool stop_ = false;
+    std::exception_ptr error_;
+
+    void worker_loop(size_t thread_index);
+
+    // Run the chunk of the current job belonging to a thread, recording any
+    // exception.
+    void run_chunk(const RangeFunction& fn, size_t n, size_t thread_index);
+};  // class ThreadPool
+
+#include "impl/ThreadPool.tpp"
+
+}  // namespace CppADCodeGenEigenPy
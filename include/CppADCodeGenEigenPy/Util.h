@@ -1,7 +1,22 @@
 #pragma once
 
+#include <ftw.h>
+#include <link.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
 #include <cppad/cg.hpp>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <utility>
+#include <vector>
 
 // TODO comment these
 
@@ -16,6 +31,151 @@ inline std::string get_library_real_path(const std::string& model_name,
     return get_library_generic_path(model_name, directory_path) + ext;
 }
 
+// The compile report of a library is saved alongside it.
+inline std::string get_compile_report_path(
+    const std::string& library_generic_path) {
+    return library_generic_path + ".report";
+}
+
+// Make a path absolute by prepending the current working directory if it is
+// relative. Unlike realpath, the path does not need to exist.
+inline std::string get_absolute_path(const std::string& path) {
+    if (path.empty() || path[0] == '/') {
+        return path;
+    }
+    char cwd[4096];
+    if (getcwd(cwd, sizeof(cwd)) == nullptr) {
+        throw std::runtime_error("Failed to get current working directory.");
+    }
+    return std::string(cwd) + "/" + path;
+}
+
+// Get the address and size of each segment of a loaded shared library, found
+// by comparing the canonical path of each loaded object to that of the
+// library.
+inline std::vector<std::pair<const char*, size_t>> get_library_segments(
+    const std::string& path) {
+    struct Search {
+        std::string path;
+        std::vector<std::pair<const char*, size_t>> segments;
+    } search;
+
+    char* real_path = realpath(path.c_str(), nullptr);
+    if (real_path == nullptr) {
+        throw std::runtime_error("Failed to resolve path " + path + ".");
+    }
+    search.path = real_path;
+    free(real_path);
+
+    dl_iterate_phdr(
+        [](struct dl_phdr_info* info, size_t, void* data) {
+            Search* search = static_cast<Search*>(data);
+            char* real_path = realpath(info->dlpi_name, nullptr);
+            if (real_path == nullptr) {
+                return 0;
+            }
+            const bool match = search->path == real_path;
+            free(real_path);
+            if (!match) {
+                return 0;
+            }
+            for (int i = 0; i < info->dlpi_phnum; ++i) {
+                const ElfW(Phdr)& header = info->dlpi_phdr[i];
+                if (header.p_type == PT_LOAD) {
+                    search->segments.emplace_back(
+                        reinterpret_cast<const char*>(info->dlpi_addr +
+                                                      header.p_vaddr),
+                        header.p_memsz);
+                }
+            }
+            return 1;
+        },
+        &search);
+    return search.segments;
+}
+
+// 64-bit FNV-1a hash of the contents of a file, as a hex string.
+inline std::string hash_file(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Failed to open " + path + " for hashing.");
+    }
+    uint64_t hash = 0xcbf29ce484222325ull;
+    char buffer[1 << 16];
+    while (in) {
+        in.read(buffer, sizeof(buffer));
+        for (std::streamsize i = 0; i < in.gcount(); ++i) {
+            hash ^= static_cast<unsigned char>(buffer[i]);
+            hash *= 0x100000001b3ull;
+        }
+    }
+    std::ostringstream ss;
+    ss << std::hex << std::setw(16) << std::setfill('0') << hash;
+    return ss.str();
+}
+
+// Name of the model within the library that computes a single Jacobian
+// block. Segment names cannot contain a double underscore or begin or end
+// with an underscore, so the block can be recovered from the name.
+inline std::string get_jacobian_block_model_prefix(
+    const std::string& model_name) {
+    return model_name + "__jacobian_block__";
+}
+
+inline std::string get_jacobian_block_model_name(
+    const std::string& model_name, const std::string& output_segment,
+    const std::string& input_segment) {
+    return get_jacobian_block_model_prefix(model_name) + output_segment +
+           "__" + input_segment;
+}
+
+// Name of the model within the library that computes the derivatives with
+// respect to the parameters.
+inline std::string get_parameter_model_name(const std::string& model_name) {
+    return model_name + "__parameters";
+}
+
+// Recursively remove a directory, if it exists.
+inline void remove_directory(const std::string& path) {
+    nftw(
+        path.c_str(),
+        [](const char* file, const struct stat*, int, struct FTW*) {
+            return std::remove(file);
+        },
+        16, FTW_DEPTH | FTW_PHYS);
+}
+
+// Copy a file, replacing the destination if it exists. The destination is
+// replaced atomically, so that a library that is currently loaded from it is
+// not modified underneath the process.
+inline void copy_file(const std::string& from, const std::string& to) {
+    const std::string tmp = to + ".tmp";
+    {
+        std::ifstream in(from, std::ios::binary);
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        out << in.rdbuf();
+        if (!in || !out) {
+            throw std::runtime_error("Failed to copy " + from + " to " + to +
+                                     ".");
+        }
+    }
+    if (std::rename(tmp.c_str(), to.c_str()) != 0) {
+        throw std::runtime_error("Failed to copy " + from + " to " + to + ".");
+    }
+}
+
+// Pin the calling thread to a CPU.
+inline void pin_current_thread(int cpu) {
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(cpu, &cpu_set);
+    if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) !=
+        0) {
+        throw std::runtime_error("Failed to pin thread to CPU " +
+                                 std::to_string(cpu) + ".");
+    }
+}
+
 inline void error_handler(bool known, int line, const char* file,
                           const char* exp, const char* msg) {
     throw std::runtime_error(msg);
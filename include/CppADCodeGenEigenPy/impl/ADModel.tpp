@@ -5,67 +5,449 @@ CompiledModel<Scalar> ADModel<Scalar>::compile(
     const std::string& model_name, const std::string& directory_path,
     DerivativeOrder order, bool verbose, bool save_sources,
     std::vector<std::string> compile_flags) const {
-    ADVector x = input();
-    ADVector p = parameters();
-    ADVector xp(x.rows() + p.rows());
-    xp << x, p;
+    CompileOptions options;
+    options.order = order;
+    options.verbose = verbose;
+    options.save_sources = save_sources;
+    options.compile_flags = compile_flags;
+    return compile(model_name, directory_path, options);
+}
 
-    CppAD::Independent(xp);
+template <typename Scalar>
+CompiledModel<Scalar> ADModel<Scalar>::compile(
+    const std::string& model_name, const std::string& directory_path,
+    const CompileOptions& options) const {
+    return compile_library(model_name, directory_path, options, {});
+}
 
-    // Apply the model function to get output
-    ADVector y = function(xp.head(x.rows()), xp.tail(p.rows()));
+template <typename Scalar>
+CompiledModel<Scalar> ADModel<Scalar>::compile_lazy(
+    const std::string& model_name, const std::string& directory_path,
+    const CompileOptions& options, bool background) const {
+    if (options.order == DerivativeOrder::Zero) {
+        return compile(model_name, directory_path, options);
+    }
 
-    // Record the relationship for AD
-    // It is more efficient to do:
-    //   ADFun f;
-    //   f.Dependent(x, y);
-    //   f.optimize();
-    // rather than
-    //   ADFun f(x, y);
-    //   f.optimize();
-    // see <https://coin-or.github.io/CppAD/doc/optimize.htm>
-    CppAD::ADFun<ADScalarBase> ad_func;
-    ad_func.Dependent(xp, y);
+    // The function is recorded once, and the derivative library is generated
+    // from a copy of the tape, so that this model is not needed by the time
+    // it is compiled
+    std::unique_ptr<LibrarySourceGen> sources(new LibrarySourceGen());
+    record_function(*sources, model_name);
+    std::shared_ptr<LibrarySourceGen> derivative_sources(
+        new LibrarySourceGen());
+    derivative_sources->ad_func = sources->ad_func;
+    derivative_sources->input_size = sources->input_size;
+    derivative_sources->report = sources->report;
 
-    // Optimize the operation sequence
-    ad_func.optimize();
+    CompileOptions zero_order_options = options;
+    zero_order_options.order = DerivativeOrder::Zero;
+    zero_order_options.multithreading = Multithreading::None;
+    add_source_gens(*sources, model_name, DerivativeOrder::Zero,
+                    Multithreading::None, options.jacobian_mode, false, false);
+    add_source_gens(*derivative_sources, model_name, options.order,
+                    options.multithreading, options.jacobian_mode,
+                    options.symmetric_hessian, options.parameter_derivatives);
 
-    // Generate source code
-    // TODO support sparse Jacobian/Hessian
-    CppAD::cg::ModelCSourceGen<Scalar> source_gen(ad_func, model_name);
-    if (order >= DerivativeOrder::First) {
-        source_gen.setCreateJacobian(true);
-    }
-    if (order >= DerivativeOrder::Second) {
-        source_gen.setCreateHessian(true);
-    }
+    CompiledModel<Scalar> model = compile_sources(
+        *sources, model_name,
+        get_library_generic_path(model_name, directory_path),
+        zero_order_options, {});
+
+    // Generating the sources plays back the tape, so it is done here rather
+    // than on the background thread, where it would race with other uses of
+    // CppAD. For the same reason, the sources are owned by the model, which
+    // releases them on this thread, and the task only borrows them.
+    using Clock = std::chrono::steady_clock;
+    using Seconds = std::chrono::duration<double>;
+    Clock::time_point start = Clock::now();
+    derivative_sources->lib_source_gen->getModelSources();
+    derivative_sources->report.source_generation_time =
+        Seconds(Clock::now() - start).count();
+    model.derivative_sources_ = derivative_sources;
+
+    // The derivative library contains all kernels of the model, under the
+    // same model name, so the compiled model can switch to it entirely
+    const std::string derivative_path = get_library_generic_path(
+        model_name + "__derivatives", directory_path);
+    LibrarySourceGen* derivative_sources_ptr = derivative_sources.get();
+    model.derivative_model_ =
+        std::async(background ? std::launch::async : std::launch::deferred,
+                   [derivative_sources_ptr, model_name, derivative_path,
+                    options]() {
+                       return std::make_shared<CompiledModel<Scalar>>(
+                           compile_sources(*derivative_sources_ptr,
+                                           model_name, derivative_path,
+                                           options, {}));
+                   })
+            .share();
+    return model;
+}
+
+template <typename Scalar>
+std::unique_ptr<AsyncModel<Scalar>> ADModel<Scalar>::compile_async(
+    const std::string& model_name, const std::string& directory_path,
+    const CompileOptions& options) const {
+    using Clock = std::chrono::steady_clock;
+    using Seconds = std::chrono::duration<double>;
+
+    std::shared_ptr<LibrarySourceGen> sources(
+        create_library_source_gen(model_name, options.order,
+                                  options.multithreading,
+                                  options.jacobian_mode,
+                                  options.symmetric_hessian,
+                                  options.parameter_derivatives)
+            .release());
+
+    // Generating the sources plays back the tape, so it is done here rather
+    // than on the background thread, where it would race with the fallback
+    Clock::time_point start = Clock::now();
+    sources->lib_source_gen->getModelSources();
+    sources->report.source_generation_time =
+        Seconds(Clock::now() - start).count();
 
     const std::string lib_generic_path =
         get_library_generic_path(model_name, directory_path);
-    CppAD::cg::ModelLibraryCSourceGen<Scalar> lib_source_gen(source_gen);
-    CppAD::cg::GccCompiler<Scalar> compiler;
+    return std::unique_ptr<AsyncModel<Scalar>>(new AsyncModel<Scalar>(
+        model_name, sources->ad_func,
+        options.order >= DerivativeOrder::First,
+        options.order >= DerivativeOrder::Second,
+        [sources, model_name, lib_generic_path, options]() {
+            return compile_sources(*sources, model_name, lib_generic_path,
+                                   options, {});
+        }));
+}
+
+template <typename Scalar>
+CompiledModel<Scalar> ADModel<Scalar>::compile_with_profile(
+    const std::string& model_name, const std::string& directory_path,
+    const std::vector<Vector>& profile_inputs,
+    const CompileOptions& options) const {
+    // Other compilers use different profile formats
+    if (options.compiler != Compiler::GCC) {
+        throw std::runtime_error(
+            "Profile-guided optimization requires the GCC compiler.");
+    }
+
+    const std::string profile_path =
+        directory_path + "/" + model_name + "_profile";
+    remove_directory(profile_path);
+
+    std::vector<std::string> generate_flags = {"-fprofile-generate=" +
+                                               profile_path};
+    if (options.multithreading != Multithreading::None) {
+        generate_flags.push_back("-fprofile-update=atomic");
+    }
+
+    // Run the inputs through the instrumented library. The profile is
+    // written when the library is unloaded at the end of this scope, so no
+    // other copies of the model may be alive.
+    {
+        CompiledModel<Scalar> model = compile_library(
+            model_name, directory_path, options, generate_flags);
+        for (const Vector& input : profile_inputs) {
+            model.evaluate(input);
+            if (options.order >= DerivativeOrder::First) {
+                model.jacobian(input);
+            }
+            if (options.order >= DerivativeOrder::Second) {
+                model.hessian(input, 0);
+            }
+        }
+    }
+
+    // Missing or inconsistent profile data (e.g. from concurrent updates)
+    // should not fail the build
+    std::vector<std::string> use_flags = {"-fprofile-use=" + profile_path,
+                                          "-fprofile-correction"};
+    CompiledModel<Scalar> model =
+        compile_library(model_name, directory_path, options, use_flags);
+    remove_directory(profile_path);
+    return model;
+}
+
+template <typename Scalar>
+CompiledModel<Scalar> ADModel<Scalar>::autotune(
+    const std::string& model_name, const std::string& directory_path,
+    const std::vector<Vector>& sample_inputs,
+    const AutotuneOptions& options) const {
+    using Matrix = typename CompiledModel<Scalar>::Matrix;
+    using Clock = std::chrono::steady_clock;
+    using Seconds = std::chrono::duration<double>;
+
+    const DerivativeOrder order = options.compile_options.order;
+    const std::vector<CompilerConfiguration>& configurations =
+        options.configurations;
+    if (configurations.empty()) {
+        throw std::runtime_error("No compiler configurations to autotune.");
+    }
+
+    // Outputs for every sample input and derivative, concatenated
+    auto compute_results = [&](const CompiledModel<Scalar>& model) {
+        std::vector<Vector> results;
+        for (const Vector& input : sample_inputs) {
+            results.push_back(model.evaluate(input));
+            if (order >= DerivativeOrder::First) {
+                Matrix J = model.jacobian(input);
+                results.push_back(Eigen::Map<Vector>(J.data(), J.size()));
+            }
+            if (order >= DerivativeOrder::Second) {
+                Matrix H = model.hessian(input, 0);
+                results.push_back(Eigen::Map<Vector>(H.data(), H.size()));
+            }
+        }
+        return results;
+    };
+
+    struct Result {
+        std::string status;
+        double compile_time = 0;
+        double run_time = std::numeric_limits<double>::infinity();
+    };
+    std::vector<Result> results(configurations.size());
+    std::vector<Vector> reference;
+    size_t best = 0;
+
+    // Each configuration is compiled into its own directory
+    const std::string autotune_path =
+        directory_path + "/" + model_name + "_autotune";
+    remove_directory(autotune_path);
+    if (mkdir(autotune_path.c_str(), 0755) != 0) {
+        throw std::runtime_error("Failed to create directory " +
+                                 autotune_path + ".");
+    }
+    for (size_t i = 0; i < configurations.size(); ++i) {
+        Result& result = results[i];
+        const std::string config_path =
+            autotune_path + "/" + std::to_string(i);
+        if (mkdir(config_path.c_str(), 0755) != 0) {
+            throw std::runtime_error("Failed to create directory " +
+                                     config_path + ".");
+        }
+
+        CompileOptions compile_options = options.compile_options;
+        compile_options.compiler = configurations[i].compiler;
+        compile_options.compile_flags = configurations[i].compile_flags;
+
+        std::unique_ptr<CompiledModel<Scalar>> model;
+        Clock::time_point start = Clock::now();
+        try {
+            model.reset(new CompiledModel<Scalar>(compile_library(
+                model_name, config_path, compile_options, {})));
+        } catch (const std::exception& e) {
+            if (i == 0) {
+                remove_directory(autotune_path);
+                throw std::runtime_error(
+                    "Reference configuration failed to compile: " +
+                    std::string(e.what()));
+            }
+            result.status = "failed to compile";
+            continue;
+        }
+        result.compile_time = Seconds(Clock::now() - start).count();
+
+        // Check the results against the reference. This also warms up the
+        // library before timing.
+        std::vector<Vector> outputs = compute_results(*model);
+        if (i == 0) {
+            reference = outputs;
+            result.status = "reference";
+        } else {
+            bool matches = true;
+            for (size_t j = 0; j < outputs.size(); ++j) {
+                Scalar scale = 1 + reference[j].cwiseAbs().maxCoeff();
+                matches = matches &&
+                          (outputs[j] - reference[j]).cwiseAbs().maxCoeff() <=
+                              options.tolerance * scale;
+            }
+            if (!matches) {
+                result.status = "results differ from reference";
+                continue;
+            }
+            result.status = "ok";
+        }
+
+        start = Clock::now();
+        for (size_t k = 0; k < options.repetitions; ++k) {
+            compute_results(*model);
+        }
+        result.run_time =
+            Seconds(Clock::now() - start).count() / options.repetitions;
+        if (result.run_time < results[best].run_time) {
+            best = i;
+        }
+    }
+
+    // Keep the fastest library, along with its compile report
+    const std::string best_path = autotune_path + "/" + std::to_string(best);
+    copy_file(get_library_real_path(model_name, best_path),
+              get_library_real_path(model_name, directory_path));
+    copy_file(get_compile_report_path(
+                  get_library_generic_path(model_name, best_path)),
+              get_compile_report_path(
+                  get_library_generic_path(model_name, directory_path)));
+    remove_directory(autotune_path);
+
+    // Write the report
+    std::ostringstream report;
+    report << "Autotuning report for model " << model_name << "\n"
+           << "Time per run over " << sample_inputs.size()
+           << " sample inputs, up to order "
+           << static_cast<int>(order) << ".\n\n";
+    for (size_t i = 0; i < configurations.size(); ++i) {
+        const Result& result = results[i];
+        report << (i == best ? "* " : "  ") << i << ": "
+               << (configurations[i].compiler == Compiler::Clang ? "clang"
+                                                                 : "gcc");
+        for (const std::string& flag : configurations[i].compile_flags) {
+            report << " " << flag;
+        }
+        report << "\n      " << result.status;
+        if (result.compile_time > 0) {
+            report << ", compile " << std::fixed << std::setprecision(2)
+                   << result.compile_time << " s";
+        }
+        if (result.run_time < std::numeric_limits<double>::infinity()) {
+            report << ", run " << std::fixed << std::setprecision(2)
+                   << result.run_time * 1e6 << " us";
+        }
+        report << "\n";
+    }
+    report << "\nChosen configuration: " << best << "\n";
+
+    const std::string report_path =
+        get_library_generic_path(model_name, directory_path) +
+        ".autotune.txt";
+    std::ofstream report_file(report_path);
+    report_file << report.str();
+    if (!report_file) {
+        throw std::runtime_error("Failed to write autotuning report " +
+                                 report_path + ".");
+    }
+    if (options.compile_options.verbose) {
+        std::cout << report.str();
+    }
+
+    return CompiledModel<Scalar>(
+        model_name, get_library_generic_path(model_name, directory_path));
+}
+
+template <typename Scalar>
+CompiledModel<Scalar> ADModel<Scalar>::compile_library(
+    const std::string& model_name, const std::string& directory_path,
+    const CompileOptions& options,
+    const std::vector<std::string>& extra_flags) const {
+    std::unique_ptr<LibrarySourceGen> sources = create_library_source_gen(
+        model_name, options.order, options.multithreading,
+        options.jacobian_mode, options.symmetric_hessian,
+        options.parameter_derivatives);
+    return compile_sources(*sources, model_name,
+                           get_library_generic_path(model_name, directory_path),
+                           options, extra_flags);
+}
+
+template <typename Scalar>
+CompiledModel<Scalar> ADModel<Scalar>::compile_sources(
+    LibrarySourceGen& sources, const std::string& model_name,
+    const std::string& lib_generic_path, const CompileOptions& options,
+    const std::vector<std::string>& extra_flags) {
+    using Clock = std::chrono::steady_clock;
+    using Seconds = std::chrono::duration<double>;
+
+    CppAD::cg::ModelLibraryCSourceGen<Scalar>& lib_source_gen =
+        *sources.lib_source_gen;
+    CompileReport& report = sources.report;
+
+    // The sources are generated on first request and then cached, so they
+    // are generated here to time it separately from compilation. They may
+    // already have been generated, in which case that time was recorded.
+    Clock::time_point start = Clock::now();
+    for (const auto& kv : lib_source_gen.getModelSources()) {
+        report.source_sizes[kv.first] = kv.second.size();
+    }
+    report.source_generation_time += Seconds(Clock::now() - start).count();
+
+    std::unique_ptr<CppAD::cg::AbstractCCompiler<Scalar>> compiler;
+    if (options.compiler == Compiler::Clang) {
+        compiler.reset(options.compiler_path.empty()
+                           ? new CppAD::cg::ClangCompiler<Scalar>()
+                           : new CppAD::cg::ClangCompiler<Scalar>(
+                                 options.compiler_path));
+    } else {
+        compiler.reset(options.compiler_path.empty()
+                           ? new CppAD::cg::GccCompiler<Scalar>()
+                           : new CppAD::cg::GccCompiler<Scalar>(
+                                 options.compiler_path));
+    }
     CppAD::cg::DynamicModelLibraryProcessor<Scalar> lib_processor(
         lib_source_gen, lib_generic_path);
 
-    if (save_sources) {
+    if (options.save_sources) {
         CppAD::cg::SaveFilesModelLibraryProcessor<Scalar> lib_source_saver(
             lib_source_gen);
         lib_source_saver.saveSources();
     }
 
-    compiler.setCompileLibFlags(compile_flags);
-    compiler.addCompileLibFlag("-shared");
-    compiler.addCompileLibFlag("-rdynamic");
+    // The flags are needed both when compiling the sources and when linking
+    // the library
+    std::vector<std::string> flags = options.compile_flags;
+    if (options.multithreading == Multithreading::OpenMP) {
+        flags.push_back("-fopenmp");
+    } else if (options.multithreading == Multithreading::ThreadPool) {
+        flags.push_back("-pthread");
+    }
+    flags.insert(flags.end(), extra_flags.begin(), extra_flags.end());
+
+    compiler->setCompileFlags(flags);
+    compiler->setCompileLibFlags(flags);
+    compiler->addCompileLibFlag("-shared");
+    compiler->addCompileLibFlag("-rdynamic");
 
     // Compile the library
-    std::unique_ptr<CppAD::cg::DynamicLib<Scalar>> lib =
-        lib_processor.createDynamicLibrary(compiler);
-    if (verbose) {
+    start = Clock::now();
+    lib_processor.createDynamicLibrary(*compiler);
+    report.compile_time = Seconds(Clock::now() - start).count();
+
+    start = Clock::now();
+    CompiledModel<Scalar> model(model_name, lib_generic_path);
+    report.load_time = Seconds(Clock::now() - start).count();
+
+    struct stat lib_stat;
+    const std::string lib_real_path =
+        lib_generic_path +
+        CppAD::cg::system::SystemInfo<>::DYNAMIC_LIB_EXTENSION;
+    if (stat(lib_real_path.c_str(), &lib_stat) == 0) {
+        report.library_size = lib_stat.st_size;
+    }
+    report.save(get_compile_report_path(lib_generic_path));
+
+    if (options.verbose) {
         std::cout << "Compiled library for model " << model_name << " to "
-                  << get_library_real_path(model_name, directory_path)
-                  << std::endl;
+                  << lib_real_path << std::endl;
+        std::cout << report;
+    }
+    return model;
+}
+
+template <typename Scalar>
+void ADModel<Scalar>::generate_sources(const std::string& model_name,
+                                       const std::string& directory_path,
+                                       DerivativeOrder order) const {
+    std::unique_ptr<LibrarySourceGen> sources =
+        create_library_source_gen(model_name, order);
+
+    // Only the sources of the models themselves are written: the
+    // library-level sources (model listing, thread pool, etc.) are only
+    // needed when loading the library dynamically, and would clash between
+    // models linked into the same binary
+    for (const auto& kv : sources->lib_source_gen->getModelSources()) {
+        const std::string path = directory_path + "/" + kv.first;
+        std::ofstream file(path);
+        file << kv.second;
+        if (!file) {
+            throw std::runtime_error("Failed to write source file " + path +
+                                     ".");
+        }
     }
-    return CompiledModel<Scalar>(model_name, lib_generic_path);
 }
 
 template <typename Scalar>
@@ -94,3 +476,298 @@ typename ADModel<Scalar>::ADVector ADModel<Scalar>::parameters() const {
     // Default is an empty parameter vector.
     return ADVector(0);
 }
+
+template <typename Scalar>
+std::vector<Segment> ADModel<Scalar>::input_segments() const {
+    // Default is no segments.
+    return std::vector<Segment>();
+}
+
+template <typename Scalar>
+std::vector<Segment> ADModel<Scalar>::output_segments() const {
+    // Default is no segments.
+    return std::vector<Segment>();
+}
+
+template <typename Scalar>
+std::vector<typename ADModel<Scalar>::JacobianBlock>
+ADModel<Scalar>::jacobian_blocks() const {
+    // Default is every (output, input) pair of segments.
+    std::vector<JacobianBlock> blocks;
+    for (const Segment& out : output_segments()) {
+        for (const Segment& in : input_segments()) {
+            blocks.push_back(JacobianBlock(out.name, in.name));
+        }
+    }
+    return blocks;
+}
+
+template <typename Scalar>
+std::unique_ptr<typename ADModel<Scalar>::LibrarySourceGen>
+ADModel<Scalar>::create_library_source_gen(
+    const std::string& model_name, DerivativeOrder order,
+    Multithreading multithreading, JacobianMode jacobian_mode,
+    bool symmetric_hessian, bool parameter_derivatives) const {
+    std::unique_ptr<LibrarySourceGen> sources(new LibrarySourceGen());
+    record_function(*sources, model_name);
+    add_source_gens(*sources, model_name, order, multithreading,
+                    jacobian_mode, symmetric_hessian, parameter_derivatives);
+    return sources;
+}
+
+template <typename Scalar>
+void ADModel<Scalar>::record_function(LibrarySourceGen& sources,
+                                      const std::string& model_name) const {
+    using Clock = std::chrono::steady_clock;
+    using Seconds = std::chrono::duration<double>;
+
+    CompileReport& report = sources.report;
+    report.model_name = model_name;
+
+    Clock::time_point start = Clock::now();
+    ADVector x = input();
+    ADVector p = parameters();
+    ADVector xp(x.rows() + p.rows());
+    xp << x, p;
+    sources.input_size = x.rows();
+
+    // The values are only available before recording starts
+    for (Eigen::Index i = 0; i < xp.rows(); ++i) {
+        report.nominal_input.push_back(CppAD::Value(xp(i)).getValue());
+    }
+
+    CppAD::Independent(xp);
+
+    // Apply the model function to get output
+    ADVector y = function(xp.head(x.rows()), xp.tail(p.rows()));
+
+    // Record the relationship for AD
+    // It is more efficient to do:
+    //   ADFun f;
+    //   f.Dependent(x, y);
+    //   f.optimize();
+    // rather than
+    //   ADFun f(x, y);
+    //   f.optimize();
+    // see <https://coin-or.github.io/CppAD/doc/optimize.htm>
+    CppAD::ADFun<ADScalarBase>& ad_func = sources.ad_func;
+    ad_func.Dependent(xp, y);
+    report.record_time = Seconds(Clock::now() - start).count();
+    report.num_operations = ad_func.size_op();
+
+    // Optimize the operation sequence
+    start = Clock::now();
+    ad_func.optimize();
+    report.optimize_time = Seconds(Clock::now() - start).count();
+    report.num_optimized_operations = ad_func.size_op();
+}
+
+template <typename Scalar>
+void ADModel<Scalar>::add_source_gens(LibrarySourceGen& sources,
+                                      const std::string& model_name,
+                                      DerivativeOrder order,
+                                      Multithreading multithreading,
+                                      JacobianMode jacobian_mode,
+                                      bool symmetric_hessian,
+                                      bool parameter_derivatives) const {
+    CppAD::ADFun<ADScalarBase>& ad_func = sources.ad_func;
+    const size_t domain_size = ad_func.Domain();
+    const size_t range_size = ad_func.Range();
+
+    // Generate source code
+    // TODO support sparse Jacobian/Hessian
+    sources.model_source_gens.emplace_back(
+        new CppAD::cg::ModelCSourceGen<Scalar>(ad_func, model_name));
+    CppAD::cg::ModelCSourceGen<Scalar>& source_gen =
+        *sources.model_source_gens.back();
+
+    // Forward mode takes one sweep per input and reverse mode one per output
+    if (jacobian_mode == JacobianMode::Automatic) {
+        jacobian_mode = domain_size <= range_size ? JacobianMode::Forward
+                                                  : JacobianMode::Reverse;
+    }
+    source_gen.setJacobianADMode(jacobian_mode == JacobianMode::Forward
+                                     ? CppAD::cg::JacobianADMode::Forward
+                                     : CppAD::cg::JacobianADMode::Reverse);
+
+    if (multithreading == Multithreading::None) {
+        if (order >= DerivativeOrder::First) {
+            source_gen.setCreateJacobian(true);
+        }
+        if (order >= DerivativeOrder::Second && !symmetric_hessian) {
+            source_gen.setCreateHessian(true);
+        }
+    } else {
+        // CppADCodeGen only parallelizes the sparse Jacobian and Hessian
+        // when they are assembled from the directional derivative
+        // functions, which are then evaluated concurrently
+        if (order >= DerivativeOrder::First) {
+            source_gen.setCreateSparseJacobian(true);
+            source_gen.setCreateForwardOne(true);
+            source_gen.setCreateReverseOne(true);
+        }
+        if (order >= DerivativeOrder::Second) {
+            source_gen.setCreateSparseHessian(true);
+            source_gen.setCreateReverseTwo(true);
+        }
+        source_gen.setMultiThreading(true);
+    }
+
+    // The symmetric Hessian is a sparse Hessian restricted to the lower
+    // triangle, in row-major order
+    if (order >= DerivativeOrder::Second && symmetric_hessian) {
+        std::vector<size_t> rows, cols;
+        for (size_t i = 0; i < domain_size; ++i) {
+            for (size_t j = 0; j <= i; ++j) {
+                rows.push_back(i);
+                cols.push_back(j);
+            }
+        }
+        source_gen.setCreateSparseHessian(true);
+        source_gen.setCustomSparseHessianElements(rows, cols);
+    }
+
+    sources.lib_source_gen.reset(
+        new CppAD::cg::ModelLibraryCSourceGen<Scalar>(source_gen));
+    CppAD::cg::ModelLibraryCSourceGen<Scalar>& lib_source_gen =
+        *sources.lib_source_gen;
+    if (multithreading == Multithreading::OpenMP) {
+        lib_source_gen.setMultiThreading(
+            CppAD::cg::MultiThreadingType::OPENMP);
+    } else if (multithreading == Multithreading::ThreadPool) {
+        lib_source_gen.setMultiThreading(
+            CppAD::cg::MultiThreadingType::PTHREADPOOL);
+    }
+
+    // Each Jacobian block gets its own model in the library, consisting of
+    // only a sparse Jacobian with the elements of the block
+    std::vector<Segment> in_segments = input_segments();
+    std::vector<Segment> out_segments = output_segments();
+    check_segments(in_segments, sources.input_size, "input");
+    check_segments(out_segments, range_size, "output");
+
+    if (order >= DerivativeOrder::First) {
+        std::set<JacobianBlock> blocks;
+        for (const JacobianBlock& block : jacobian_blocks()) {
+            if (!blocks.insert(block).second) {
+                throw std::runtime_error("Jacobian block (" + block.first +
+                                         ", " + block.second +
+                                         ") is requested more than once.");
+            }
+            const Segment& out =
+                find_segment(out_segments, block.first, "output");
+            const Segment& in =
+                find_segment(in_segments, block.second, "input");
+
+            std::vector<size_t> rows, cols;
+            for (size_t i = out.start; i < out.start + out.size; ++i) {
+                for (size_t j = in.start; j < in.start + in.size; ++j) {
+                    rows.push_back(i);
+                    cols.push_back(j);
+                }
+            }
+
+            sources.model_source_gens.emplace_back(
+                new CppAD::cg::ModelCSourceGen<Scalar>(
+                    ad_func, get_jacobian_block_model_name(model_name, out.name,
+                                                           in.name)));
+            CppAD::cg::ModelCSourceGen<Scalar>& block_source_gen =
+                *sources.model_source_gens.back();
+            block_source_gen.setCreateForwardZero(false);
+            block_source_gen.setCreateSparseJacobian(true);
+            block_source_gen.setCustomSparseJacobianElements(rows, cols);
+            lib_source_gen.addModel(block_source_gen);
+        }
+    }
+
+    // The parameter derivatives get a model of their own, with a sparse
+    // Jacobian restricted to the parameter columns and a sparse Hessian
+    // restricted to the (parameter, input) block of the lower triangle
+    const size_t input_size = sources.input_size;
+    if (parameter_derivatives && order >= DerivativeOrder::First &&
+        domain_size > input_size) {
+        sources.model_source_gens.emplace_back(
+            new CppAD::cg::ModelCSourceGen<Scalar>(
+                ad_func, get_parameter_model_name(model_name)));
+        CppAD::cg::ModelCSourceGen<Scalar>& param_source_gen =
+            *sources.model_source_gens.back();
+        param_source_gen.setCreateForwardZero(false);
+
+        std::vector<size_t> rows, cols;
+        for (size_t i = 0; i < range_size; ++i) {
+            for (size_t j = input_size; j < domain_size; ++j) {
+                rows.push_back(i);
+                cols.push_back(j);
+            }
+        }
+        param_source_gen.setCreateSparseJacobian(true);
+        param_source_gen.setCustomSparseJacobianElements(rows, cols);
+
+        if (order >= DerivativeOrder::Second) {
+            rows.clear();
+            cols.clear();
+            for (size_t i = input_size; i < domain_size; ++i) {
+                for (size_t j = 0; j < input_size; ++j) {
+                    rows.push_back(i);
+                    cols.push_back(j);
+                }
+            }
+            param_source_gen.setCreateSparseHessian(true);
+            param_source_gen.setCustomSparseHessianElements(rows, cols);
+        }
+        lib_source_gen.addModel(param_source_gen);
+    }
+}
+
+template <typename Scalar>
+void ADModel<Scalar>::check_segments(const std::vector<Segment>& segments,
+                                     size_t size, const std::string& kind) {
+    std::set<std::string> names;
+    for (const Segment& segment : segments) {
+        // The name is used as part of a C function name in the generated
+        // code, where the segment names of a Jacobian block are joined by a
+        // double underscore. Leading and trailing underscores would make
+        // that separator ambiguous.
+        bool valid_name = !segment.name.empty() &&
+                          segment.name.find("__") == std::string::npos &&
+                          segment.name.front() != '_' &&
+                          segment.name.back() != '_';
+        for (size_t i = 0; i < segment.name.size(); ++i) {
+            unsigned char c = segment.name[i];
+            valid_name = valid_name && (std::isalnum(c) || c == '_') &&
+                         !(i == 0 && std::isdigit(c));
+        }
+        if (!valid_name) {
+            throw std::runtime_error(
+                "Invalid " + kind + " segment name '" + segment.name +
+                "': names must be valid C identifiers without a double "
+                "underscore or a leading or trailing underscore.");
+        }
+        if (!names.insert(segment.name).second) {
+            throw std::runtime_error("There is more than one " + kind +
+                                     " segment named '" + segment.name +
+                                     "'.");
+        }
+        if (segment.size == 0 || segment.start + segment.size > size) {
+            throw std::runtime_error(
+                "The " + kind + " segment '" + segment.name + "' spans [" +
+                std::to_string(segment.start) + ", " +
+                std::to_string(segment.start + segment.size) +
+                "), which is empty or exceeds the " + kind + " size " +
+                std::to_string(size) + ".");
+        }
+    }
+}
+
+template <typename Scalar>
+const Segment& ADModel<Scalar>::find_segment(
+    const std::vector<Segment>& segments, const std::string& name,
+    const std::string& kind) {
+    for (const Segment& segment : segments) {
+        if (segment.name == name) {
+            return segment;
+        }
+    }
+    throw std::runtime_error("No " + kind + " segment named '" + name +
+                             "' for Jacobian block.");
+}
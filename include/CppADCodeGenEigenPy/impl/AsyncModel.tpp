@@ -0,0 +1,196 @@
+#pragma once
+
+template <typename Scalar>
+AsyncModel<Scalar>::AsyncModel(
+    const std::string& model_name, const CppAD::ADFun<TapeScalar>& tape,
+    bool jacobian_available, bool hessian_available,
+    const std::function<CompiledModel<Scalar>()>& compile)
+    : model_name_(model_name),
+      input_size_(tape.Domain()),
+      output_size_(tape.Range()),
+      jacobian_available_(jacobian_available),
+      hessian_available_(hessian_available),
+      compile_(compile) {
+    tape_ = tape;
+    compile_thread_ = std::thread([this]() {
+        try {
+            std::shared_ptr<const CompiledModel<Scalar>> model =
+                std::make_shared<const CompiledModel<Scalar>>(compile_());
+            std::atomic_store(&model_, model);
+        } catch (...) {
+            error_ = std::current_exception();
+        }
+    });
+}
+
+template <typename Scalar>
+AsyncModel<Scalar>::~AsyncModel() {
+    if (compile_thread_.joinable()) {
+        compile_thread_.join();
+    }
+}
+
+template <typename Scalar>
+bool AsyncModel<Scalar>::is_compiled() const {
+    return get_model() != nullptr;
+}
+
+template <typename Scalar>
+void AsyncModel<Scalar>::wait() {
+    if (compile_thread_.joinable()) {
+        compile_thread_.join();
+    }
+    if (error_) {
+        std::rethrow_exception(error_);
+    }
+}
+
+template <typename Scalar>
+std::shared_ptr<const CompiledModel<Scalar>> AsyncModel<Scalar>::get_model()
+    const {
+    return std::atomic_load(&model_);
+}
+
+template <typename Scalar>
+typename AsyncModel<Scalar>::Vector AsyncModel<Scalar>::evaluate(
+    const Eigen::Ref<const Vector>& input) const {
+    std::shared_ptr<const CompiledModel<Scalar>> model = get_model();
+    return model ? model->evaluate(input) : tape_evaluate(input);
+}
+
+template <typename Scalar>
+typename AsyncModel<Scalar>::Vector AsyncModel<Scalar>::evaluate(
+    const Eigen::Ref<const Vector>& input,
+    const Eigen::Ref<const Vector>& parameters) const {
+    std::shared_ptr<const CompiledModel<Scalar>> model = get_model();
+    if (model) {
+        return model->evaluate(input, parameters);
+    }
+    Vector xp(input.size() + parameters.size());
+    xp << input, parameters;
+    return tape_evaluate(xp);
+}
+
+template <typename Scalar>
+typename AsyncModel<Scalar>::Matrix AsyncModel<Scalar>::jacobian(
+    const Eigen::Ref<const Vector>& input) const {
+    std::shared_ptr<const CompiledModel<Scalar>> model = get_model();
+    return model ? model->jacobian(input) : tape_jacobian(input);
+}
+
+template <typename Scalar>
+typename AsyncModel<Scalar>::Matrix AsyncModel<Scalar>::jacobian(
+    const Eigen::Ref<const Vector>& input,
+    const Eigen::Ref<const Vector>& parameters) const {
+    std::shared_ptr<const CompiledModel<Scalar>> model = get_model();
+    if (model) {
+        return model->jacobian(input, parameters);
+    }
+    Vector xp(input.size() + parameters.size());
+    xp << input, parameters;
+    return tape_jacobian(xp).leftCols(input.rows());
+}
+
+template <typename Scalar>
+typename AsyncModel<Scalar>::Matrix AsyncModel<Scalar>::hessian(
+    const Eigen::Ref<const Vector>& input, size_t output_dim) const {
+    std::shared_ptr<const CompiledModel<Scalar>> model = get_model();
+    return model ? model->hessian(input, output_dim)
+                 : tape_hessian(input, output_dim);
+}
+
+template <typename Scalar>
+typename AsyncModel<Scalar>::Matrix AsyncModel<Scalar>::hessian(
+    const Eigen::Ref<const Vector>& input,
+    const Eigen::Ref<const Vector>& parameters, size_t output_dim) const {
+    std::shared_ptr<const CompiledModel<Scalar>> model = get_model();
+    if (model) {
+        return model->hessian(input, parameters, output_dim);
+    }
+    Vector xp(input.size() + parameters.size());
+    xp << input, parameters;
+    return tape_hessian(xp, output_dim)
+        .topLeftCorner(input.rows(), input.rows());
+}
+
+template <typename Scalar>
+size_t AsyncModel<Scalar>::get_input_size() const {
+    return input_size_;
+}
+
+template <typename Scalar>
+size_t AsyncModel<Scalar>::get_output_size() const {
+    return output_size_;
+}
+
+template <typename Scalar>
+typename AsyncModel<Scalar>::Vector AsyncModel<Scalar>::tape_evaluate(
+    const Eigen::Ref<const Vector>& input) const {
+    std::vector<TapeScalar> y = tape_.Forward(0, tape_input(input));
+    Vector output(output_size_);
+    for (size_t i = 0; i < output_size_; ++i) {
+        output(i) = y[i].getValue();
+    }
+    return output;
+}
+
+template <typename Scalar>
+typename AsyncModel<Scalar>::Matrix AsyncModel<Scalar>::tape_jacobian(
+    const Eigen::Ref<const Vector>& input) const {
+    if (!jacobian_available_) {
+        throw std::runtime_error(
+            "Jacobian is not available: compiled model must be at least "
+            "first-order.");
+    }
+
+    // The Jacobian is returned in row-major order
+    std::vector<TapeScalar> J_vec = tape_.Jacobian(tape_input(input));
+    Matrix J(output_size_, input_size_);
+    for (size_t i = 0; i < J_vec.size(); ++i) {
+        J.data()[i] = J_vec[i].getValue();
+    }
+    return J;
+}
+
+template <typename Scalar>
+typename AsyncModel<Scalar>::Matrix AsyncModel<Scalar>::tape_hessian(
+    const Eigen::Ref<const Vector>& input, size_t output_dim) const {
+    if (!hessian_available_) {
+        throw std::runtime_error(
+            "Hessian is not available: compiled model must be "
+            "second-order.");
+    }
+    if (output_dim >= output_size_) {
+        throw std::runtime_error("Specified output dimension for Hessian is " +
+                                 std::to_string(output_dim) +
+                                 ", but model has only " +
+                                 std::to_string(output_size_) + " outputs.");
+    }
+
+    std::vector<TapeScalar> w(output_size_, TapeScalar(0));
+    w[output_dim] = TapeScalar(1);
+    std::vector<TapeScalar> H_vec = tape_.Hessian(tape_input(input), w);
+    Matrix H(input_size_, input_size_);
+    for (size_t i = 0; i < H_vec.size(); ++i) {
+        H.data()[i] = H_vec[i].getValue();
+    }
+    return H;
+}
+
+template <typename Scalar>
+std::vector<typename AsyncModel<Scalar>::TapeScalar>
+AsyncModel<Scalar>::tape_input(const Eigen::Ref<const Vector>& input) const {
+    if (static_cast<size_t>(input.size()) != input_size_) {
+        throw std::runtime_error(
+            "Model domain is " + std::to_string(input_size_) +
+            ", but input is of size " + std::to_string(input.size()) + ".");
+    }
+
+    // Constants, rather than variables of a code handler, are evaluated
+    // directly when the tape is played back
+    std::vector<TapeScalar> x(input_size_);
+    for (size_t i = 0; i < input_size_; ++i) {
+        x[i] = TapeScalar(input(i));
+    }
+    return x;
+}
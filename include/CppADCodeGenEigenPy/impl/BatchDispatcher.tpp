@@ -0,0 +1,235 @@
+#pragma once
+
+template <typename Scalar>
+BatchDispatcher<Scalar>::BatchDispatcher(const CompiledModel<Scalar>& model,
+                                         const DispatcherOptions& options)
+    : input_size_(model.get_input_size()),
+      output_size_(model.get_output_size()),
+      options_(options),
+      max_wait_(std::chrono::duration_cast<Clock::duration>(
+          std::chrono::duration<double>(options.max_wait_time))) {
+    if (options_.max_batch_size == 0 || options_.num_threads == 0) {
+        throw std::runtime_error(
+            "Batch size and number of threads must be positive.");
+    }
+    if (options_.max_wait_time < 0) {
+        throw std::runtime_error("Maximum wait time must not be negative.");
+    }
+
+    CppAD::cg::GenericModel<Scalar>& generic_model = model.get_generic_model();
+    jacobian_available_ = generic_model.isJacobianAvailable() ||
+                          generic_model.isSparseJacobianAvailable();
+
+    for (size_t i = 0; i < options_.num_threads; ++i) {
+        models_.emplace_back(new CompiledModel<Scalar>(model));
+    }
+    for (size_t i = 0; i < options_.num_threads; ++i) {
+        workers_.emplace_back(&BatchDispatcher::run, this, i);
+    }
+}
+
+template <typename Scalar>
+BatchDispatcher<Scalar>::~BatchDispatcher() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+}
+
+template <typename Scalar>
+std::future<typename BatchDispatcher<Scalar>::Vector>
+BatchDispatcher<Scalar>::evaluate(const Eigen::Ref<const Vector>& input) {
+    if (static_cast<size_t>(input.size()) != input_size_) {
+        throw std::runtime_error(
+            "Model domain is " + std::to_string(input_size_) +
+            ", but input is of size " + std::to_string(input.size()) + ".");
+    }
+    Request request;
+    request.is_jacobian = false;
+    request.input = input;
+    std::future<Vector> future = request.value.get_future();
+    submit(std::move(request));
+    return future;
+}
+
+template <typename Scalar>
+std::future<typename BatchDispatcher<Scalar>::Matrix>
+BatchDispatcher<Scalar>::jacobian(const Eigen::Ref<const Vector>& input) {
+    if (!jacobian_available_) {
+        throw std::runtime_error(
+            "Jacobian is not available: compiled model must be at least "
+            "first-order.");
+    }
+    if (static_cast<size_t>(input.size()) != input_size_) {
+        throw std::runtime_error(
+            "Model domain is " + std::to_string(input_size_) +
+            ", but input is of size " + std::to_string(input.size()) + ".");
+    }
+    Request request;
+    request.is_jacobian = true;
+    request.input = input;
+    std::future<Matrix> future = request.jacobian.get_future();
+    submit(std::move(request));
+    return future;
+}
+
+template <typename Scalar>
+DispatcherStatistics BatchDispatcher<Scalar>::get_statistics() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    DispatcherStatistics statistics;
+    statistics.num_requests = num_requests_;
+    statistics.num_batches = num_batches_;
+    statistics.max_batch_size = max_batch_size_;
+    statistics.queue_depth = queue_.size();
+    statistics.max_queue_depth = max_queue_depth_;
+    if (num_batches_ > 0) {
+        statistics.mean_batch_size =
+            static_cast<double>(num_requests_) / num_batches_;
+        statistics.mean_wait_time = total_wait_time_ / num_requests_;
+    }
+    return statistics;
+}
+
+template <typename Scalar>
+void BatchDispatcher<Scalar>::reset_statistics() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    num_requests_ = 0;
+    num_batches_ = 0;
+    max_batch_size_ = 0;
+    total_wait_time_ = 0;
+    max_queue_depth_ = queue_.size();
+}
+
+template <typename Scalar>
+const DispatcherOptions& BatchDispatcher<Scalar>::get_options() const {
+    return options_;
+}
+
+template <typename Scalar>
+void BatchDispatcher<Scalar>::submit(Request&& request) {
+    bool full;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) {
+            throw std::runtime_error("Dispatcher has been stopped.");
+        }
+        request.submit_time = Clock::now();
+        queue_.push_back(std::move(request));
+        max_queue_depth_ = std::max(max_queue_depth_, queue_.size());
+        full = queue_.size() >= options_.max_batch_size;
+    }
+
+    // A worker waiting for the batch to fill must be woken when it is full,
+    // while any idle worker can pick up a new request
+    if (full) {
+        cv_.notify_all();
+    } else {
+        cv_.notify_one();
+    }
+}
+
+template <typename Scalar>
+void BatchDispatcher<Scalar>::run(size_t thread_index) {
+    CompiledModel<Scalar>& model = *models_[thread_index];
+    std::vector<Request> batch;
+    batch.reserve(options_.max_batch_size);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        if (queue_.empty()) {
+            if (stopping_) {
+                return;
+            }
+            cv_.wait(lock);
+            continue;
+        }
+
+        // Wait for the batch to fill until the oldest request times out.
+        // When stopping, the remaining requests are not kept waiting.
+        const Clock::time_point deadline =
+            queue_.front().submit_time + max_wait_;
+        if (!stopping_ && queue_.size() < options_.max_batch_size &&
+            Clock::now() < deadline) {
+            cv_.wait_until(lock, deadline);
+            continue;
+        }
+
+        // Take the oldest request and the next ones of the same kind
+        const Clock::time_point start = Clock::now();
+        const bool is_jacobian = queue_.front().is_jacobian;
+        double wait_time = 0;
+        for (auto it = queue_.begin();
+             it != queue_.end() && batch.size() < options_.max_batch_size;) {
+            if (it->is_jacobian == is_jacobian) {
+                wait_time +=
+                    std::chrono::duration<double>(start - it->submit_time)
+                        .count();
+                batch.push_back(std::move(*it));
+                it = queue_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        lock.unlock();
+        process(model, batch, wait_time);
+        batch.clear();
+        lock.lock();
+    }
+}
+
+template <typename Scalar>
+void BatchDispatcher<Scalar>::process(CompiledModel<Scalar>& model,
+                                      std::vector<Request>& batch,
+                                      double wait_time) {
+    const bool is_jacobian = batch.front().is_jacobian;
+    Matrix inputs(batch.size(), input_size_);
+    for (size_t i = 0; i < batch.size(); ++i) {
+        inputs.row(i) = batch[i].input.transpose();
+    }
+
+    Matrix results;
+    std::exception_ptr error;
+    try {
+        if (is_jacobian) {
+            results = model.jacobian_batch(inputs);
+        } else {
+            results = model.evaluate_batch(inputs);
+        }
+    } catch (...) {
+        error = std::current_exception();
+    }
+
+    // The batch is counted before its promises are fulfilled, so that the
+    // statistics include every request whose result is available
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        num_requests_ += batch.size();
+        num_batches_ += 1;
+        max_batch_size_ = std::max(max_batch_size_, batch.size());
+        total_wait_time_ += wait_time;
+    }
+
+    for (size_t i = 0; i < batch.size(); ++i) {
+        try {
+            if (error) {
+                std::rethrow_exception(error);
+            } else if (is_jacobian) {
+                batch[i].jacobian.set_value(Eigen::Map<const Matrix>(
+                    results.row(i).data(), output_size_, input_size_));
+            } else {
+                batch[i].value.set_value(results.row(i).transpose());
+            }
+        } catch (...) {
+            if (is_jacobian) {
+                batch[i].jacobian.set_exception(std::current_exception());
+            } else {
+                batch[i].value.set_exception(std::current_exception());
+            }
+        }
+    }
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+inline double CompileReport::total_time() const {
+    return record_time + optimize_time + source_generation_time +
+           compile_time + load_time;
+}
+
+// The report is saved with one "key value" pair per line, which keeps it
+// readable and easy to diff over time.
+inline void CompileReport::save(const std::string& path) const {
+    std::ofstream out(path);
+    out.precision(17);
+    out << "model_name " << model_name << "\n"
+        << "record_time " << record_time << "\n"
+        << "optimize_time " << optimize_time << "\n"
+        << "source_generation_time " << source_generation_time << "\n"
+        << "compile_time " << compile_time << "\n"
+        << "load_time " << load_time << "\n"
+        << "num_operations " << num_operations << "\n"
+        << "num_optimized_operations " << num_optimized_operations << "\n"
+        << "library_size " << library_size << "\n";
+    for (const auto& kv : source_sizes) {
+        out << "source_size " << kv.first << " " << kv.second << "\n";
+    }
+    out << "nominal_input";
+    for (double value : nominal_input) {
+        out << " " << value;
+    }
+    out << "\n";
+    if (!out) {
+        throw std::runtime_error("Failed to write compile report " + path +
+                                 ".");
+    }
+}
+
+inline CompileReport CompileReport::load(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("Failed to open compile report " + path +
+                                 ".");
+    }
+
+    CompileReport report;
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream ss(line);
+        std::string key;
+        if (!(ss >> key)) {
+            continue;
+        }
+        if (key == "model_name") {
+            ss >> report.model_name;
+        } else if (key == "record_time") {
+            ss >> report.record_time;
+        } else if (key == "optimize_time") {
+            ss >> report.optimize_time;
+        } else if (key == "source_generation_time") {
+            ss >> report.source_generation_time;
+        } else if (key == "compile_time") {
+            ss >> report.compile_time;
+        } else if (key == "load_time") {
+            ss >> report.load_time;
+        } else if (key == "num_operations") {
+            ss >> report.num_operations;
+        } else if (key == "num_optimized_operations") {
+            ss >> report.num_optimized_operations;
+        } else if (key == "library_size") {
+            ss >> report.library_size;
+        } else if (key == "source_size") {
+            std::string name;
+            ss >> name >> report.source_sizes[name];
+        } else if (key == "nominal_input") {
+            double value;
+            while (ss >> value) {
+                report.nominal_input.push_back(value);
+            }
+            // Reading stops at the end of the line
+            ss.clear();
+        } else {
+            // Unknown keys are skipped, so that reports with fields added
+            // later can still be read
+            continue;
+        }
+        if (ss.fail()) {
+            throw std::runtime_error("Invalid line in compile report " +
+                                     path + ": " + line);
+        }
+    }
+    return report;
+}
+
+inline std::ostream& operator<<(std::ostream& out,
+                                const CompileReport& report) {
+    out << "Compile report for model " << report.model_name << "\n"
+        << "  record:            " << report.record_time << " s\n"
+        << "  optimize:          " << report.optimize_time << " s\n"
+        << "  generate sources:  " << report.source_generation_time << " s\n"
+        << "  compile:           " << report.compile_time << " s\n"
+        << "  load:              " << report.load_time << " s\n"
+        << "  total:             " << report.total_time() << " s\n"
+        << "  operations:        " << report.num_operations << " ("
+        << report.num_optimized_operations << " after optimization)\n"
+        << "  library size:      " << report.library_size << " bytes\n";
+    for (const auto& kv : report.source_sizes) {
+        out << "  source " << kv.first << ": " << kv.second << " bytes\n";
+    }
+    return out;
+}
@@ -2,7 +2,15 @@
 
 template <typename Scalar>
 CompiledModel<Scalar>::CompiledModel(const std::string& model_name,
-                                     const std::string& library_generic_path) {
+                                     const std::string& library_generic_path)
+    : CompiledModel(model_name, library_generic_path, LoadOptions()) {}
+
+template <typename Scalar>
+CompiledModel<Scalar>::CompiledModel(const std::string& model_name,
+                                     const std::string& library_generic_path,
+                                     const LoadOptions& options)
+    : model_name_(model_name),
+      library_path_(get_absolute_path(library_generic_path)) {
     // Replace CppAD error handler so that error is thrown if dynamic library
     // cannot be loaded for some reason. See
     // https://coin-or.github.io/CppAD/doc/error_handler.cpp.htm
@@ -10,10 +18,43 @@ CompiledModel<Scalar>::CompiledModel(const std::string& model_name,
 
     lib_.reset(new CppAD::cg::LinuxDynamicLib<Scalar>(
         library_generic_path +
-        CppAD::cg::system::SystemInfo<>::DYNAMIC_LIB_EXTENSION));
+            CppAD::cg::system::SystemInfo<>::DYNAMIC_LIB_EXTENSION,
+        options.bind_now ? RTLD_NOW : RTLD_LAZY));
+    library_hash_ =
+        hash_file(library_path_ +
+                  CppAD::cg::system::SystemInfo<>::DYNAMIC_LIB_EXTENSION);
     model_ = lib_->model(model_name);
     input_size_ = model_->Domain();
     output_size_ = model_->Range();
+    load_block_kernels(model_name);
+    load_parameter_kernel(model_name);
+    if (model_->isSparseHessianAvailable()) {
+        std::vector<size_t> rows, cols;
+        model_->HessianSparsity(rows, cols);
+        hessian_nnz_ = rows.size();
+    }
+
+    if (options.prefault || options.lock_memory) {
+        prefault(options.lock_memory);
+    }
+    if (options.warmup) {
+        warmup(options);
+    }
+}
+
+template <typename Scalar>
+CompiledModel<Scalar>::CompiledModel(const CompiledModel& other)
+    : lib_(other.derivative_source().lib_),
+      model_(lib_->model(other.model_name_)),
+      model_name_(other.model_name_),
+      library_path_(other.derivative_source().library_path_),
+      library_hash_(other.derivative_source().library_hash_),
+      hessian_nnz_(other.derivative_source().hessian_nnz_),
+      input_size_(other.input_size_),
+      output_size_(other.output_size_),
+      warmup_latencies_(other.warmup_latencies_) {
+    load_block_kernels(model_name_);
+    load_parameter_kernel(model_name_);
 }
 
 template <typename Scalar>
@@ -37,7 +78,15 @@ typename CompiledModel<Scalar>::Vector CompiledModel<Scalar>::evaluate(
 template <typename Scalar>
 typename CompiledModel<Scalar>::Matrix CompiledModel<Scalar>::jacobian(
     const Eigen::Ref<const Vector>& input) const {
-    if (!model_->isJacobianAvailable()) {
+    // A lazily compiled model forwards to the derivative model until
+    // wait_for_derivatives switches to it
+    if (derivative_model_.valid()) {
+        return derivative_model_.get()->jacobian(input);
+    }
+    // Models with multithreading only have the sparse Jacobian, which is
+    // the one that is parallelized
+    const bool dense = model_->isJacobianAvailable();
+    if (!dense && !model_->isSparseJacobianAvailable()) {
         throw std::runtime_error(
             "Jacobian is not available: compiled model must be at least "
             "first-order.");
@@ -45,7 +94,8 @@ typename CompiledModel<Scalar>::Matrix CompiledModel<Scalar>::jacobian(
     check_input_size(input.size());
 
     assert(input.rows() == input_size_);
-    Vector J_vec = model_->template Jacobian<Vector>(input);
+    Vector J_vec = dense ? model_->template Jacobian<Vector>(input)
+                         : model_->template SparseJacobian<Vector>(input);
     Eigen::Map<Matrix> J(J_vec.data(), output_size_, input_size_);
     assert(J.allFinite());
     return J;
@@ -63,29 +113,65 @@ typename CompiledModel<Scalar>::Matrix CompiledModel<Scalar>::jacobian(
 }
 
 template <typename Scalar>
-typename CompiledModel<Scalar>::Matrix CompiledModel<Scalar>::hessian(
-    const Eigen::Ref<const Vector>& input, size_t output_dim) const {
-    if (!model_->isHessianAvailable()) {
+typename CompiledModel<Scalar>::Vector CompiledModel<Scalar>::gradient(
+    const Eigen::Ref<const Vector>& input) const {
+    if (derivative_model_.valid()) {
+        return derivative_model_.get()->gradient(input);
+    }
+    if (output_size_ != 1) {
         throw std::runtime_error(
-            "Hessian is not available: compiled model must be "
-            "second-order.");
+            "Gradient is only available for models with a single output, but "
+            "model has " +
+            std::to_string(output_size_) + " outputs.");
     }
-    if (output_dim >= output_size_) {
-        throw std::runtime_error("Specified output dimension for Hessian is " +
-                                 std::to_string(output_dim) +
-                                 ", but model has only " +
-                                 std::to_string(output_size_) + " outputs.");
+    if (!model_->isJacobianAvailable()) {
+        return jacobian(input).transpose();
+    }
+    check_input_size(input.size());
+
+    // With a single output, the Jacobian is the gradient
+    Vector g(input_size_);
+    model_->Jacobian(
+        CppAD::cg::ArrayView<const Scalar>(input.data(), input.size()),
+        CppAD::cg::ArrayView<Scalar>(g.data(), g.size()));
+    return g;
+}
+
+template <typename Scalar>
+typename CompiledModel<Scalar>::Vector CompiledModel<Scalar>::gradient(
+    const Eigen::Ref<const Vector>& input,
+    const Eigen::Ref<const Vector>& parameters) const {
+    check_input_size_with_params(input.size(), parameters.size());
+
+    Vector xp(input.size() + parameters.size());
+    xp << input, parameters;
+    return gradient(xp).head(input.size());
+}
+
+template <typename Scalar>
+typename CompiledModel<Scalar>::Matrix CompiledModel<Scalar>::hessian(
+    const Eigen::Ref<const Vector>& input, size_t output_dim) const {
+    if (derivative_model_.valid()) {
+        return derivative_model_.get()->hessian(input, output_dim);
     }
+    check_hessian_available(output_dim);
     check_input_size(input.size());
+    const bool dense = model_->isHessianAvailable();
 
     // Need to use the overload of the Hessian function that accepts a weight
     // vector w. Otherwise, CppADCodeGen creates a w vector but does not
     // initialize it to zero, which can cause errors.
     Vector w = Vector::Zero(output_size_);
     w(output_dim) = 1.0;
-    Vector H_vec = model_->template Hessian<Vector>(input, w);
+    Vector H_vec = dense ? model_->template Hessian<Vector>(input, w)
+                         : model_->template SparseHessian<Vector>(input, w);
     Eigen::Map<Matrix> H(H_vec.data(), input_size_, input_size_);
     assert(H.allFinite());
+
+    // The sparse Hessian of a symmetric model only fills the lower triangle
+    if (!dense) {
+        H.template triangularView<Eigen::StrictlyUpper>() = H.transpose();
+    }
     return H;
 }
 
@@ -100,6 +186,342 @@ typename CompiledModel<Scalar>::Matrix CompiledModel<Scalar>::hessian(
     return hessian(xp, output_dim).topLeftCorner(input.rows(), input.rows());
 }
 
+template <typename Scalar>
+typename CompiledModel<Scalar>::Vector CompiledModel<Scalar>::hessian_packed(
+    const Eigen::Ref<const Vector>& input, size_t output_dim) const {
+    if (derivative_model_.valid()) {
+        return derivative_model_.get()->hessian_packed(input, output_dim);
+    }
+    check_hessian_available(output_dim);
+    check_input_size(input.size());
+
+    Vector packed = Vector::Zero(input_size_ * (input_size_ + 1) / 2);
+    if (model_->isHessianAvailable()) {
+        // Only the full Hessian was generated
+        Matrix H = hessian(input, output_dim);
+        for (size_t i = 0; i < input_size_; ++i) {
+            packed.segment(i * (i + 1) / 2, i + 1) =
+                H.row(i).head(i + 1).transpose();
+        }
+        return packed;
+    }
+
+    // The sparse Hessian computes only the elements of its sparsity pattern,
+    // which are written to their place in the lower triangle
+    Vector w = Vector::Zero(output_size_);
+    w(output_dim) = 1.0;
+    size_t const* rows;
+    size_t const* cols;
+    Vector H_vec(hessian_nnz_);
+    model_->SparseHessian(
+        CppAD::cg::ArrayView<const Scalar>(input.data(), input.size()),
+        CppAD::cg::ArrayView<const Scalar>(w.data(), w.size()),
+        CppAD::cg::ArrayView<Scalar>(H_vec.data(), H_vec.size()), &rows,
+        &cols);
+    for (size_t k = 0; k < hessian_nnz_; ++k) {
+        const size_t i = std::max(rows[k], cols[k]);
+        const size_t j = std::min(rows[k], cols[k]);
+        packed(i * (i + 1) / 2 + j) = H_vec(k);
+    }
+    return packed;
+}
+
+template <typename Scalar>
+typename CompiledModel<Scalar>::Vector CompiledModel<Scalar>::hessian_packed(
+    const Eigen::Ref<const Vector>& input,
+    const Eigen::Ref<const Vector>& parameters, size_t output_dim) const {
+    check_input_size_with_params(input.size(), parameters.size());
+
+    // The rows of the input come first, so its triangle is a prefix of the
+    // full one
+    Vector xp(input.size() + parameters.size());
+    xp << input, parameters;
+    return hessian_packed(xp, output_dim)
+        .head(input.size() * (input.size() + 1) / 2);
+}
+
+template <typename Scalar>
+typename CompiledModel<Scalar>::Matrix CompiledModel<Scalar>::jacobian_block(
+    const std::string& output_segment, const std::string& input_segment,
+    const Eigen::Ref<const Vector>& input) const {
+    if (derivative_model_.valid()) {
+        return derivative_model_.get()->jacobian_block(
+            output_segment, input_segment, input);
+    }
+    auto it = block_kernels_.find(JacobianBlock(output_segment, input_segment));
+    if (it == block_kernels_.end()) {
+        throw std::runtime_error(
+            "Jacobian block (" + output_segment + ", " + input_segment +
+            ") is not available: it must be requested when compiling the "
+            "model.");
+    }
+    check_input_size(input.size());
+
+    // The sparse Jacobian computes only the elements of the block, in the
+    // order given by the row and column indices
+    const BlockKernel& kernel = it->second;
+    size_t const* rows;
+    size_t const* cols;
+    Vector J_vec(kernel.rows * kernel.cols);
+    kernel.model->SparseJacobian(
+        CppAD::cg::ArrayView<const Scalar>(input.data(), input.size()),
+        CppAD::cg::ArrayView<Scalar>(J_vec.data(), J_vec.size()), &rows,
+        &cols);
+
+    Matrix J = Matrix::Zero(kernel.rows, kernel.cols);
+    for (Eigen::Index k = 0; k < J_vec.size(); ++k) {
+        J(rows[k] - kernel.row_offset, cols[k] - kernel.col_offset) = J_vec(k);
+    }
+    return J;
+}
+
+template <typename Scalar>
+typename CompiledModel<Scalar>::Matrix CompiledModel<Scalar>::jacobian_block(
+    const std::string& output_segment, const std::string& input_segment,
+    const Eigen::Ref<const Vector>& input,
+    const Eigen::Ref<const Vector>& parameters) const {
+    check_input_size_with_params(input.size(), parameters.size());
+
+    Vector xp(input.size() + parameters.size());
+    xp << input, parameters;
+    return jacobian_block(output_segment, input_segment, xp);
+}
+
+template <typename Scalar>
+typename CompiledModel<Scalar>::Matrix
+CompiledModel<Scalar>::parameter_jacobian(
+    const Eigen::Ref<const Vector>& input,
+    const Eigen::Ref<const Vector>& parameters) const {
+    if (derivative_model_.valid()) {
+        return derivative_model_.get()->parameter_jacobian(input, parameters);
+    }
+    Vector xp = parameter_kernel_input(input, parameters);
+    const size_t n = input.size();
+
+    // The sparse Jacobian computes only the parameter columns
+    size_t const* rows;
+    size_t const* cols;
+    Vector J_vec(output_size_ * parameter_size_);
+    parameter_kernel_->SparseJacobian(
+        CppAD::cg::ArrayView<const Scalar>(xp.data(), xp.size()),
+        CppAD::cg::ArrayView<Scalar>(J_vec.data(), J_vec.size()), &rows,
+        &cols);
+
+    Matrix J = Matrix::Zero(output_size_, parameter_size_);
+    for (Eigen::Index k = 0; k < J_vec.size(); ++k) {
+        J(rows[k], cols[k] - n) = J_vec(k);
+    }
+    return J;
+}
+
+template <typename Scalar>
+typename CompiledModel<Scalar>::Matrix CompiledModel<Scalar>::mixed_hessian(
+    const Eigen::Ref<const Vector>& input,
+    const Eigen::Ref<const Vector>& parameters, size_t output_dim) const {
+    if (derivative_model_.valid()) {
+        return derivative_model_.get()->mixed_hessian(input, parameters,
+                                                      output_dim);
+    }
+    if (!parameter_kernel_ || !parameter_kernel_->isSparseHessianAvailable()) {
+        throw std::runtime_error(
+            "Mixed Hessian is not available: model must be compiled with "
+            "parameter derivatives to second order.");
+    }
+    if (output_dim >= output_size_) {
+        throw std::runtime_error("Specified output dimension for Hessian is " +
+                                 std::to_string(output_dim) +
+                                 ", but model has only " +
+                                 std::to_string(output_size_) + " outputs.");
+    }
+    Vector xp = parameter_kernel_input(input, parameters);
+    const size_t n = input.size();
+
+    // The sparse Hessian computes only the (parameter, input) block of the
+    // lower triangle, which is transposed to (input, parameter)
+    Vector w = Vector::Zero(output_size_);
+    w(output_dim) = 1.0;
+    size_t const* rows;
+    size_t const* cols;
+    Vector H_vec(n * parameter_size_);
+    parameter_kernel_->SparseHessian(
+        CppAD::cg::ArrayView<const Scalar>(xp.data(), xp.size()),
+        CppAD::cg::ArrayView<const Scalar>(w.data(), w.size()),
+        CppAD::cg::ArrayView<Scalar>(H_vec.data(), H_vec.size()), &rows,
+        &cols);
+
+    Matrix H = Matrix::Zero(n, parameter_size_);
+    for (Eigen::Index k = 0; k < H_vec.size(); ++k) {
+        H(cols[k], rows[k] - n) = H_vec(k);
+    }
+    return H;
+}
+
+template <typename Scalar>
+typename CompiledModel<Scalar>::Matrix CompiledModel<Scalar>::evaluate_batch(
+    const Eigen::Ref<const Matrix>& inputs) const {
+    check_input_size(inputs.cols());
+
+    // Write each output directly into its row of the result
+    Matrix outputs(inputs.rows(), output_size_);
+    for (Eigen::Index i = 0; i < inputs.rows(); ++i) {
+        model_->ForwardZero(
+            CppAD::cg::ArrayView<const Scalar>(inputs.row(i).data(),
+                                               input_size_),
+            CppAD::cg::ArrayView<Scalar>(outputs.row(i).data(), output_size_));
+    }
+    return outputs;
+}
+
+template <typename Scalar>
+typename CompiledModel<Scalar>::Matrix CompiledModel<Scalar>::jacobian_batch(
+    const Eigen::Ref<const Matrix>& inputs) const {
+    if (derivative_model_.valid()) {
+        return derivative_model_.get()->jacobian_batch(inputs);
+    }
+    check_input_size(inputs.cols());
+
+    Matrix jacobians(inputs.rows(), output_size_ * input_size_);
+    if (!model_->isJacobianAvailable()) {
+        // Only the sparse Jacobian is available, which cannot be written
+        // into place
+        for (Eigen::Index i = 0; i < inputs.rows(); ++i) {
+            Matrix J = jacobian(inputs.row(i).transpose());
+            jacobians.row(i) =
+                Eigen::Map<const Vector>(J.data(), J.size()).transpose();
+        }
+        return jacobians;
+    }
+    for (Eigen::Index i = 0; i < inputs.rows(); ++i) {
+        model_->Jacobian(
+            CppAD::cg::ArrayView<const Scalar>(inputs.row(i).data(),
+                                               input_size_),
+            CppAD::cg::ArrayView<Scalar>(jacobians.row(i).data(),
+                                         jacobians.cols()));
+    }
+    return jacobians;
+}
+
+template <typename Scalar>
+typename CompiledModel<Scalar>::Reduction CompiledModel<Scalar>::reduce(
+    const Eigen::Ref<const Matrix>& inputs,
+    const Eigen::Ref<const Matrix>& parameters,
+    const Eigen::Ref<const Matrix>& weights, bool gauss_newton,
+    bool with_respect_to_parameters, size_t num_threads) const {
+    if (derivative_model_.valid()) {
+        return derivative_model_.get()->reduce(inputs, parameters, weights,
+                                               gauss_newton,
+                                               with_respect_to_parameters,
+                                               num_threads);
+    }
+    if (!model_->isJacobianAvailable() &&
+        !model_->isSparseJacobianAvailable()) {
+        throw std::runtime_error(
+            "Jacobian is not available: compiled model must be at least "
+            "first-order.");
+    }
+    const size_t n = inputs.cols();
+    const size_t p = parameters.cols();
+    if (n + p != input_size_) {
+        throw std::runtime_error(
+            "Input size is " + std::to_string(n) + " and parameter size is " +
+            std::to_string(p) + ", but the model domain is " +
+            std::to_string(input_size_) + ".");
+    }
+    if (with_respect_to_parameters && p == 0) {
+        throw std::runtime_error(
+            "Parameters must be given to reduce with respect to them.");
+    }
+    if (weights.size() > 0 &&
+        static_cast<size_t>(weights.cols()) != output_size_) {
+        throw std::runtime_error("Weights must have " +
+                                 std::to_string(output_size_) + " columns.");
+    }
+
+    // Each argument has a row per sample, or a single row shared by all
+    size_t num_samples = inputs.rows();
+    if (p > 0) {
+        num_samples = std::max<size_t>(num_samples, parameters.rows());
+    }
+    if (weights.size() > 0) {
+        num_samples = std::max<size_t>(num_samples, weights.rows());
+    }
+    auto check_rows = [num_samples](const std::string& name, size_t rows) {
+        if (rows != 1 && rows != num_samples) {
+            throw std::runtime_error(
+                name + " must have 1 or " + std::to_string(num_samples) +
+                " rows, but have " + std::to_string(rows) + ".");
+        }
+    };
+    check_rows("Inputs", inputs.rows());
+    if (p > 0) {
+        check_rows("Parameters", parameters.rows());
+    }
+    if (weights.size() > 0) {
+        check_rows("Weights", weights.rows());
+    }
+
+    // Each thread accumulates its own sums, using its own copy of the model
+    ThreadPool pool(num_threads);
+    const size_t num_partials = pool.get_num_threads();
+    std::vector<CompiledModel> models;
+    models.reserve(num_partials - 1);
+    for (size_t i = 1; i < num_partials; ++i) {
+        models.emplace_back(*this);
+    }
+    const size_t d = with_respect_to_parameters ? p : n;
+    std::vector<Reduction> partials(num_partials);
+    for (Reduction& sums : partials) {
+        sums.output_sum = Vector::Zero(output_size_);
+        sums.gradient = Vector::Zero(d);
+        if (gauss_newton) {
+            sums.gauss_newton = Matrix::Zero(d, d);
+        }
+    }
+    pool.parallel_for(num_samples, [&](size_t begin, size_t end,
+                                       size_t thread_index) {
+        const CompiledModel& model =
+            thread_index == 0 ? *this : models[thread_index - 1];
+        model.accumulate(begin, end, inputs, parameters, weights,
+                         with_respect_to_parameters, partials[thread_index]);
+    });
+
+    // Add up the sums pairwise, halving their number at each level
+    for (size_t stride = 1; stride < num_partials; stride *= 2) {
+        const size_t num_pairs = (num_partials + stride - 1) / (2 * stride);
+        pool.parallel_for(num_pairs, [&](size_t begin, size_t end, size_t) {
+            for (size_t k = begin; k < end; ++k) {
+                Reduction& sums = partials[2 * stride * k];
+                const Reduction& other = partials[2 * stride * k + stride];
+                sums.output_sum += other.output_sum;
+                sums.squared_output_sum += other.squared_output_sum;
+                sums.gradient += other.gradient;
+                sums.gauss_newton += other.gauss_newton;
+            }
+        });
+    }
+
+    // Only the lower triangle of the Gauss-Newton matrix is accumulated
+    Reduction& result = partials.front();
+    if (gauss_newton) {
+        result.gauss_newton.template triangularView<Eigen::StrictlyUpper>() =
+            result.gauss_newton.transpose();
+    }
+    return std::move(result);
+}
+
+template <typename Scalar>
+std::vector<typename CompiledModel<Scalar>::JacobianBlock>
+CompiledModel<Scalar>::get_jacobian_blocks() const {
+    if (derivative_model_.valid()) {
+        return derivative_model_.get()->get_jacobian_blocks();
+    }
+    std::vector<JacobianBlock> blocks;
+    for (const auto& kv : block_kernels_) {
+        blocks.push_back(kv.first);
+    }
+    return blocks;
+}
+
 template <typename Scalar>
 size_t CompiledModel<Scalar>::get_input_size() const {
     return input_size_;
@@ -110,6 +532,221 @@ size_t CompiledModel<Scalar>::get_output_size() const {
     return output_size_;
 }
 
+template <typename Scalar>
+void CompiledModel<Scalar>::set_num_threads(size_t num_threads) {
+    // The threads are used by the derivative library
+    wait_for_derivatives();
+    lib_->setThreadNumber(num_threads);
+}
+
+template <typename Scalar>
+size_t CompiledModel<Scalar>::get_num_threads() const {
+    if (derivative_model_.valid()) {
+        return derivative_model_.get()->get_num_threads();
+    }
+    return lib_->getThreadNumber();
+}
+
+template <typename Scalar>
+bool CompiledModel<Scalar>::derivatives_ready() const {
+    // A deferred compilation is not ready until it is waited for
+    return !derivative_model_.valid() ||
+           derivative_model_.wait_for(std::chrono::seconds(0)) ==
+               std::future_status::ready;
+}
+
+template <typename Scalar>
+void CompiledModel<Scalar>::wait_for_derivatives() {
+    if (!derivative_model_.valid()) {
+        return;
+    }
+
+    // Switch to the derivative library, which also contains the function.
+    // The kernels are moved, so that references to them from
+    // get_generic_model stay valid. The function library is unloaded once
+    // no copies of the model use it.
+    std::shared_ptr<CompiledModel> full = derivative_model_.get();
+    lib_ = full->lib_;
+    model_ = std::move(full->model_);
+    library_path_ = full->library_path_;
+    library_hash_ = full->library_hash_;
+    hessian_nnz_ = full->hessian_nnz_;
+    block_kernels_ = std::move(full->block_kernels_);
+    parameter_kernel_ = std::move(full->parameter_kernel_);
+    parameter_size_ = full->parameter_size_;
+    derivative_model_ = {};
+    derivative_sources_.reset();
+}
+
+template <typename Scalar>
+const CompiledModel<Scalar>& CompiledModel<Scalar>::derivative_source() const {
+    return derivative_model_.valid() ? *derivative_model_.get() : *this;
+}
+
+template <typename Scalar>
+CppAD::cg::GenericModel<Scalar>& CompiledModel<Scalar>::get_generic_model()
+    const {
+    if (derivative_model_.valid()) {
+        return derivative_model_.get()->get_generic_model();
+    }
+    return *model_;
+}
+
+template <typename Scalar>
+const std::string& CompiledModel<Scalar>::get_model_name() const {
+    return model_name_;
+}
+
+template <typename Scalar>
+const std::string& CompiledModel<Scalar>::get_library_path() const {
+    return library_path_;
+}
+
+template <typename Scalar>
+const std::vector<WarmupLatency>& CompiledModel<Scalar>::get_warmup_latencies()
+    const {
+    return warmup_latencies_;
+}
+
+template <typename Scalar>
+void CompiledModel<Scalar>::prefault(bool lock_memory) const {
+    const uintptr_t page_size = sysconf(_SC_PAGESIZE);
+    const std::string path =
+        library_path_ + CppAD::cg::system::SystemInfo<>::DYNAMIC_LIB_EXTENSION;
+    std::vector<std::pair<const char*, size_t>> segments =
+        get_library_segments(path);
+    if (segments.empty()) {
+        throw std::runtime_error("Failed to find the memory of library " +
+                                 path + ".");
+    }
+
+    for (const auto& segment : segments) {
+        const uintptr_t begin =
+            reinterpret_cast<uintptr_t>(segment.first) & ~(page_size - 1);
+        const uintptr_t end =
+            reinterpret_cast<uintptr_t>(segment.first) + segment.second;
+
+        // Locking the pages also faults them in
+        if (lock_memory) {
+            if (mlock(reinterpret_cast<const void*>(begin), end - begin) != 0) {
+                throw std::runtime_error("Failed to lock library " + path +
+                                         " in memory: " + strerror(errno));
+            }
+            continue;
+        }
+        for (uintptr_t page = begin; page < end; page += page_size) {
+            volatile char byte = *reinterpret_cast<const volatile char*>(page);
+            (void)byte;
+        }
+    }
+}
+
+template <typename Scalar>
+void CompiledModel<Scalar>::warmup(const LoadOptions& options) {
+    using Clock = std::chrono::steady_clock;
+    using Seconds = std::chrono::duration<double>;
+
+    Vector input = Vector::Zero(input_size_);
+    if (!options.warmup_input.empty()) {
+        if (options.warmup_input.size() != input_size_) {
+            throw std::runtime_error(
+                "Warmup input has size " +
+                std::to_string(options.warmup_input.size()) +
+                ", but model has input size " + std::to_string(input_size_) +
+                ".");
+        }
+        for (size_t i = 0; i < input_size_; ++i) {
+            input(i) = options.warmup_input[i];
+        }
+    } else {
+        // The nominal input is only available if the model was compiled by
+        // ADModel::compile
+        try {
+            CompileReport report = get_compile_report();
+            if (report.nominal_input.size() == input_size_) {
+                for (size_t i = 0; i < input_size_; ++i) {
+                    input(i) = report.nominal_input[i];
+                }
+            }
+        } catch (const std::runtime_error&) {
+        }
+    }
+
+    auto time_kernel = [&](const std::string& kernel,
+                           const std::function<void()>& call) {
+        WarmupLatency latency{kernel, 0, 0};
+        double steady_state_total = 0;
+        for (size_t i = 0; i < options.warmup_iterations; ++i) {
+            Clock::time_point start = Clock::now();
+            call();
+            double time = Seconds(Clock::now() - start).count();
+            if (i == 0) {
+                latency.first_call_time = time;
+            } else {
+                steady_state_total += time;
+            }
+        }
+
+        // With a single call, there is no steady state to measure
+        latency.steady_state_time =
+            options.warmup_iterations > 1
+                ? steady_state_total / (options.warmup_iterations - 1)
+                : latency.first_call_time;
+        warmup_latencies_.push_back(latency);
+    };
+
+    warmup_latencies_.clear();
+    time_kernel("evaluate", [&]() { evaluate(input); });
+    if (model_->isJacobianAvailable() || model_->isSparseJacobianAvailable()) {
+        time_kernel("jacobian", [&]() { jacobian(input); });
+    }
+    if (output_size_ > 0 &&
+        (model_->isHessianAvailable() || model_->isSparseHessianAvailable())) {
+        time_kernel("hessian", [&]() { hessian(input, 0); });
+    }
+    for (const auto& kv : block_kernels_) {
+        const JacobianBlock& block = kv.first;
+        time_kernel("jacobian_block:" + block.first + "," + block.second,
+                    [&]() { jacobian_block(block.first, block.second, input); });
+    }
+    if (parameter_kernel_) {
+        const size_t n = input_size_ - parameter_size_;
+        Vector x = input.head(n);
+        Vector p = input.tail(parameter_size_);
+        time_kernel("parameter_jacobian",
+                    [&]() { parameter_jacobian(x, p); });
+        if (output_size_ > 0 && parameter_kernel_->isSparseHessianAvailable()) {
+            time_kernel("mixed_hessian", [&]() { mixed_hessian(x, p, 0); });
+        }
+    }
+}
+
+template <typename Scalar>
+CompileReport CompiledModel<Scalar>::get_compile_report() const {
+    return CompileReport::load(get_compile_report_path(library_path_));
+}
+
+template <typename Scalar>
+const std::string& CompiledModel<Scalar>::get_library_hash() const {
+    return library_hash_;
+}
+
+template <typename Scalar>
+void CompiledModel<Scalar>::check_hessian_available(size_t output_dim) const {
+    if (!model_->isHessianAvailable() &&
+        !model_->isSparseHessianAvailable()) {
+        throw std::runtime_error(
+            "Hessian is not available: compiled model must be "
+            "second-order.");
+    }
+    if (output_dim >= output_size_) {
+        throw std::runtime_error("Specified output dimension for Hessian is " +
+                                 std::to_string(output_dim) +
+                                 ", but model has only " +
+                                 std::to_string(output_size_) + " outputs.");
+    }
+}
+
 template <typename Scalar>
 void CompiledModel<Scalar>::check_input_size(size_t size) const {
     if (size < input_size_) {
@@ -138,3 +775,147 @@ void CompiledModel<Scalar>::check_input_size_with_params(
             ". Maybe you meant not to pass parameters?");
     }
 }
+
+template <typename Scalar>
+void CompiledModel<Scalar>::load_block_kernels(
+    const std::string& model_name) {
+    const std::string prefix = get_jacobian_block_model_prefix(model_name);
+    for (const std::string& name : lib_->getModelNames()) {
+        if (name.compare(0, prefix.size(), prefix) != 0) {
+            continue;
+        }
+
+        // Remainder of the name is <output segment>__<input segment>
+        std::string segments = name.substr(prefix.size());
+        size_t sep = segments.find("__");
+        JacobianBlock block(segments.substr(0, sep),
+                            segments.substr(sep + 2));
+
+        // The block's extent is recovered from its sparsity pattern, which
+        // contains every element of the block
+        BlockKernel kernel;
+        kernel.model = lib_->model(name);
+        std::vector<size_t> rows, cols;
+        kernel.model->JacobianSparsity(rows, cols);
+        auto row_range = std::minmax_element(rows.begin(), rows.end());
+        auto col_range = std::minmax_element(cols.begin(), cols.end());
+        kernel.row_offset = *row_range.first;
+        kernel.col_offset = *col_range.first;
+        kernel.rows = *row_range.second - *row_range.first + 1;
+        kernel.cols = *col_range.second - *col_range.first + 1;
+
+        block_kernels_[block] = std::move(kernel);
+    }
+}
+
+template <typename Scalar>
+void CompiledModel<Scalar>::accumulate(
+    size_t begin, size_t end, const Eigen::Ref<const Matrix>& inputs,
+    const Eigen::Ref<const Matrix>& parameters,
+    const Eigen::Ref<const Matrix>& weights, bool with_respect_to_parameters,
+    Reduction& sums) const {
+    const Eigen::Index n = inputs.cols();
+    const Eigen::Index p = parameters.cols();
+    const bool dense = model_->isJacobianAvailable();
+    const bool parameter_kernel = with_respect_to_parameters &&
+                                  parameter_kernel_ &&
+                                  parameter_size_ == static_cast<size_t>(p);
+    Vector xp(input_size_);
+    Vector y(output_size_);
+    Matrix J(output_size_, input_size_);
+    Vector J_vec(parameter_kernel ? output_size_ * parameter_size_ : 0);
+    size_t const* rows;
+    size_t const* cols;
+
+    for (size_t i = begin; i < end; ++i) {
+        xp.head(n) = inputs.row(inputs.rows() == 1 ? 0 : i).transpose();
+        if (xp.size() > n) {
+            xp.tail(xp.size() - n) =
+                parameters.row(parameters.rows() == 1 ? 0 : i).transpose();
+        }
+        model_->ForwardZero(
+            CppAD::cg::ArrayView<const Scalar>(xp.data(), xp.size()),
+            CppAD::cg::ArrayView<Scalar>(y.data(), y.size()));
+        if (parameter_kernel) {
+            // Only the parameter columns are computed, which the sparsity
+            // pattern covers entirely
+            parameter_kernel_->SparseJacobian(
+                CppAD::cg::ArrayView<const Scalar>(xp.data(), xp.size()),
+                CppAD::cg::ArrayView<Scalar>(J_vec.data(), J_vec.size()),
+                &rows, &cols);
+            for (Eigen::Index k = 0; k < J_vec.size(); ++k) {
+                J(rows[k], cols[k]) = J_vec(k);
+            }
+        } else if (dense) {
+            model_->Jacobian(
+                CppAD::cg::ArrayView<const Scalar>(xp.data(), xp.size()),
+                CppAD::cg::ArrayView<Scalar>(J.data(), J.size()));
+        } else {
+            J = jacobian(xp);
+        }
+
+        // Only the columns of the input or the parameters are needed
+        const auto J_i = with_respect_to_parameters ? J.rightCols(p)
+                                                    : J.leftCols(n);
+        sums.output_sum += y;
+        sums.squared_output_sum += y.squaredNorm();
+        if (weights.size() > 0) {
+            sums.gradient.noalias() +=
+                J_i.transpose() *
+                weights.row(weights.rows() == 1 ? 0 : i).transpose();
+        } else {
+            sums.gradient.noalias() += J_i.transpose() * y;
+        }
+        if (sums.gauss_newton.size() > 0) {
+            sums.gauss_newton.template selfadjointView<Eigen::Lower>()
+                .rankUpdate(J_i.transpose());
+        }
+    }
+}
+
+template <typename Scalar>
+void CompiledModel<Scalar>::load_parameter_kernel(
+    const std::string& model_name) {
+    parameter_kernel_.reset();
+    parameter_size_ = 0;
+    const std::string name = get_parameter_model_name(model_name);
+    for (const std::string& lib_model_name : lib_->getModelNames()) {
+        if (lib_model_name != name) {
+            continue;
+        }
+
+        // The parameters are the columns of the Jacobian's sparsity pattern,
+        // which contains every element of the parameter columns
+        parameter_kernel_ = lib_->model(name);
+        std::vector<size_t> rows, cols;
+        parameter_kernel_->JacobianSparsity(rows, cols);
+        parameter_size_ =
+            input_size_ - *std::min_element(cols.begin(), cols.end());
+    }
+}
+
+template <typename Scalar>
+typename CompiledModel<Scalar>::Vector
+CompiledModel<Scalar>::parameter_kernel_input(
+    const Eigen::Ref<const Vector>& input,
+    const Eigen::Ref<const Vector>& parameters) const {
+    if (!parameter_kernel_) {
+        throw std::runtime_error(
+            "Parameter derivatives are not available: model must be compiled "
+            "with parameter derivatives to at least first order.");
+    }
+    if (static_cast<size_t>(parameters.size()) != parameter_size_ ||
+        static_cast<size_t>(input.size()) != input_size_ - parameter_size_) {
+        throw std::runtime_error(
+            "Model has input size " +
+            std::to_string(input_size_ - parameter_size_) +
+            " and parameter size " + std::to_string(parameter_size_) +
+            ", but input is of size " + std::to_string(input.size()) +
+            " and parameters of size " + std::to_string(parameters.size()) +
+            ".");
+    }
+
+    Vector xp(input_size_);
+    xp << input, parameters;
+    return xp;
+}
@@ -0,0 +1,200 @@
+#pragma once
+
+template <typename Scalar>
+CompositeModel<Scalar>::CompositeModel(size_t input_size)
+    : input_size_(input_size),
+      values_(input_size),
+      tangents_(input_size, input_size),
+      adjoints_(input_size),
+      hessian_(input_size, input_size) {}
+
+template <typename Scalar>
+size_t CompositeModel<Scalar>::add_model(
+    const CompiledModel<Scalar>& model,
+    const std::vector<size_t>& input_indices) {
+    if (input_indices.size() != model.get_input_size()) {
+        throw std::runtime_error(
+            "Model " + model.get_model_name() + " has input size " +
+            std::to_string(model.get_input_size()) + ", but " +
+            std::to_string(input_indices.size()) +
+            " input indices were given.");
+    }
+    const size_t num_values = values_.size();
+    for (size_t index : input_indices) {
+        if (index >= num_values) {
+            throw std::runtime_error(
+                "Input index " + std::to_string(index) + " of model " +
+                model.get_model_name() +
+                " does not refer to the composite input or the output of an "
+                "earlier model.");
+        }
+    }
+
+    const size_t n = model.get_input_size();
+    const size_t m = model.get_output_size();
+    stages_.push_back(Stage{model, input_indices, num_values, Vector(n),
+                            Matrix(m, n), Matrix(n, input_size_), Vector(n),
+                            Matrix(n, n), Matrix(n, input_size_)});
+
+    values_.conservativeResize(num_values + m);
+    tangents_.conservativeResize(num_values + m, input_size_);
+    adjoints_.conservativeResize(num_values + m);
+    return num_values;
+}
+
+template <typename Scalar>
+void CompositeModel<Scalar>::forward(const Eigen::Ref<const Vector>& input,
+                                     bool tangents) {
+    if (stages_.empty()) {
+        throw std::runtime_error("Composite model has no models.");
+    }
+    if (static_cast<size_t>(input.size()) != input_size_) {
+        throw std::runtime_error("Input is wrong size: expected " +
+                                 std::to_string(input_size_) + ", got " +
+                                 std::to_string(input.size()) + ".");
+    }
+
+    values_.head(input_size_) = input;
+    if (tangents) {
+        tangents_.topRows(input_size_).setIdentity();
+    }
+    for (Stage& stage : stages_) {
+        for (size_t i = 0; i < stage.input_indices.size(); ++i) {
+            stage.input(i) = values_(stage.input_indices[i]);
+        }
+        stage.model.get_generic_model().ForwardZero(
+            CppAD::cg::ArrayView<const Scalar>(stage.input.data(),
+                                               stage.input.size()),
+            CppAD::cg::ArrayView<Scalar>(values_.data() + stage.output_offset,
+                                         stage.model.get_output_size()));
+        if (!tangents) {
+            continue;
+        }
+
+        // The tangents of the output follow from those of the input
+        compute_jacobian(stage);
+        for (size_t i = 0; i < stage.input_indices.size(); ++i) {
+            stage.input_tangent.row(i) = tangents_.row(stage.input_indices[i]);
+        }
+        tangents_.middleRows(stage.output_offset, stage.jacobian.rows())
+            .noalias() = stage.jacobian * stage.input_tangent;
+    }
+}
+
+template <typename Scalar>
+void CompositeModel<Scalar>::compute_jacobian(Stage& stage) const {
+    CppAD::cg::GenericModel<Scalar>& model = stage.model.get_generic_model();
+    if (model.isJacobianAvailable()) {
+        model.Jacobian(
+            CppAD::cg::ArrayView<const Scalar>(stage.input.data(),
+                                               stage.input.size()),
+            CppAD::cg::ArrayView<Scalar>(stage.jacobian.data(),
+                                         stage.jacobian.size()));
+    } else {
+        // Throws if no Jacobian is available at all
+        stage.jacobian = stage.model.jacobian(stage.input);
+    }
+}
+
+template <typename Scalar>
+void CompositeModel<Scalar>::compute_weighted_hessian(Stage& stage) const {
+    CppAD::cg::GenericModel<Scalar>& model = stage.model.get_generic_model();
+    const Eigen::Ref<const Vector> weights = adjoints_.segment(
+        stage.output_offset, stage.model.get_output_size());
+    if (model.isHessianAvailable()) {
+        model.Hessian(
+            CppAD::cg::ArrayView<const Scalar>(stage.input.data(),
+                                               stage.input.size()),
+            CppAD::cg::ArrayView<const Scalar>(weights.data(), weights.size()),
+            CppAD::cg::ArrayView<Scalar>(stage.weighted_hessian.data(),
+                                         stage.weighted_hessian.size()));
+    } else if (model.isSparseHessianAvailable()) {
+        Vector w = weights;
+        Vector H_vec = model.template SparseHessian<Vector>(stage.input, w);
+        stage.weighted_hessian = Eigen::Map<Matrix>(
+            H_vec.data(), stage.input.size(), stage.input.size());
+
+        // The sparse Hessian of a symmetric model only fills the lower
+        // triangle
+        stage.weighted_hessian.template triangularView<Eigen::StrictlyUpper>() =
+            stage.weighted_hessian.transpose();
+    } else {
+        throw std::runtime_error("Hessian is not available: model " +
+                                 stage.model.get_model_name() +
+                                 " must be second-order.");
+    }
+}
+
+template <typename Scalar>
+typename CompositeModel<Scalar>::Vector CompositeModel<Scalar>::evaluate(
+    const Eigen::Ref<const Vector>& input) {
+    forward(input, false);
+    const Stage& last = stages_.back();
+    return values_.segment(last.output_offset, last.model.get_output_size());
+}
+
+template <typename Scalar>
+typename CompositeModel<Scalar>::Matrix CompositeModel<Scalar>::jacobian(
+    const Eigen::Ref<const Vector>& input) {
+    forward(input, true);
+    const Stage& last = stages_.back();
+    return tangents_.middleRows(last.output_offset,
+                                last.model.get_output_size());
+}
+
+template <typename Scalar>
+typename CompositeModel<Scalar>::Matrix CompositeModel<Scalar>::hessian(
+    const Eigen::Ref<const Vector>& input, size_t output_dim) {
+    if (!stages_.empty() && output_dim >= get_output_size()) {
+        throw std::runtime_error("Specified output dimension for Hessian is " +
+                                 std::to_string(output_dim) +
+                                 ", but model has only " +
+                                 std::to_string(get_output_size()) +
+                                 " outputs.");
+    }
+    forward(input, true);
+
+    // Going backward through the models, the adjoints of each model's
+    // outputs are complete once all later models have been visited. Each
+    // model then contributes its Hessian, weighted by those adjoints and
+    // projected onto the composite input by the tangents of its input.
+    adjoints_.setZero();
+    adjoints_(stages_.back().output_offset + output_dim) = 1;
+    hessian_.setZero();
+    for (auto it = stages_.rbegin(); it != stages_.rend(); ++it) {
+        Stage& stage = *it;
+        const auto output_adjoint = adjoints_.segment(
+            stage.output_offset, stage.model.get_output_size());
+        if (output_adjoint.isZero(0)) {
+            continue;
+        }
+
+        compute_weighted_hessian(stage);
+        stage.hessian_tangent.noalias() =
+            stage.weighted_hessian * stage.input_tangent;
+        hessian_.noalias() +=
+            stage.input_tangent.transpose() * stage.hessian_tangent;
+
+        stage.input_adjoint.noalias() =
+            stage.jacobian.transpose() * output_adjoint;
+        for (size_t i = 0; i < stage.input_indices.size(); ++i) {
+            adjoints_(stage.input_indices[i]) += stage.input_adjoint(i);
+        }
+    }
+    return hessian_;
+}
+
+template <typename Scalar>
+size_t CompositeModel<Scalar>::get_input_size() const {
+    return input_size_;
+}
+
+template <typename Scalar>
+size_t CompositeModel<Scalar>::get_output_size() const {
+    return stages_.empty() ? 0 : stages_.back().model.get_output_size();
+}
+
+template <typename Scalar>
+size_t CompositeModel<Scalar>::get_num_models() const {
+    return stages_.size();
+}
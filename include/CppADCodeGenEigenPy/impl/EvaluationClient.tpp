@@ -0,0 +1,272 @@
+#pragma once
+
+template <typename Scalar>
+EvaluationClient<Scalar>::EvaluationClient(const std::string& server_name,
+                                           double connect_timeout,
+                                           size_t spin_iterations)
+    : spin_iterations_(spin_iterations) {
+    // With a single CPU, spinning only delays the server
+    if (std::thread::hardware_concurrency() <= 1) {
+        spin_iterations_ = 0;
+    }
+
+    const std::string shm_name = protocol::get_shm_name(server_name);
+    auto deadline = std::chrono::steady_clock::now() +
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::duration<double>(connect_timeout));
+    while (!try_map(shm_name)) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            throw std::runtime_error("No server named " + server_name +
+                                     " is running.");
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    if (header_->magic != protocol::MAGIC ||
+        header_->version != protocol::VERSION ||
+        header_->scalar_size != sizeof(Scalar)) {
+        munmap(header_, region_size_);
+        throw std::runtime_error("Server " + server_name +
+                                 " is incompatible with this client.");
+    }
+
+    for (slot_ = 0; slot_ < header_->num_slots; ++slot_) {
+        if (try_claim(slot_)) {
+            break;
+        }
+    }
+    if (slot_ == header_->num_slots) {
+        munmap(header_, region_size_);
+        throw std::runtime_error("Server " + server_name +
+                                 " has no free slots.");
+    }
+
+    // A previous owner of the slot may have left requests behind
+    for (size_t i = 0; i < header_->ring_capacity; ++i) {
+        protocol::EntryHeader* entry = protocol::get_entry(header_, slot_, i);
+        wait(entry);
+        protocol::set_state(entry->state, protocol::EntryState::Empty);
+    }
+    head_ = protocol::get_slot(header_, slot_)->tail.load(
+        std::memory_order_acquire);
+}
+
+template <typename Scalar>
+EvaluationClient<Scalar>::~EvaluationClient() {
+    // The server must be done with all requests before the slot can be
+    // handed to another client
+    try {
+        for (size_t i = 0; i < header_->ring_capacity; ++i) {
+            protocol::EntryHeader* entry =
+                protocol::get_entry(header_, slot_, i);
+            wait(entry);
+            protocol::set_state(entry->state, protocol::EntryState::Empty);
+        }
+    } catch (const std::runtime_error&) {
+        // The server has stopped
+    }
+
+    protocol::get_slot(header_, slot_)->owner.store(0,
+                                                    std::memory_order_release);
+    munmap(header_, region_size_);
+}
+
+template <typename Scalar>
+size_t EvaluationClient<Scalar>::get_model_index(
+    const std::string& model_name) const {
+    for (size_t i = 0; i < header_->num_models; ++i) {
+        if (model_name == header_->models[i].name) {
+            return i;
+        }
+    }
+    throw std::runtime_error("Server does not host a model named " +
+                             model_name + ".");
+}
+
+template <typename Scalar>
+std::vector<std::string> EvaluationClient<Scalar>::get_model_names() const {
+    std::vector<std::string> names;
+    for (size_t i = 0; i < header_->num_models; ++i) {
+        names.push_back(header_->models[i].name);
+    }
+    return names;
+}
+
+template <typename Scalar>
+size_t EvaluationClient<Scalar>::get_input_size(size_t model) const {
+    if (model >= header_->num_models) {
+        throw std::runtime_error("Model index " + std::to_string(model) +
+                                 " is out of range.");
+    }
+    return header_->models[model].input_size;
+}
+
+template <typename Scalar>
+size_t EvaluationClient<Scalar>::get_output_size(size_t model) const {
+    if (model >= header_->num_models) {
+        throw std::runtime_error("Model index " + std::to_string(model) +
+                                 " is out of range.");
+    }
+    return header_->models[model].output_size;
+}
+
+template <typename Scalar>
+size_t EvaluationClient<Scalar>::get_ring_capacity() const {
+    return header_->ring_capacity;
+}
+
+template <typename Scalar>
+uint64_t EvaluationClient<Scalar>::submit(
+    size_t model, Kernel kernel, const Eigen::Ref<const Vector>& input) {
+    if (static_cast<size_t>(input.size()) != get_input_size(model)) {
+        throw std::runtime_error(
+            "Input size of model " + std::string(header_->models[model].name) +
+            " is " + std::to_string(get_input_size(model)) +
+            ", but input is of size " + std::to_string(input.size()) + ".");
+    }
+    if (!header_->running.load(std::memory_order_acquire)) {
+        throw std::runtime_error("Server has stopped.");
+    }
+
+    protocol::EntryHeader* entry = protocol::get_entry(header_, slot_, head_);
+    if (protocol::get_state(entry->state) != protocol::EntryState::Empty) {
+        throw std::runtime_error(
+            "Too many outstanding requests: at most " +
+            std::to_string(header_->ring_capacity) +
+            " requests can be submitted before collecting their results.");
+    }
+
+    entry->model = model;
+    entry->kernel = static_cast<uint32_t>(kernel);
+    Eigen::Map<Vector>(protocol::get_entry_data<Scalar>(entry), input.size()) =
+        input;
+    protocol::set_state(entry->state, protocol::EntryState::Submitted);
+    ++head_;
+
+    // Wake the server if it is sleeping. The doorbell is changed even if it
+    // is not, so that a server about to sleep notices the request.
+    header_->doorbell.fetch_add(1);
+    if (header_->server_sleeping.load()) {
+        protocol::futex_wake(&header_->doorbell);
+    }
+    return head_ - 1;
+}
+
+template <typename Scalar>
+typename EvaluationClient<Scalar>::Vector EvaluationClient<Scalar>::collect(
+    uint64_t ticket) {
+    protocol::EntryHeader* entry = protocol::get_entry(header_, slot_, ticket);
+    if (ticket >= head_ || head_ - ticket > header_->ring_capacity ||
+        protocol::get_state(entry->state) == protocol::EntryState::Empty) {
+        throw std::runtime_error("Invalid ticket " + std::to_string(ticket) +
+                                 ".");
+    }
+
+    wait(entry);
+    if (protocol::get_state(entry->state) == protocol::EntryState::Failed) {
+        Status status = static_cast<Status>(entry->status);
+        protocol::set_state(entry->state, protocol::EntryState::Empty);
+        throw std::runtime_error(std::string("Request failed: ") +
+                                 status_description(status));
+    }
+
+    const size_t n = header_->models[entry->model].input_size;
+    const size_t m = header_->models[entry->model].output_size;
+    const size_t size =
+        entry->kernel == static_cast<uint32_t>(Kernel::Jacobian) ? m * n : m;
+    Vector output = Eigen::Map<const Vector>(
+        protocol::get_entry_data<Scalar>(entry) + n, size);
+    protocol::set_state(entry->state, protocol::EntryState::Empty);
+    return output;
+}
+
+template <typename Scalar>
+typename EvaluationClient<Scalar>::Vector EvaluationClient<Scalar>::evaluate(
+    size_t model, const Eigen::Ref<const Vector>& input) {
+    return collect(submit(model, Kernel::Evaluate, input));
+}
+
+template <typename Scalar>
+typename EvaluationClient<Scalar>::Matrix EvaluationClient<Scalar>::jacobian(
+    size_t model, const Eigen::Ref<const Vector>& input) {
+    Vector J_vec = collect(submit(model, Kernel::Jacobian, input));
+    return Eigen::Map<Matrix>(J_vec.data(), get_output_size(model),
+                              get_input_size(model));
+}
+
+template <typename Scalar>
+bool EvaluationClient<Scalar>::try_map(const std::string& shm_name) {
+    int fd = shm_open(shm_name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        return false;
+    }
+
+    // The server sizes the region before initializing it, and marks it as
+    // running once it is initialized
+    struct stat st;
+    void* region = MAP_FAILED;
+    if (fstat(fd, &st) == 0 &&
+        static_cast<size_t>(st.st_size) >= sizeof(protocol::Header)) {
+        region_size_ = st.st_size;
+        region = mmap(nullptr, region_size_, PROT_READ | PROT_WRITE,
+                      MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (region == MAP_FAILED) {
+        return false;
+    }
+
+    header_ = static_cast<protocol::Header*>(region);
+    if (!header_->running.load(std::memory_order_acquire)) {
+        munmap(header_, region_size_);
+        header_ = nullptr;
+        return false;
+    }
+    return true;
+}
+
+template <typename Scalar>
+bool EvaluationClient<Scalar>::try_claim(size_t slot) {
+    std::atomic<uint32_t>& owner = protocol::get_slot(header_, slot)->owner;
+    uint32_t pid = getpid();
+    uint32_t expected = 0;
+    if (owner.compare_exchange_strong(expected, pid)) {
+        return true;
+    }
+
+    // The previous owner exited without releasing the slot
+    return expected != pid && kill(expected, 0) != 0 && errno == ESRCH &&
+           owner.compare_exchange_strong(expected, pid);
+}
+
+template <typename Scalar>
+void EvaluationClient<Scalar>::wait(protocol::EntryHeader* entry) {
+    size_t polls = 0;
+    while (true) {
+        protocol::EntryState state = protocol::get_state(entry->state);
+        if (state != protocol::EntryState::Submitted &&
+            state != protocol::EntryState::InProgress) {
+            return;
+        }
+        if (!header_->running.load(std::memory_order_acquire)) {
+            throw std::runtime_error("Server has stopped.");
+        }
+        if (++polls < spin_iterations_) {
+            protocol::cpu_relax();
+            continue;
+        }
+
+        // Announce that we are sleeping before checking the state a final
+        // time, so that the server either sees the announcement or we see
+        // its update
+        entry->client_waiting.store(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        uint32_t word = entry->state.load(std::memory_order_acquire);
+        if (word == static_cast<uint32_t>(protocol::EntryState::Submitted) ||
+            word == static_cast<uint32_t>(protocol::EntryState::InProgress)) {
+            // Time out regularly to check if the server is still running
+            protocol::futex_wait(&entry->state, word, 10000000L);
+        }
+        entry->client_waiting.store(0, std::memory_order_relaxed);
+    }
+}
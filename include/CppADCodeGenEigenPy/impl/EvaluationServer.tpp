@@ -0,0 +1,342 @@
+#pragma once
+
+template <typename Scalar>
+EvaluationServer<Scalar>::EvaluationServer(
+    const std::string& name, const std::vector<CompiledModel<Scalar>>& models,
+    const ServerOptions& options)
+    : name_(name),
+      shm_name_(protocol::get_shm_name(name)),
+      options_(options),
+      stopping_(false),
+      num_requests_(0),
+      num_batches_(0) {
+    if (models.empty()) {
+        throw std::runtime_error("Server must host at least one model.");
+    }
+    if (models.size() > protocol::MAX_MODELS) {
+        throw std::runtime_error(
+            "Server can host at most " + std::to_string(protocol::MAX_MODELS) +
+            " models, but " + std::to_string(models.size()) + " were given.");
+    }
+    if (options_.num_threads == 0 || options_.num_slots == 0 ||
+        options_.ring_capacity == 0 || options_.max_batch_size == 0) {
+        throw std::runtime_error(
+            "Number of threads, slots, ring capacity and maximum batch size "
+            "must be positive.");
+    }
+    for (size_t i = 0; i < models.size(); ++i) {
+        const std::string& model_name = models[i].get_model_name();
+        if (model_name.size() >= protocol::MAX_MODEL_NAME_LENGTH) {
+            throw std::runtime_error("Model name " + model_name +
+                                     " is too long.");
+        }
+        for (size_t j = 0; j < i; ++j) {
+            if (models[j].get_model_name() == model_name) {
+                throw std::runtime_error("Model " + model_name +
+                                         " was given more than once.");
+            }
+        }
+    }
+
+    // With a single CPU, spinning only delays the clients
+    if (std::thread::hardware_concurrency() <= 1) {
+        options_.spin_iterations = 0;
+    }
+
+    thread_models_.resize(options_.num_threads);
+    for (auto& copies : thread_models_) {
+        for (const CompiledModel<Scalar>& model : models) {
+            copies.emplace_back(new RealtimeModel<Scalar>(model));
+        }
+    }
+
+    create_shared_memory(models);
+
+    batch_.reserve(options_.max_batch_size);
+    pool_.reset(new ThreadPool(options_.num_threads, options_.cpus));
+    header_->running.store(1, std::memory_order_release);
+    dispatcher_ = std::thread(&EvaluationServer::run, this);
+}
+
+template <typename Scalar>
+EvaluationServer<Scalar>::~EvaluationServer() {
+    stop();
+}
+
+template <typename Scalar>
+void EvaluationServer<Scalar>::stop() {
+    if (stopped_) {
+        return;
+    }
+    stopped_ = true;
+
+    stopping_.store(true);
+    protocol::futex_wake(&header_->doorbell);
+    dispatcher_.join();
+
+    // Wake any clients still waiting, so that they see that the server has
+    // stopped
+    header_->running.store(0);
+    for (size_t slot = 0; slot < header_->num_slots; ++slot) {
+        for (size_t i = 0; i < header_->ring_capacity; ++i) {
+            protocol::futex_wake(
+                &protocol::get_entry(header_, slot, i)->state);
+        }
+    }
+
+    // Clients that are still connected keep their mapping of the region
+    munmap(header_, region_size_);
+    shm_unlink(shm_name_.c_str());
+}
+
+template <typename Scalar>
+bool EvaluationServer<Scalar>::is_running() const {
+    return !stopped_;
+}
+
+template <typename Scalar>
+const std::string& EvaluationServer<Scalar>::get_name() const {
+    return name_;
+}
+
+template <typename Scalar>
+size_t EvaluationServer<Scalar>::get_num_requests() const {
+    return num_requests_.load();
+}
+
+template <typename Scalar>
+size_t EvaluationServer<Scalar>::get_num_batches() const {
+    return num_batches_.load();
+}
+
+template <typename Scalar>
+void EvaluationServer<Scalar>::create_shared_memory(
+    const std::vector<CompiledModel<Scalar>>& models) {
+    // Replace the region if it was left behind by a server that did not
+    // shut down cleanly. A server that is still starting may not have
+    // written its header yet, so the region is only replaced once its
+    // header names a process that no longer exists, and an incomplete
+    // header is given a moment to be written.
+    const int max_attempts = 100;
+    int fd = -1;
+    for (int attempt = 0;; ++attempt) {
+        fd = shm_open(shm_name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd >= 0 || errno != EEXIST) {
+            break;
+        }
+
+        int old_fd = shm_open(shm_name_.c_str(), O_RDONLY, 0);
+        protocol::HeaderPrefix old_header;
+        bool valid = old_fd >= 0 &&
+                     read(old_fd, &old_header, sizeof(old_header)) ==
+                         sizeof(old_header) &&
+                     old_header.magic == protocol::MAGIC;
+        if (old_fd >= 0) {
+            close(old_fd);
+        }
+        if (valid && kill(old_header.server_pid, 0) != 0 && errno == ESRCH) {
+            shm_unlink(shm_name_.c_str());
+            continue;
+        }
+        if (valid) {
+            throw std::runtime_error("A server named " + name_ +
+                                     " is already running.");
+        }
+        if (attempt + 1 >= max_attempts) {
+            throw std::runtime_error(
+                "A server named " + name_ +
+                " is already running or starting. If it is not, remove "
+                "/dev/shm" + shm_name_ + ".");
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    if (fd < 0) {
+        throw std::runtime_error("Failed to create shared memory for server " +
+                                 name_ + ": " + std::strerror(errno));
+    }
+
+    // Each entry must be able to hold the input and Jacobian of any model
+    size_t entry_data_size = 0;
+    for (const CompiledModel<Scalar>& model : models) {
+        size_t n = model.get_input_size();
+        size_t m = model.get_output_size();
+        entry_data_size = std::max(entry_data_size, n + std::max(m, m * n));
+    }
+    size_t entry_size =
+        protocol::align_to_cache_line(sizeof(protocol::EntryHeader)) +
+        protocol::align_to_cache_line(entry_data_size * sizeof(Scalar));
+    size_t slot_size =
+        protocol::align_to_cache_line(sizeof(protocol::SlotHeader)) +
+        options_.ring_capacity * entry_size;
+
+    protocol::Header header;
+    header.num_slots = options_.num_slots;
+    header.slot_size = slot_size;
+    region_size_ = protocol::get_region_size(header);
+
+    void* region = MAP_FAILED;
+    if (ftruncate(fd, region_size_) == 0) {
+        region = mmap(nullptr, region_size_, PROT_READ | PROT_WRITE,
+                      MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (region == MAP_FAILED) {
+        shm_unlink(shm_name_.c_str());
+        throw std::runtime_error("Failed to map shared memory for server " +
+                                 name_ + ": " + std::strerror(errno));
+    }
+
+    header_ = new (region) protocol::Header();
+    header_->magic = protocol::MAGIC;
+    header_->version = protocol::VERSION;
+    header_->scalar_size = sizeof(Scalar);
+    header_->server_pid = getpid();
+    header_->num_models = models.size();
+    header_->num_slots = options_.num_slots;
+    header_->ring_capacity = options_.ring_capacity;
+    header_->entry_data_size = entry_data_size;
+    header_->entry_size = entry_size;
+    header_->slot_size = slot_size;
+    for (size_t i = 0; i < models.size(); ++i) {
+        protocol::ModelInfo& info = header_->models[i];
+        std::strncpy(info.name, models[i].get_model_name().c_str(),
+                     protocol::MAX_MODEL_NAME_LENGTH - 1);
+        info.input_size = models[i].get_input_size();
+        info.output_size = models[i].get_output_size();
+    }
+
+    for (size_t slot = 0; slot < header_->num_slots; ++slot) {
+        new (protocol::get_slot(header_, slot)) protocol::SlotHeader();
+        for (size_t i = 0; i < header_->ring_capacity; ++i) {
+            new (protocol::get_entry(header_, slot, i)) protocol::EntryHeader();
+        }
+    }
+}
+
+template <typename Scalar>
+void EvaluationServer<Scalar>::run() {
+    // The dispatching thread is also the first thread of the pool
+    if (!options_.cpus.empty()) {
+        try {
+            pin_current_thread(options_.cpus[0]);
+        } catch (const std::runtime_error&) {
+        }
+    }
+
+    size_t idle_polls = 0;
+    while (!stopping_.load(std::memory_order_relaxed)) {
+        // The doorbell is read before polling, so that a request submitted
+        // after polling changes it and prevents the futex from sleeping
+        uint32_t doorbell = header_->doorbell.load();
+        collect();
+        if (batch_.empty()) {
+            if (++idle_polls < options_.spin_iterations) {
+                protocol::cpu_relax();
+                continue;
+            }
+            header_->server_sleeping.store(1);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            collect();
+            if (batch_.empty()) {
+                protocol::futex_wait(&header_->doorbell, doorbell,
+                                     SLEEP_TIMEOUT_NS);
+            }
+            header_->server_sleeping.store(0);
+            if (batch_.empty()) {
+                continue;
+            }
+        }
+        idle_polls = 0;
+
+        // Group requests for the same model and kernel, so that each thread
+        // runs the same code on consecutive requests
+        std::stable_sort(
+            batch_.begin(), batch_.end(),
+            [](const protocol::EntryHeader* a, const protocol::EntryHeader* b) {
+                return a->model < b->model ||
+                       (a->model == b->model && a->kernel < b->kernel);
+            });
+        pool_->parallel_for(
+            batch_.size(), [this](size_t begin, size_t end,
+                                  size_t thread_index) {
+                process(begin, end, thread_index);
+            });
+
+        num_requests_.fetch_add(batch_.size(), std::memory_order_relaxed);
+        num_batches_.fetch_add(1, std::memory_order_relaxed);
+        batch_.clear();
+    }
+}
+
+template <typename Scalar>
+void EvaluationServer<Scalar>::collect() {
+    // Start from a different slot each time, so that no client is starved
+    // when batches are full
+    const size_t num_slots = header_->num_slots;
+    for (size_t k = 0; k < num_slots; ++k) {
+        size_t slot = (next_slot_ + k) % num_slots;
+        protocol::SlotHeader* slot_header = protocol::get_slot(header_, slot);
+        if (!slot_header->owner.load(std::memory_order_acquire)) {
+            continue;
+        }
+
+        // Clients submit to their ring in order, so requests are picked up
+        // from where the last poll of the slot stopped
+        uint64_t index = slot_header->tail.load(std::memory_order_relaxed);
+        while (batch_.size() < options_.max_batch_size) {
+            protocol::EntryHeader* entry =
+                protocol::get_entry(header_, slot, index);
+            if (protocol::get_state(entry->state) !=
+                protocol::EntryState::Submitted) {
+                break;
+            }
+            protocol::set_state(entry->state,
+                                protocol::EntryState::InProgress);
+            batch_.push_back(entry);
+            ++index;
+        }
+        slot_header->tail.store(index, std::memory_order_release);
+        if (batch_.size() == options_.max_batch_size) {
+            next_slot_ = (slot + 1) % num_slots;
+            return;
+        }
+    }
+}
+
+template <typename Scalar>
+void EvaluationServer<Scalar>::process(size_t begin, size_t end,
+                                       size_t thread_index) {
+    for (size_t i = begin; i < end; ++i) {
+        protocol::EntryHeader* entry = batch_[i];
+        Status status = Status::InvalidRequest;
+        if (entry->model < header_->num_models) {
+            RealtimeModel<Scalar>& model =
+                *thread_models_[thread_index][entry->model];
+            const size_t n = model.get_input_size();
+            const size_t m = model.get_output_size();
+            Scalar* data = protocol::get_entry_data<Scalar>(entry);
+            Eigen::Map<const Vector> input(data, n);
+
+            if (entry->kernel == static_cast<uint32_t>(Kernel::Evaluate)) {
+                Eigen::Map<Vector> output(data + n, m);
+                status = model.evaluate(input, output);
+            } else if (entry->kernel ==
+                       static_cast<uint32_t>(Kernel::Jacobian)) {
+                Eigen::Map<Matrix> jacobian(data + n, m, n);
+                status = model.jacobian(input, jacobian);
+            }
+        }
+
+        entry->status = static_cast<uint32_t>(status);
+        protocol::set_state(entry->state, status == Status::Success
+                                              ? protocol::EntryState::Done
+                                              : protocol::EntryState::Failed);
+
+        // Pairs with the fence in the client between announcing that it is
+        // waiting and checking the state
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (entry->client_waiting.load(std::memory_order_relaxed)) {
+            protocol::futex_wake(&entry->state);
+        }
+    }
+}
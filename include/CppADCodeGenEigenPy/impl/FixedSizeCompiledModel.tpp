@@ -0,0 +1,202 @@
+#pragma once
+
+template <typename Scalar, int NumInput, int NumOutput, int NumParam>
+FixedSizeCompiledModel<Scalar, NumInput, NumOutput, NumParam>::
+    FixedSizeCompiledModel(const std::string& model_name,
+                           const std::string& library_generic_path)
+    : model_(model_name, library_generic_path) {
+    if (model_.get_input_size() != static_cast<size_t>(NumCombined) ||
+        model_.get_output_size() != static_cast<size_t>(NumOutput)) {
+        throw std::runtime_error(
+            "Model " + model_name + " has " +
+            std::to_string(model_.get_input_size()) + " inputs and " +
+            std::to_string(model_.get_output_size()) +
+            " outputs, but expected " + std::to_string(NumCombined) +
+            " inputs (including parameters) and " +
+            std::to_string(NumOutput) + " outputs.");
+    }
+    CppAD::cg::GenericModel<Scalar>& generic_model = model_.get_generic_model();
+    jacobian_available_ = generic_model.isJacobianAvailable();
+    hessian_available_ = generic_model.isHessianAvailable();
+
+    std::vector<size_t> rows, cols;
+    if (!jacobian_available_ && generic_model.isSparseJacobianAvailable()) {
+        sparse_jacobian_ = jacobian_available_ = true;
+        generic_model.JacobianSparsity(rows, cols);
+        jacobian_nnz_ = rows.size();
+    }
+    if (!hessian_available_ && generic_model.isSparseHessianAvailable()) {
+        sparse_hessian_ = hessian_available_ = true;
+        generic_model.HessianSparsity(rows, cols);
+        hessian_nnz_ = rows.size();
+    }
+}
+
+template <typename Scalar, int NumInput, int NumOutput, int NumParam>
+typename FixedSizeCompiledModel<Scalar, NumInput, NumOutput, NumParam>::Output
+FixedSizeCompiledModel<Scalar, NumInput, NumOutput, NumParam>::evaluate(
+    const Input& input) const {
+    static_assert(NumParam == 0,
+                  "Model has parameters: use the overload accepting them.");
+    return evaluate_combined(input);
+}
+
+template <typename Scalar, int NumInput, int NumOutput, int NumParam>
+typename FixedSizeCompiledModel<Scalar, NumInput, NumOutput, NumParam>::Output
+FixedSizeCompiledModel<Scalar, NumInput, NumOutput, NumParam>::evaluate(
+    const Input& input, const Parameters& parameters) const {
+    static_assert(NumParam > 0,
+                  "Model has no parameters: use the overload without them.");
+    return evaluate_combined(combine(input, parameters));
+}
+
+template <typename Scalar, int NumInput, int NumOutput, int NumParam>
+typename FixedSizeCompiledModel<Scalar, NumInput, NumOutput,
+                                NumParam>::Jacobian
+FixedSizeCompiledModel<Scalar, NumInput, NumOutput, NumParam>::jacobian(
+    const Input& input) const {
+    static_assert(NumParam == 0,
+                  "Model has parameters: use the overload accepting them.");
+    return jacobian_combined(input);
+}
+
+template <typename Scalar, int NumInput, int NumOutput, int NumParam>
+typename FixedSizeCompiledModel<Scalar, NumInput, NumOutput,
+                                NumParam>::Jacobian
+FixedSizeCompiledModel<Scalar, NumInput, NumOutput, NumParam>::jacobian(
+    const Input& input, const Parameters& parameters) const {
+    static_assert(NumParam > 0,
+                  "Model has no parameters: use the overload without them.");
+    return jacobian_combined(combine(input, parameters));
+}
+
+template <typename Scalar, int NumInput, int NumOutput, int NumParam>
+typename FixedSizeCompiledModel<Scalar, NumInput, NumOutput, NumParam>::Hessian
+FixedSizeCompiledModel<Scalar, NumInput, NumOutput, NumParam>::hessian(
+    const Input& input, size_t output_dim) const {
+    static_assert(NumParam == 0,
+                  "Model has parameters: use the overload accepting them.");
+    return hessian_combined(input, output_dim);
+}
+
+template <typename Scalar, int NumInput, int NumOutput, int NumParam>
+typename FixedSizeCompiledModel<Scalar, NumInput, NumOutput, NumParam>::Hessian
+FixedSizeCompiledModel<Scalar, NumInput, NumOutput, NumParam>::hessian(
+    const Input& input, const Parameters& parameters,
+    size_t output_dim) const {
+    static_assert(NumParam > 0,
+                  "Model has no parameters: use the overload without them.");
+    return hessian_combined(combine(input, parameters), output_dim);
+}
+
+template <typename Scalar, int NumInput, int NumOutput, int NumParam>
+const CompiledModel<Scalar>& FixedSizeCompiledModel<
+    Scalar, NumInput, NumOutput, NumParam>::get_compiled_model() const {
+    return model_;
+}
+
+template <typename Scalar, int NumInput, int NumOutput, int NumParam>
+typename FixedSizeCompiledModel<Scalar, NumInput, NumOutput,
+                                NumParam>::CombinedInput
+FixedSizeCompiledModel<Scalar, NumInput, NumOutput, NumParam>::combine(
+    const Input& input, const Parameters& parameters) const {
+    CombinedInput xp;
+    xp.template head<NumInput>() = input;
+    xp.template tail<NumParam>() = parameters;
+    return xp;
+}
+
+template <typename Scalar, int NumInput, int NumOutput, int NumParam>
+typename FixedSizeCompiledModel<Scalar, NumInput, NumOutput, NumParam>::Output
+FixedSizeCompiledModel<Scalar, NumInput, NumOutput,
+                       NumParam>::evaluate_combined(const CombinedInput& xp)
+    const {
+    Output output;
+    model_.get_generic_model().ForwardZero(
+        CppAD::cg::ArrayView<const Scalar>(xp.data(), NumCombined),
+        CppAD::cg::ArrayView<Scalar>(output.data(), NumOutput));
+    return output;
+}
+
+template <typename Scalar, int NumInput, int NumOutput, int NumParam>
+typename FixedSizeCompiledModel<Scalar, NumInput, NumOutput,
+                                NumParam>::Jacobian
+FixedSizeCompiledModel<Scalar, NumInput, NumOutput,
+                       NumParam>::jacobian_combined(const CombinedInput& xp)
+    const {
+    if (!jacobian_available_) {
+        throw std::runtime_error(
+            "Jacobian is not available: compiled model must be at least "
+            "first-order.");
+    }
+
+    // The generated code computes the Jacobian with respect to both the
+    // input and parameters, stored in row-major order
+    RowMajorMatrix<NumOutput, NumCombined> J;
+    if (sparse_jacobian_) {
+        // The sparsity pattern has at most as many elements as the
+        // Jacobian, so they fit in a buffer of its size
+        Eigen::Matrix<Scalar, NumOutput * NumCombined, 1> J_nnz;
+        size_t const* rows;
+        size_t const* cols;
+        model_.get_generic_model().SparseJacobian(
+            CppAD::cg::ArrayView<const Scalar>(xp.data(), NumCombined),
+            CppAD::cg::ArrayView<Scalar>(J_nnz.data(), jacobian_nnz_), &rows,
+            &cols);
+        J.setZero();
+        for (size_t k = 0; k < jacobian_nnz_; ++k) {
+            J(rows[k], cols[k]) = J_nnz(k);
+        }
+    } else {
+        model_.get_generic_model().Jacobian(
+            CppAD::cg::ArrayView<const Scalar>(xp.data(), NumCombined),
+            CppAD::cg::ArrayView<Scalar>(J.data(), NumOutput * NumCombined));
+    }
+    return J.template leftCols<NumInput>();
+}
+
+template <typename Scalar, int NumInput, int NumOutput, int NumParam>
+typename FixedSizeCompiledModel<Scalar, NumInput, NumOutput, NumParam>::Hessian
+FixedSizeCompiledModel<Scalar, NumInput, NumOutput,
+                       NumParam>::hessian_combined(const CombinedInput& xp,
+                                                   size_t output_dim) const {
+    if (!hessian_available_) {
+        throw std::runtime_error(
+            "Hessian is not available: compiled model must be "
+            "second-order.");
+    }
+    if (output_dim >= static_cast<size_t>(NumOutput)) {
+        throw std::runtime_error("Specified output dimension for Hessian is " +
+                                 std::to_string(output_dim) +
+                                 ", but model has only " +
+                                 std::to_string(NumOutput) + " outputs.");
+    }
+
+    // See CompiledModel::hessian for why the weighted overload is used
+    Output w = Output::Zero();
+    w(output_dim) = 1.0;
+    RowMajorMatrix<NumCombined, NumCombined> H;
+    if (sparse_hessian_) {
+        // The sparsity pattern of a symmetric Hessian only covers the lower
+        // triangle, so each element is mirrored
+        Eigen::Matrix<Scalar, NumCombined * NumCombined, 1> H_nnz;
+        size_t const* rows;
+        size_t const* cols;
+        model_.get_generic_model().SparseHessian(
+            CppAD::cg::ArrayView<const Scalar>(xp.data(), NumCombined),
+            CppAD::cg::ArrayView<const Scalar>(w.data(), NumOutput),
+            CppAD::cg::ArrayView<Scalar>(H_nnz.data(), hessian_nnz_), &rows,
+            &cols);
+        H.setZero();
+        for (size_t k = 0; k < hessian_nnz_; ++k) {
+            H(rows[k], cols[k]) = H_nnz(k);
+            H(cols[k], rows[k]) = H_nnz(k);
+        }
+    } else {
+        model_.get_generic_model().Hessian(
+            CppAD::cg::ArrayView<const Scalar>(xp.data(), NumCombined),
+            CppAD::cg::ArrayView<const Scalar>(w.data(), NumOutput),
+            CppAD::cg::ArrayView<Scalar>(H.data(), NumCombined * NumCombined));
+    }
+    return H.template topLeftCorner<NumInput, NumInput>();
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+template <typename Scalar>
+ModelGroup<Scalar>::ModelGroup(size_t input_size, size_t num_threads)
+    : input_size_(input_size), pool_(new ThreadPool(num_threads)) {}
+
+template <typename Scalar>
+void ModelGroup<Scalar>::add_model(const std::string& name,
+                                   const CompiledModel<Scalar>& model,
+                                   const std::vector<size_t>& input_indices,
+                                   bool jacobian,
+                                   const std::vector<size_t>& hessian_outputs) {
+    // Results are looked up by name
+    for (const Result& result : results_) {
+        if (result.name == name) {
+            throw std::runtime_error("Group already has a model named " +
+                                     name + ".");
+        }
+    }
+    if (input_indices.size() != model.get_input_size()) {
+        throw std::runtime_error(
+            "Model " + name + " has input size " +
+            std::to_string(model.get_input_size()) + ", but " +
+            std::to_string(input_indices.size()) + " input indices given.");
+    }
+    for (size_t index : input_indices) {
+        if (index >= input_size_) {
+            throw std::runtime_error(
+                "Input index " + std::to_string(index) + " of model " + name +
+                " exceeds the group input size " +
+                std::to_string(input_size_) + ".");
+        }
+    }
+    for (size_t output_dim : hessian_outputs) {
+        if (output_dim >= model.get_output_size()) {
+            throw std::runtime_error(
+                "Hessian output dimension " + std::to_string(output_dim) +
+                " of model " + name + " exceeds its output size " +
+                std::to_string(model.get_output_size()) + ".");
+        }
+    }
+
+    members_.push_back(Member{model, input_indices, jacobian,
+                              hessian_outputs,
+                              Vector(model.get_input_size())});
+    Result result;
+    result.name = name;
+    results_.push_back(result);
+}
+
+template <typename Scalar>
+const std::vector<typename ModelGroup<Scalar>::Result>&
+ModelGroup<Scalar>::evaluate(const Eigen::Ref<const Vector>& input) {
+    if (static_cast<size_t>(input.size()) != input_size_) {
+        throw std::runtime_error("Group input size is " +
+                                 std::to_string(input_size_) +
+                                 ", but input is of size " +
+                                 std::to_string(input.size()) + ".");
+    }
+
+    // Each member has its own copy of its model, so members can be
+    // evaluated concurrently
+    pool_->parallel_for(members_.size(),
+                        [&](size_t begin, size_t end, size_t thread_index) {
+                            for (size_t i = begin; i < end; ++i) {
+                                evaluate_member(i, input);
+                            }
+                        });
+    return results_;
+}
+
+template <typename Scalar>
+size_t ModelGroup<Scalar>::get_input_size() const {
+    return input_size_;
+}
+
+template <typename Scalar>
+size_t ModelGroup<Scalar>::get_num_models() const {
+    return members_.size();
+}
+
+template <typename Scalar>
+size_t ModelGroup<Scalar>::get_num_threads() const {
+    return pool_->get_num_threads();
+}
+
+template <typename Scalar>
+void ModelGroup<Scalar>::evaluate_member(
+    size_t index, const Eigen::Ref<const Vector>& input) {
+    Member& member = members_[index];
+    Result& result = results_[index];
+
+    for (size_t i = 0; i < member.input_indices.size(); ++i) {
+        member.input(i) = input(member.input_indices[i]);
+    }
+
+    result.value = member.model.evaluate(member.input);
+    if (member.jacobian) {
+        result.jacobian = member.model.jacobian(member.input);
+    }
+    result.hessians.resize(member.hessian_outputs.size());
+    for (size_t i = 0; i < member.hessian_outputs.size(); ++i) {
+        result.hessians[i] =
+            member.model.hessian(member.input, member.hessian_outputs[i]);
+    }
+}
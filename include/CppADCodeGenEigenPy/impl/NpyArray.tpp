@@ -0,0 +1,275 @@
+#pragma once
+
+template <typename Scalar>
+NpyArray<Scalar>::NpyArray(const std::string& path, bool writable)
+    : path_(path), writable_(writable) {
+    fd_ = ::open(path.c_str(), writable ? O_RDWR : O_RDONLY);
+    if (fd_ < 0) {
+        error("cannot open file: " + std::string(std::strerror(errno)));
+    }
+    read_header();
+    compute_rows();
+    map();
+}
+
+template <typename Scalar>
+NpyArray<Scalar>::NpyArray(const std::string& path,
+                           const std::vector<size_t>& shape)
+    : path_(path), shape_(shape), writable_(true) {
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd_ < 0) {
+        error("cannot create file: " + std::string(std::strerror(errno)));
+    }
+    compute_rows();
+    write_header();
+    if (::ftruncate(fd_, data_offset_ + rows_ * row_size_ * sizeof(Scalar)) !=
+        0) {
+        error("cannot resize file: " + std::string(std::strerror(errno)));
+    }
+    map();
+}
+
+template <typename Scalar>
+NpyArray<Scalar>::~NpyArray() {
+    if (mapping_ != nullptr) {
+        ::munmap(mapping_, mapping_size_);
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+}
+
+template <typename Scalar>
+const std::vector<size_t>& NpyArray<Scalar>::get_shape() const {
+    return shape_;
+}
+
+template <typename Scalar>
+size_t NpyArray<Scalar>::get_rows() const {
+    return rows_;
+}
+
+template <typename Scalar>
+size_t NpyArray<Scalar>::get_row_size() const {
+    return row_size_;
+}
+
+template <typename Scalar>
+Scalar* NpyArray<Scalar>::row(size_t row) {
+    return reinterpret_cast<Scalar*>(static_cast<char*>(mapping_) +
+                                     data_offset_) +
+           row * row_size_;
+}
+
+template <typename Scalar>
+const Scalar* NpyArray<Scalar>::row(size_t row) const {
+    return reinterpret_cast<const Scalar*>(static_cast<char*>(mapping_) +
+                                           data_offset_) +
+           row * row_size_;
+}
+
+template <typename Scalar>
+void NpyArray<Scalar>::prefetch(size_t begin, size_t end) const {
+    advise(begin, end, MADV_WILLNEED);
+}
+
+template <typename Scalar>
+void NpyArray<Scalar>::release(size_t begin, size_t end) const {
+    if (writable_) {
+        // Schedule dirty pages to be written back; dropping the pages from
+        // the mapping below does not lose them, since they remain in the
+        // page cache.
+        advise(begin, end, -1);
+    }
+    advise(begin, end, MADV_DONTNEED);
+}
+
+template <typename Scalar>
+void NpyArray<Scalar>::map() {
+    mapping_size_ = data_offset_ + rows_ * row_size_ * sizeof(Scalar);
+    int prot = writable_ ? PROT_READ | PROT_WRITE : PROT_READ;
+    mapping_ = ::mmap(nullptr, mapping_size_, prot, MAP_SHARED, fd_, 0);
+    if (mapping_ == MAP_FAILED) {
+        mapping_ = nullptr;
+        error("cannot map file: " + std::string(std::strerror(errno)));
+    }
+}
+
+template <typename Scalar>
+void NpyArray<Scalar>::advise(size_t begin, size_t end, int advice) const {
+    end = std::min(end, rows_);
+    if (begin >= end) {
+        return;
+    }
+
+    // madvise requires a page-aligned start address. Rounding out to whole
+    // pages is safe, since the hints do not affect the data.
+    const size_t page_size = ::sysconf(_SC_PAGESIZE);
+    size_t start = data_offset_ + begin * row_size_ * sizeof(Scalar);
+    size_t stop = data_offset_ + end * row_size_ * sizeof(Scalar);
+    start -= start % page_size;
+
+    char* addr = static_cast<char*>(mapping_) + start;
+    if (advice < 0) {
+        ::msync(addr, stop - start, MS_ASYNC);
+    } else {
+        // The advice is only a hint, so failure is not an error
+        ::madvise(addr, stop - start, advice);
+    }
+}
+
+template <typename Scalar>
+void NpyArray<Scalar>::read_header() {
+    // Magic string, major and minor version, then the header length, which
+    // is two bytes for version 1 and four bytes for later versions
+    unsigned char preamble[12];
+    if (::pread(fd_, preamble, 10, 0) != 10 ||
+        std::memcmp(preamble, "\x93NUMPY", 6) != 0) {
+        error("not a .npy file");
+    }
+    size_t header_len;
+    size_t header_start;
+    if (preamble[6] == 1) {
+        header_len = preamble[8] | (preamble[9] << 8);
+        header_start = 10;
+    } else {
+        if (::pread(fd_, preamble + 10, 2, 10) != 2) {
+            error("truncated header");
+        }
+        header_len = preamble[8] | (preamble[9] << 8) | (preamble[10] << 16) |
+                     (static_cast<size_t>(preamble[11]) << 24);
+        header_start = 12;
+    }
+    data_offset_ = header_start + header_len;
+
+    std::string header(header_len, '\0');
+    if (::pread(fd_, &header[0], header_len, header_start) !=
+        static_cast<ssize_t>(header_len)) {
+        error("truncated header");
+    }
+
+    // The header is a Python dict literal with keys descr, fortran_order and
+    // shape
+    size_t pos = header.find("'descr'");
+    if (pos == std::string::npos) {
+        error("header has no descr");
+    }
+    size_t start = header.find('\'', header.find(':', pos)) + 1;
+    std::string file_descr =
+        header.substr(start, header.find('\'', start) - start);
+    if (file_descr != descr()) {
+        error("array has type " + file_descr + ", but " + descr() +
+              " is required");
+    }
+
+    pos = header.find("'fortran_order'");
+    if (pos == std::string::npos) {
+        error("header has no fortran_order");
+    }
+    start = header.find_first_not_of(" ", header.find(':', pos) + 1);
+    if (header.compare(start, 5, "False") != 0) {
+        error("only C-ordered arrays are supported");
+    }
+
+    pos = header.find("'shape'");
+    if (pos == std::string::npos) {
+        error("header has no shape");
+    }
+    start = header.find('(', pos) + 1;
+    size_t stop = header.find(')', start);
+    std::string dims = header.substr(start, stop - start);
+    shape_.clear();
+    size_t i = 0;
+    while (i < dims.size()) {
+        size_t next = dims.find(',', i);
+        if (next == std::string::npos) {
+            next = dims.size();
+        }
+        std::string dim = dims.substr(i, next - i);
+        if (dim.find_first_not_of(" ") != std::string::npos) {
+            shape_.push_back(std::stoul(dim));
+        }
+        i = next + 1;
+    }
+
+    struct stat st;
+    ::fstat(fd_, &st);
+    size_t num_elements = 1;
+    for (size_t dim : shape_) {
+        num_elements *= dim;
+    }
+    if (static_cast<size_t>(st.st_size) <
+        data_offset_ + num_elements * sizeof(Scalar)) {
+        error("file is smaller than its shape requires");
+    }
+}
+
+template <typename Scalar>
+void NpyArray<Scalar>::write_header() {
+    std::string shape = "(";
+    for (size_t dim : shape_) {
+        shape += std::to_string(dim) + ", ";
+    }
+    if (shape_.size() > 1) {
+        shape.resize(shape.size() - 1);
+        shape.back() = ')';
+    } else if (shape_.size() == 1) {
+        shape.back() = ')';
+    } else {
+        shape += ')';
+    }
+    std::string header = "{'descr': '" + descr() +
+                         "', 'fortran_order': False, 'shape': " + shape +
+                         ", }";
+
+    // Version 1.0 header, padded with spaces and terminated by a newline so
+    // that the data is 64-byte aligned
+    const size_t preamble_len = 10;
+    size_t total = preamble_len + header.size() + 1;
+    header.append((64 - total % 64) % 64, ' ');
+    header += '\n';
+
+    std::string preamble("\x93NUMPY\x01\x00", 8);
+    preamble += static_cast<char>(header.size() & 0xff);
+    preamble += static_cast<char>((header.size() >> 8) & 0xff);
+
+    std::string contents = preamble + header;
+    data_offset_ = contents.size();
+    if (::pwrite(fd_, contents.data(), contents.size(), 0) !=
+        static_cast<ssize_t>(contents.size())) {
+        error("cannot write header: " + std::string(std::strerror(errno)));
+    }
+}
+
+template <typename Scalar>
+void NpyArray<Scalar>::compute_rows() {
+    rows_ = shape_.empty() ? 1 : shape_[0];
+    row_size_ = 1;
+    for (size_t i = 1; i < shape_.size(); ++i) {
+        row_size_ *= shape_[i];
+    }
+}
+
+template <typename Scalar>
+void NpyArray<Scalar>::error(const std::string& msg) {
+    // Errors only occur during construction, in which case the destructor
+    // will not run
+    if (mapping_ != nullptr) {
+        ::munmap(mapping_, mapping_size_);
+        mapping_ = nullptr;
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    throw std::runtime_error("Error with .npy file " + path_ + ": " + msg);
+}
+
+template <typename Scalar>
+std::string NpyArray<Scalar>::descr() {
+    static_assert(std::is_floating_point<Scalar>::value,
+                  "NpyArray only supports floating point types.");
+    static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__,
+                  "NpyArray only supports little-endian systems.");
+    return "<f" + std::to_string(sizeof(Scalar));
+}
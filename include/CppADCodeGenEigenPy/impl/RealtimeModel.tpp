@@ -0,0 +1,181 @@
+#pragma once
+
+template <typename Scalar>
+RealtimeModel<Scalar>::RealtimeModel(const CompiledModel<Scalar>& model)
+    : model_(model),
+      generic_model_(model_.get_generic_model()),
+      input_size_(model_.get_input_size()),
+      output_size_(model_.get_output_size()),
+      jacobian_available_(generic_model_.isJacobianAvailable()),
+      hessian_available_(generic_model_.isHessianAvailable()),
+      xp_(Vector::Zero(input_size_)),
+      w_(Vector::Zero(output_size_)) {
+    std::vector<size_t> rows, cols;
+    if (!jacobian_available_ && generic_model_.isSparseJacobianAvailable()) {
+        sparse_jacobian_ = jacobian_available_ = true;
+        generic_model_.JacobianSparsity(rows, cols);
+        J_nnz_ = Vector::Zero(rows.size());
+    }
+    if (!hessian_available_ && generic_model_.isSparseHessianAvailable()) {
+        sparse_hessian_ = hessian_available_ = true;
+        generic_model_.HessianSparsity(rows, cols);
+        H_nnz_ = Vector::Zero(rows.size());
+    }
+    if (jacobian_available_) {
+        J_vec_ = Vector::Zero(output_size_ * input_size_);
+    }
+    if (hessian_available_) {
+        H_vec_ = Vector::Zero(input_size_ * input_size_);
+    }
+}
+
+template <typename Scalar>
+Status RealtimeModel<Scalar>::evaluate(const Eigen::Ref<const Vector>& input,
+                                       Eigen::Ref<Vector> output) noexcept {
+    return evaluate(input, no_parameters(), output);
+}
+
+template <typename Scalar>
+Status RealtimeModel<Scalar>::evaluate(
+    const Eigen::Ref<const Vector>& input,
+    const Eigen::Ref<const Vector>& parameters,
+    Eigen::Ref<Vector> output) noexcept {
+    if (!set_input(input, parameters)) {
+        return Status::InputSizeMismatch;
+    }
+    if (static_cast<size_t>(output.size()) != output_size_) {
+        return Status::OutputSizeMismatch;
+    }
+
+    // The output is contiguous, so it can be written directly
+    generic_model_.ForwardZero(
+        CppAD::cg::ArrayView<const Scalar>(xp_.data(), xp_.size()),
+        CppAD::cg::ArrayView<Scalar>(output.data(), output.size()));
+    return Status::Success;
+}
+
+template <typename Scalar>
+Status RealtimeModel<Scalar>::jacobian(const Eigen::Ref<const Vector>& input,
+                                       Eigen::Ref<Matrix> jacobian) noexcept {
+    return this->jacobian(input, no_parameters(), jacobian);
+}
+
+template <typename Scalar>
+Status RealtimeModel<Scalar>::jacobian(
+    const Eigen::Ref<const Vector>& input,
+    const Eigen::Ref<const Vector>& parameters,
+    Eigen::Ref<Matrix> jacobian) noexcept {
+    if (!jacobian_available_) {
+        return Status::DerivativeUnavailable;
+    }
+    if (!set_input(input, parameters)) {
+        return Status::InputSizeMismatch;
+    }
+    if (jacobian.rows() != static_cast<Eigen::Index>(output_size_) ||
+        jacobian.cols() != input.size()) {
+        return Status::OutputSizeMismatch;
+    }
+
+    if (sparse_jacobian_) {
+        size_t const* rows;
+        size_t const* cols;
+        generic_model_.SparseJacobian(
+            CppAD::cg::ArrayView<const Scalar>(xp_.data(), xp_.size()),
+            CppAD::cg::ArrayView<Scalar>(J_nnz_.data(), J_nnz_.size()),
+            &rows, &cols);
+        for (Eigen::Index k = 0; k < J_nnz_.size(); ++k) {
+            J_vec_(rows[k] * input_size_ + cols[k]) = J_nnz_(k);
+        }
+    } else {
+        generic_model_.Jacobian(
+            CppAD::cg::ArrayView<const Scalar>(xp_.data(), xp_.size()),
+            CppAD::cg::ArrayView<Scalar>(J_vec_.data(), J_vec_.size()));
+    }
+    Eigen::Map<const Matrix> J(J_vec_.data(), output_size_, input_size_);
+    jacobian = J.leftCols(input.size());
+    return Status::Success;
+}
+
+template <typename Scalar>
+Status RealtimeModel<Scalar>::hessian(const Eigen::Ref<const Vector>& input,
+                                      size_t output_dim,
+                                      Eigen::Ref<Matrix> hessian) noexcept {
+    return this->hessian(input, no_parameters(), output_dim, hessian);
+}
+
+template <typename Scalar>
+Status RealtimeModel<Scalar>::hessian(
+    const Eigen::Ref<const Vector>& input,
+    const Eigen::Ref<const Vector>& parameters, size_t output_dim,
+    Eigen::Ref<Matrix> hessian) noexcept {
+    if (!hessian_available_) {
+        return Status::DerivativeUnavailable;
+    }
+    if (output_dim >= output_size_) {
+        return Status::InvalidOutputDimension;
+    }
+    if (!set_input(input, parameters)) {
+        return Status::InputSizeMismatch;
+    }
+    if (hessian.rows() != input.size() || hessian.cols() != input.size()) {
+        return Status::OutputSizeMismatch;
+    }
+
+    // w_ is kept zeroed between calls, so only the selected output needs to
+    // be set (see CompiledModel::hessian for why the weighted overload is
+    // used)
+    w_(output_dim) = 1.0;
+    if (sparse_hessian_) {
+        // The sparsity pattern of a symmetric Hessian only covers the lower
+        // triangle, so each element is mirrored
+        size_t const* rows;
+        size_t const* cols;
+        generic_model_.SparseHessian(
+            CppAD::cg::ArrayView<const Scalar>(xp_.data(), xp_.size()),
+            CppAD::cg::ArrayView<const Scalar>(w_.data(), w_.size()),
+            CppAD::cg::ArrayView<Scalar>(H_nnz_.data(), H_nnz_.size()), &rows,
+            &cols);
+        for (Eigen::Index k = 0; k < H_nnz_.size(); ++k) {
+            H_vec_(rows[k] * input_size_ + cols[k]) = H_nnz_(k);
+            H_vec_(cols[k] * input_size_ + rows[k]) = H_nnz_(k);
+        }
+    } else {
+        generic_model_.Hessian(
+            CppAD::cg::ArrayView<const Scalar>(xp_.data(), xp_.size()),
+            CppAD::cg::ArrayView<const Scalar>(w_.data(), w_.size()),
+            CppAD::cg::ArrayView<Scalar>(H_vec_.data(), H_vec_.size()));
+    }
+    w_(output_dim) = 0.0;
+
+    Eigen::Map<const Matrix> H(H_vec_.data(), input_size_, input_size_);
+    hessian = H.topLeftCorner(input.size(), input.size());
+    return Status::Success;
+}
+
+template <typename Scalar>
+size_t RealtimeModel<Scalar>::get_input_size() const noexcept {
+    return input_size_;
+}
+
+template <typename Scalar>
+size_t RealtimeModel<Scalar>::get_output_size() const noexcept {
+    return output_size_;
+}
+
+template <typename Scalar>
+bool RealtimeModel<Scalar>::set_input(
+    const Eigen::Ref<const Vector>& input,
+    const Eigen::Ref<const Vector>& parameters) noexcept {
+    if (static_cast<size_t>(input.size() + parameters.size()) != input_size_) {
+        return false;
+    }
+    xp_.head(input.size()) = input;
+    xp_.tail(parameters.size()) = parameters;
+    return true;
+}
+
+template <typename Scalar>
+Eigen::Map<const typename RealtimeModel<Scalar>::Vector>
+RealtimeModel<Scalar>::no_parameters() noexcept {
+    return Eigen::Map<const Vector>(nullptr, 0);
+}
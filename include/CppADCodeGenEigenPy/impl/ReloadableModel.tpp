@@ -0,0 +1,190 @@
+#pragma once
+
+template <typename Scalar>
+ReloadableModel<Scalar>::ReloadableModel(
+    const std::string& model_name, const std::string& library_generic_path)
+    : model_name_(model_name),
+      library_generic_path_(library_generic_path),
+      model_(std::make_shared<const CompiledModel<Scalar>>(
+          model_name, library_generic_path)) {
+    input_size_ = model_->get_input_size();
+    output_size_ = model_->get_output_size();
+}
+
+template <typename Scalar>
+ReloadableModel<Scalar>::~ReloadableModel() {
+    // Don't wait for the old version to be released: whoever holds it last
+    // unloads it
+    stopping_ = true;
+    if (reload_thread_.joinable()) {
+        reload_thread_.join();
+    }
+    model_.reset();
+    if (!copy_path_.empty()) {
+        remove_copy(copy_path_);
+    }
+}
+
+template <typename Scalar>
+void ReloadableModel<Scalar>::reload() {
+    reload(library_generic_path_);
+}
+
+template <typename Scalar>
+void ReloadableModel<Scalar>::reload(const std::string& library_generic_path) {
+    if (reloading_) {
+        throw std::runtime_error("A reload of model " + model_name_ +
+                                 " is already in progress.");
+    }
+    if (reload_thread_.joinable()) {
+        reload_thread_.join();
+    }
+    error_ = nullptr;
+    reloading_ = true;
+    reload_thread_ =
+        std::thread(&ReloadableModel::load, this, library_generic_path);
+}
+
+template <typename Scalar>
+bool ReloadableModel<Scalar>::is_reloading() const {
+    return reloading_;
+}
+
+template <typename Scalar>
+void ReloadableModel<Scalar>::wait() {
+    if (reload_thread_.joinable()) {
+        reload_thread_.join();
+    }
+    if (error_) {
+        std::exception_ptr error = error_;
+        error_ = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+template <typename Scalar>
+size_t ReloadableModel<Scalar>::get_version() const {
+    return version_;
+}
+
+template <typename Scalar>
+std::shared_ptr<const CompiledModel<Scalar>>
+ReloadableModel<Scalar>::get_model() const {
+    return std::atomic_load(&model_);
+}
+
+template <typename Scalar>
+void ReloadableModel<Scalar>::load(const std::string& library_generic_path) {
+    const std::string ext =
+        CppAD::cg::system::SystemInfo<>::DYNAMIC_LIB_EXTENSION;
+    try {
+        // Copy the library to a path that has never been loaded, so that
+        // the loader doesn't hand back the version already loaded
+        const std::string copy_path =
+            library_generic_path + ".reload" + std::to_string(getpid()) + "_" +
+            std::to_string(++num_copies_);
+        copy_file(library_generic_path + ext, copy_path + ext);
+
+        // The report is looked up next to the library the model was loaded
+        // from, so it is copied too if there is one
+        std::shared_ptr<const CompiledModel<Scalar>> model;
+        try {
+            const std::string report_path =
+                get_compile_report_path(library_generic_path);
+            if (access(report_path.c_str(), F_OK) == 0) {
+                copy_file(report_path, get_compile_report_path(copy_path));
+            }
+            model = std::make_shared<const CompiledModel<Scalar>>(model_name_,
+                                                                  copy_path);
+        } catch (...) {
+            remove_copy(copy_path);
+            throw;
+        }
+        if (model->get_input_size() != input_size_ ||
+            model->get_output_size() != output_size_) {
+            model.reset();
+            remove_copy(copy_path);
+            throw std::runtime_error(
+                "Reloaded model " + model_name_ +
+                " has a different input or output size than the current "
+                "version.");
+        }
+
+        std::shared_ptr<const CompiledModel<Scalar>> old =
+            std::atomic_exchange(&model_, model);
+        model.reset();
+        const std::string old_copy_path = copy_path_;
+        copy_path_ = copy_path;
+        ++version_;
+
+        // Calls in flight may still be using the old version. No new calls
+        // can start using it, so it can be unloaded once they release it.
+        while (old.use_count() > 1 && !stopping_) {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+        old.reset();
+        if (!old_copy_path.empty()) {
+            remove_copy(old_copy_path);
+        }
+    } catch (...) {
+        error_ = std::current_exception();
+    }
+    reloading_ = false;
+}
+
+template <typename Scalar>
+void ReloadableModel<Scalar>::remove_copy(const std::string& copy_path) {
+    std::remove(
+        (copy_path + CppAD::cg::system::SystemInfo<>::DYNAMIC_LIB_EXTENSION)
+            .c_str());
+    std::remove(get_compile_report_path(copy_path).c_str());
+}
+
+template <typename Scalar>
+typename ReloadableModel<Scalar>::Vector ReloadableModel<Scalar>::evaluate(
+    const Eigen::Ref<const Vector>& input) const {
+    return get_model()->evaluate(input);
+}
+
+template <typename Scalar>
+typename ReloadableModel<Scalar>::Vector ReloadableModel<Scalar>::evaluate(
+    const Eigen::Ref<const Vector>& input,
+    const Eigen::Ref<const Vector>& parameters) const {
+    return get_model()->evaluate(input, parameters);
+}
+
+template <typename Scalar>
+typename ReloadableModel<Scalar>::Matrix ReloadableModel<Scalar>::jacobian(
+    const Eigen::Ref<const Vector>& input) const {
+    return get_model()->jacobian(input);
+}
+
+template <typename Scalar>
+typename ReloadableModel<Scalar>::Matrix ReloadableModel<Scalar>::jacobian(
+    const Eigen::Ref<const Vector>& input,
+    const Eigen::Ref<const Vector>& parameters) const {
+    return get_model()->jacobian(input, parameters);
+}
+
+template <typename Scalar>
+typename ReloadableModel<Scalar>::Matrix ReloadableModel<Scalar>::hessian(
+    const Eigen::Ref<const Vector>& input, size_t output_dim) const {
+    return get_model()->hessian(input, output_dim);
+}
+
+template <typename Scalar>
+typename ReloadableModel<Scalar>::Matrix ReloadableModel<Scalar>::hessian(
+    const Eigen::Ref<const Vector>& input,
+    const Eigen::Ref<const Vector>& parameters, size_t output_dim) const {
+    return get_model()->hessian(input, parameters, output_dim);
+}
+
+template <typename Scalar>
+size_t ReloadableModel<Scalar>::get_input_size() const {
+    return input_size_;
+}
+
+template <typename Scalar>
+size_t ReloadableModel<Scalar>::get_output_size() const {
+    return output_size_;
+}
@@ -0,0 +1,208 @@
+#pragma once
+
+template <typename Scalar>
+RolloutEngine<Scalar>::RolloutEngine(const CompiledModel<Scalar>& model,
+                                     size_t state_size, size_t control_size,
+                                     Integrator integrator, size_t num_threads)
+    : state_size_(state_size),
+      control_size_(control_size),
+      pool_(new ThreadPool(num_threads)) {
+    if (model.get_output_size() != state_size_) {
+        throw std::runtime_error(
+            "Built-in integrators require the model output to be the state "
+            "derivative, of size " +
+            std::to_string(state_size_) + ", but the model output size is " +
+            std::to_string(model.get_output_size()) + ".");
+    }
+    switch (integrator) {
+        case Integrator::Euler:
+            step_ = &RolloutEngine::euler_step;
+            break;
+        case Integrator::RK4:
+            step_ = &RolloutEngine::rk4_step;
+            break;
+    }
+    init(model);
+}
+
+template <typename Scalar>
+RolloutEngine<Scalar>::RolloutEngine(const CompiledModel<Scalar>& model,
+                                     size_t state_size, size_t control_size,
+                                     const StepFunction& step,
+                                     size_t num_threads)
+    : state_size_(state_size),
+      control_size_(control_size),
+      step_(step),
+      pool_(new ThreadPool(num_threads)) {
+    init(model);
+}
+
+template <typename Scalar>
+void RolloutEngine<Scalar>::rollout(
+    const Eigen::Ref<const Matrix>& initial_states,
+    const Eigen::Ref<const Matrix>& controls, Scalar dt,
+    Eigen::Ref<Matrix> trajectories,
+    const Eigen::Ref<const Matrix>& parameters) {
+    const size_t num_envs = initial_states.rows();
+    if (static_cast<size_t>(initial_states.cols()) != state_size_) {
+        throw std::runtime_error("Initial states must have " +
+                                 std::to_string(state_size_) + " columns.");
+    }
+    if (static_cast<size_t>(controls.rows()) != num_envs ||
+        (control_size_ > 0 && controls.cols() % control_size_ != 0)) {
+        throw std::runtime_error(
+            "Controls must have a row for each environment, with " +
+            std::to_string(control_size_) + " columns per step.");
+    }
+
+    // Without controls, the number of steps is taken from the trajectories
+    const size_t num_steps = control_size_ > 0
+                                 ? controls.cols() / control_size_
+                                 : trajectories.cols() / state_size_;
+    if (static_cast<size_t>(trajectories.rows()) != num_envs ||
+        static_cast<size_t>(trajectories.cols()) != num_steps * state_size_) {
+        throw std::runtime_error(
+            "Trajectories must have shape (" + std::to_string(num_envs) +
+            ", " + std::to_string(num_steps * state_size_) + ").");
+    }
+    if (parameter_size_ > 0 &&
+        (static_cast<size_t>(parameters.cols()) != parameter_size_ ||
+         (parameters.rows() != 1 &&
+          static_cast<size_t>(parameters.rows()) != num_envs))) {
+        throw std::runtime_error(
+            "Parameters must have shape (1, " +
+            std::to_string(parameter_size_) + ") or (" +
+            std::to_string(num_envs) + ", " +
+            std::to_string(parameter_size_) + ").");
+    }
+
+    pool_->parallel_for(num_envs, [&](size_t begin, size_t end,
+                                      size_t thread_index) {
+        rollout_range(begin, end, thread_index, initial_states, controls, dt,
+                      trajectories, parameters);
+    });
+}
+
+template <typename Scalar>
+size_t RolloutEngine<Scalar>::get_state_size() const {
+    return state_size_;
+}
+
+template <typename Scalar>
+size_t RolloutEngine<Scalar>::get_control_size() const {
+    return control_size_;
+}
+
+template <typename Scalar>
+size_t RolloutEngine<Scalar>::get_parameter_size() const {
+    return parameter_size_;
+}
+
+template <typename Scalar>
+size_t RolloutEngine<Scalar>::get_num_threads() const {
+    return pool_->get_num_threads();
+}
+
+template <typename Scalar>
+void RolloutEngine<Scalar>::init(const CompiledModel<Scalar>& model) {
+    if (model.get_input_size() < state_size_ + control_size_) {
+        throw std::runtime_error(
+            "Model input size " + std::to_string(model.get_input_size()) +
+            " is smaller than the state and control sizes combined.");
+    }
+    parameter_size_ = model.get_input_size() - state_size_ - control_size_;
+
+    workers_.resize(pool_->get_num_threads());
+    for (Worker& worker : workers_) {
+        worker.model.reset(new RealtimeModel<Scalar>(model));
+        worker.input = Vector::Zero(model.get_input_size());
+    }
+}
+
+template <typename Scalar>
+void RolloutEngine<Scalar>::rollout_range(
+    size_t begin, size_t end, size_t thread_index,
+    const Eigen::Ref<const Matrix>& initial_states,
+    const Eigen::Ref<const Matrix>& controls, Scalar dt,
+    Eigen::Ref<Matrix> trajectories,
+    const Eigen::Ref<const Matrix>& parameters) {
+    Worker& worker = workers_[thread_index];
+    const size_t s = state_size_;
+    const size_t c = control_size_;
+    const size_t num_steps = trajectories.cols() / s;
+
+    // The parameters stay at the end of the model input, so only the state
+    // and control are copied for each evaluation
+    Dynamics dynamics = [&](const Eigen::Ref<const Vector>& state,
+                            const Eigen::Ref<const Vector>& control,
+                            Eigen::Ref<Vector> output) {
+        worker.input.head(s) = state;
+        worker.input.segment(s, c) = control;
+        Status status = worker.model->evaluate(worker.input, output);
+        if (status != Status::Success) {
+            throw std::runtime_error(status_description(status));
+        }
+    };
+
+    for (size_t i = begin; i < end; ++i) {
+        if (parameter_size_ > 0) {
+            worker.input.tail(parameter_size_) =
+                parameters.row(parameters.rows() == 1 ? 0 : i).transpose();
+        }
+
+        // Each step starts from the state written by the previous one
+        Scalar* trajectory =
+            trajectories.data() + i * trajectories.outerStride();
+        const Scalar* control = controls.data() + i * controls.outerStride();
+        Eigen::Map<const Vector> initial_state(
+            initial_states.data() + i * initial_states.outerStride(), s);
+        for (size_t k = 0; k < num_steps; ++k) {
+            Eigen::Map<Vector> next_state(trajectory + k * s, s);
+            if (k == 0) {
+                step_(dynamics, initial_state,
+                      Eigen::Map<const Vector>(control, c), dt, next_state);
+            } else {
+                step_(dynamics,
+                      Eigen::Map<const Vector>(trajectory + (k - 1) * s, s),
+                      Eigen::Map<const Vector>(control + k * c, c), dt,
+                      next_state);
+            }
+        }
+    }
+}
+
+template <typename Scalar>
+void RolloutEngine<Scalar>::euler_step(const Dynamics& dynamics,
+                                       const Eigen::Ref<const Vector>& state,
+                                       const Eigen::Ref<const Vector>& control,
+                                       Scalar dt,
+                                       Eigen::Ref<Vector> next_state) {
+    // Use the output as the derivative, then integrate it in place
+    dynamics(state, control, next_state);
+    next_state = state + dt * next_state;
+}
+
+template <typename Scalar>
+void RolloutEngine<Scalar>::rk4_step(const Dynamics& dynamics,
+                                     const Eigen::Ref<const Vector>& state,
+                                     const Eigen::Ref<const Vector>& control,
+                                     Scalar dt,
+                                     Eigen::Ref<Vector> next_state) {
+    // Per-thread scratch space, so that steps do not allocate once warm
+    static thread_local Vector k1, k2, k3, k4, x;
+    const Eigen::Index n = state.size();
+    k1.resize(n);
+    k2.resize(n);
+    k3.resize(n);
+    k4.resize(n);
+    x.resize(n);
+
+    dynamics(state, control, k1);
+    x = state + 0.5 * dt * k1;
+    dynamics(x, control, k2);
+    x = state + 0.5 * dt * k2;
+    dynamics(x, control, k3);
+    x = state + dt * k3;
+    dynamics(x, control, k4);
+    next_state = state + dt / 6 * (k1 + 2 * k2 + 2 * k3 + k4);
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+template <typename Kernels>
+StaticModel<Kernels>::StaticModel() {
+    unsigned long input_size, output_size;
+    Kernels::info(&output_size, &input_size);
+    input_size_ = input_size;
+    output_size_ = output_size;
+}
+
+template <typename Kernels>
+typename StaticModel<Kernels>::Vector StaticModel<Kernels>::evaluate(
+    const Eigen::Ref<const Vector>& input) const {
+    check_input_size(input.size());
+
+    Vector output(output_size_);
+    const Scalar* in[] = {input.data()};
+    Scalar* out[] = {output.data()};
+    Kernels::forward_zero(in, out);
+    return output;
+}
+
+template <typename Kernels>
+typename StaticModel<Kernels>::Vector StaticModel<Kernels>::evaluate(
+    const Eigen::Ref<const Vector>& input,
+    const Eigen::Ref<const Vector>& parameters) const {
+    check_input_size_with_params(input.size(), parameters.size());
+
+    Vector xp(input.size() + parameters.size());
+    xp << input, parameters;
+    return evaluate(xp);
+}
+
+template <typename Kernels>
+typename StaticModel<Kernels>::Matrix StaticModel<Kernels>::jacobian(
+    const Eigen::Ref<const Vector>& input) const {
+    check_input_size(input.size());
+
+    Matrix J(output_size_, input_size_);
+    const Scalar* in[] = {input.data()};
+    Scalar* out[] = {J.data()};
+    Kernels::jacobian(in, out);
+    return J;
+}
+
+template <typename Kernels>
+typename StaticModel<Kernels>::Matrix StaticModel<Kernels>::jacobian(
+    const Eigen::Ref<const Vector>& input,
+    const Eigen::Ref<const Vector>& parameters) const {
+    check_input_size_with_params(input.size(), parameters.size());
+
+    Vector xp(input.size() + parameters.size());
+    xp << input, parameters;
+    return jacobian(xp).leftCols(input.rows());
+}
+
+template <typename Kernels>
+typename StaticModel<Kernels>::Matrix StaticModel<Kernels>::hessian(
+    const Eigen::Ref<const Vector>& input, size_t output_dim) const {
+    if (output_dim >= output_size_) {
+        throw std::runtime_error("Specified output dimension for Hessian is " +
+                                 std::to_string(output_dim) +
+                                 ", but model has only " +
+                                 std::to_string(output_size_) + " outputs.");
+    }
+    check_input_size(input.size());
+
+    // See CompiledModel::hessian for why the weighted version is used
+    Vector w = Vector::Zero(output_size_);
+    w(output_dim) = 1.0;
+    Matrix H(input_size_, input_size_);
+    const Scalar* in[] = {input.data(), w.data()};
+    Scalar* out[] = {H.data()};
+    Kernels::hessian(in, out);
+    return H;
+}
+
+template <typename Kernels>
+typename StaticModel<Kernels>::Matrix StaticModel<Kernels>::hessian(
+    const Eigen::Ref<const Vector>& input,
+    const Eigen::Ref<const Vector>& parameters, size_t output_dim) const {
+    check_input_size_with_params(input.size(), parameters.size());
+
+    Vector xp(input.size() + parameters.size());
+    xp << input, parameters;
+    return hessian(xp, output_dim).topLeftCorner(input.rows(), input.rows());
+}
+
+template <typename Kernels>
+size_t StaticModel<Kernels>::get_input_size() const {
+    return input_size_;
+}
+
+template <typename Kernels>
+size_t StaticModel<Kernels>::get_output_size() const {
+    return output_size_;
+}
+
+template <typename Kernels>
+void StaticModel<Kernels>::check_input_size(size_t size) const {
+    if (size < input_size_) {
+        throw std::runtime_error(
+            "Model domain is " + std::to_string(input_size_) +
+            ", but input is of size " + std::to_string(size) +
+            ". Did you mean to pass parameters, too?");
+    } else if (size > input_size_) {
+        throw std::runtime_error(
+            "Model domain is " + std::to_string(input_size_) +
+            ", but input is of size " + std::to_string(size));
+    }
+}
+
+template <typename Kernels>
+void StaticModel<Kernels>::check_input_size_with_params(
+    size_t input_size, size_t param_size) const {
+    size_t total_size = input_size + param_size;
+    if (total_size > input_size_) {
+        throw std::runtime_error(
+            "Input size is " + std::to_string(input_size) +
+            " and parameter size is " + std::to_string(param_size) +
+            ". The total is " + std::to_string(total_size) +
+            ", which larger than the model domain " +
+            std::to_string(input_size_) +
+            ". Maybe you meant not to pass parameters?");
+    }
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+template <typename Scalar>
+StreamingEvaluator<Scalar>::StreamingEvaluator(
+    const CompiledModel<Scalar>& model, size_t num_threads, size_t chunk_size)
+    : pool_(num_threads), chunk_size_(chunk_size) {
+    for (size_t i = 0; i < pool_.get_num_threads(); ++i) {
+        models_.push_back(model);
+    }
+}
+
+template <typename Scalar>
+void StreamingEvaluator<Scalar>::evaluate(const std::string& input_path,
+                                          const std::string& output_path,
+                                          const std::string& jacobian_path,
+                                          const std::string& parameters_path) {
+    const CompiledModel<Scalar>& model = models_.front();
+    const bool compute_jacobian = !jacobian_path.empty();
+
+    NpyArray<Scalar> inputs(input_path);
+    const size_t num_rows = inputs.get_rows();
+    const size_t input_size = inputs.get_row_size();
+
+    // Parameters are either one row per input or a single vector shared by
+    // all inputs
+    std::unique_ptr<NpyArray<Scalar>> parameters;
+    size_t param_size = 0;
+    bool shared_params = false;
+    if (!parameters_path.empty()) {
+        parameters.reset(new NpyArray<Scalar>(parameters_path));
+        shared_params = parameters->get_shape().size() == 1;
+        param_size = shared_params ? parameters->get_rows()
+                                   : parameters->get_row_size();
+        if (!shared_params && parameters->get_rows() != num_rows) {
+            throw std::runtime_error(
+                "Number of parameter rows is " +
+                std::to_string(parameters->get_rows()) +
+                ", but number of input rows is " + std::to_string(num_rows));
+        }
+    }
+    if (input_size + param_size != model.get_input_size()) {
+        throw std::runtime_error(
+            "Input size is " + std::to_string(input_size) +
+            " and parameter size is " + std::to_string(param_size) +
+            ", but the model domain is " +
+            std::to_string(model.get_input_size()));
+    }
+
+    const size_t output_size = model.get_output_size();
+    NpyArray<Scalar> outputs(output_path, {num_rows, output_size});
+    std::unique_ptr<NpyArray<Scalar>> jacobians;
+    if (compute_jacobian) {
+        jacobians.reset(new NpyArray<Scalar>(
+            jacobian_path, {num_rows, output_size, input_size}));
+    }
+
+    size_t row_bytes = input_size + output_size;
+    if (!shared_params) {
+        row_bytes += param_size;
+    }
+    if (compute_jacobian) {
+        row_bytes += output_size * input_size;
+    }
+    const size_t chunk_size = compute_chunk_size(row_bytes * sizeof(Scalar));
+
+    inputs.prefetch(0, chunk_size);
+    if (parameters && !shared_params) {
+        parameters->prefetch(0, chunk_size);
+    }
+
+    for (size_t begin = 0; begin < num_rows; begin += chunk_size) {
+        const size_t end = std::min(begin + chunk_size, num_rows);
+
+        // Read ahead the next chunk while this one is processed
+        inputs.prefetch(end, end + chunk_size);
+        if (parameters && !shared_params) {
+            parameters->prefetch(end, end + chunk_size);
+        }
+
+        pool_.parallel_for(end - begin, [&](size_t chunk_begin,
+                                            size_t chunk_end,
+                                            size_t thread_index) {
+            const CompiledModel<Scalar>& thread_model = models_[thread_index];
+            for (size_t i = begin + chunk_begin; i < begin + chunk_end; ++i) {
+                Eigen::Map<const Vector> x(inputs.row(i), input_size);
+                Eigen::Map<Vector> y(outputs.row(i), output_size);
+                if (parameters) {
+                    Eigen::Map<const Vector> p(
+                        parameters->row(shared_params ? 0 : i), param_size);
+                    y = thread_model.evaluate(x, p);
+                    if (compute_jacobian) {
+                        Eigen::Map<Matrix>(jacobians->row(i), output_size,
+                                           input_size) =
+                            thread_model.jacobian(x, p);
+                    }
+                } else {
+                    y = thread_model.evaluate(x);
+                    if (compute_jacobian) {
+                        Eigen::Map<Matrix>(jacobians->row(i), output_size,
+                                           input_size) =
+                            thread_model.jacobian(x);
+                    }
+                }
+            }
+        });
+
+        inputs.release(begin, end);
+        if (parameters && !shared_params) {
+            parameters->release(begin, end);
+        }
+        outputs.release(begin, end);
+        if (compute_jacobian) {
+            jacobians->release(begin, end);
+        }
+    }
+}
+
+template <typename Scalar>
+size_t StreamingEvaluator<Scalar>::get_num_threads() const {
+    return pool_.get_num_threads();
+}
+
+template <typename Scalar>
+size_t StreamingEvaluator<Scalar>::compute_chunk_size(size_t row_bytes) const {
+    if (chunk_size_ > 0) {
+        return chunk_size_;
+    }
+
+    // Fall back to a conservative cache size if it cannot be determined
+    long cache_bytes = -1;
+#ifdef _SC_LEVEL2_CACHE_SIZE
+    cache_bytes = ::sysconf(_SC_LEVEL2_CACHE_SIZE);
+#endif
+    if (cache_bytes <= 0) {
+        cache_bytes = 256 * 1024;
+    }
+    size_t rows_per_thread =
+        std::max<size_t>(1, cache_bytes / std::max<size_t>(1, row_bytes));
+    return rows_per_thread * pool_.get_num_threads();
+}
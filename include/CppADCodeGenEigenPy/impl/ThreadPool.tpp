@@ -0,0 +1,104 @@
+#pragma once
+
+inline ThreadPool::ThreadPool(size_t num_threads, const std::vector<int>& cpus)
+    : num_threads_(num_threads), cpus_(cpus) {
+    if (num_threads_ == 0) {
+        num_threads_ = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // The calling thread acts as the first thread
+    for (size_t i = 1; i < num_threads_; ++i) {
+        workers_.emplace_back(&ThreadPool::worker_loop, this, i);
+    }
+}
+
+inline ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    work_cv_.notify_all();
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+}
+
+inline void ThreadPool::parallel_for(size_t n, const RangeFunction& fn) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        fn_ = &fn;
+        n_ = n;
+        num_pending_ = workers_.size();
+        error_ = nullptr;
+        ++generation_;
+    }
+    work_cv_.notify_all();
+
+    run_chunk(fn, n, 0);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [this] { return num_pending_ == 0; });
+    fn_ = nullptr;
+    if (error_) {
+        std::rethrow_exception(error_);
+    }
+}
+
+inline size_t ThreadPool::get_num_threads() const { return num_threads_; }
+
+inline void ThreadPool::worker_loop(size_t thread_index) {
+    if (!cpus_.empty()) {
+        // Failing to pin is not fatal; the thread just runs unpinned
+        try {
+            pin_current_thread(cpus_[thread_index % cpus_.size()]);
+        } catch (const std::runtime_error&) {
+        }
+    }
+
+    size_t generation = 0;
+    while (true) {
+        const RangeFunction* fn;
+        size_t n;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            work_cv_.wait(lock, [this, generation] {
+                return stop_ || generation_ != generation;
+            });
+            if (stop_) {
+                return;
+            }
+            generation = generation_;
+            fn = fn_;
+            n = n_;
+        }
+
+        run_chunk(*fn, n, thread_index);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            --num_pending_;
+        }
+        done_cv_.notify_one();
+    }
+}
+
+inline void ThreadPool::run_chunk(const RangeFunction& fn, size_t n,
+                                  size_t thread_index) {
+    // Contiguous chunks, with the remainder spread over the first threads
+    size_t chunk = n / num_threads_;
+    size_t remainder = n % num_threads_;
+    size_t begin = thread_index * chunk + std::min(thread_index, remainder);
+    size_t end = begin + chunk + (thread_index < remainder ? 1 : 0);
+    if (begin >= end) {
+        return;
+    }
+
+    try {
+        fn(begin, end, thread_index);
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!error_) {
+            error_ = std::current_exception();
+        }
+    }
+}
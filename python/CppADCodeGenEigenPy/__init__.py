@@ -0,0 +1,24 @@
+"""CppADCodeGen with an Eigen interface and Python bindings."""
+from ._bindings import (
+    BatchDispatcher,
+    CompiledModel,
+    CompileReport,
+    CompositeModel,
+    DispatcherOptions,
+    DispatcherStatistics,
+    EvaluationClient,
+    EvaluationServer,
+    Integrator,
+    Kernel,
+    LoadOptions,
+    MatrixFuture,
+    ModelGroup,
+    ModelGroupResult,
+    Reduction,
+    RolloutEngine,
+    ServerOptions,
+    StreamingEvaluator,
+    VectorFuture,
+    WarmupLatency,
+)
+from .parallel import SharedArray, evaluate_in_processes
@@ -0,0 +1,79 @@
+"""Calling compiled models from JAX.
+
+A compiled model is wrapped as a JAX function using jax.pure_callback, so it
+can be used inside jax.jit. Batching with jax.vmap maps onto a single call to
+the batched C++ evaluation rather than one callback per sample, and JVPs (and
+hence reverse-mode gradients, through JAX's transposition of the linear JVP)
+use the compiled Jacobian.
+
+JAX is an optional dependency, so this module is not imported by the package
+itself.
+"""
+import inspect
+
+import jax
+import jax.numpy as jnp
+import numpy as np
+
+
+# jax.pure_callback takes vmap_method in newer versions of JAX, where the
+# older vectorized argument is deprecated. In both cases, the callback is
+# called once with the batch dimensions leading.
+if "vmap_method" in inspect.signature(jax.pure_callback).parameters:
+    _BATCHED_CALLBACK_ARGS = {"vmap_method": "expand_dims"}
+else:
+    _BATCHED_CALLBACK_ARGS = {"vectorized": True}
+
+
+def _batched(f, model, output_shape):
+    """Make a host callback evaluating f on inputs with any leading batch
+    dimensions by flattening them into a single batch."""
+
+    def callback(x):
+        x = np.asarray(x)
+        batch_shape = x.shape[:-1]
+        inputs = np.ascontiguousarray(
+            x.reshape(-1, model.input_size), dtype=np.float64
+        )
+        outputs = f(inputs)
+        return outputs.reshape(batch_shape + output_shape).astype(x.dtype)
+
+    return callback
+
+
+def jax_function(model):
+    """Wrap a compiled model as a JAX function.
+
+    The returned function takes the full input of the model (including any
+    parameters) as an array of shape (..., n), and returns the output with
+    shape (..., m). It supports jax.jit, jax.vmap, and first-order
+    differentiation with jax.jvp, jax.grad and jax.jacfwd/jacrev. Computing
+    higher-order derivatives is not supported.
+
+    Parameters:
+        model: The CompiledModel to wrap. It must be at least first-order to
+            be differentiated.
+
+    Returns:
+        The JAX function.
+    """
+    n = model.input_size
+    m = model.output_size
+    evaluate = _batched(model.evaluate_batch, model, (m,))
+    jacobian = _batched(model.jacobian_batch, model, (m, n))
+
+    def call(callback, x, shape):
+        result_shape = jax.ShapeDtypeStruct(x.shape[:-1] + shape, x.dtype)
+        return jax.pure_callback(callback, result_shape, x, **_BATCHED_CALLBACK_ARGS)
+
+    @jax.custom_jvp
+    def f(x):
+        return call(evaluate, x, (m,))
+
+    @f.defjvp
+    def f_jvp(primals, tangents):
+        (x,), (dx,) = primals, tangents
+        J = call(jacobian, x, (m, n))
+        return f(x), jnp.einsum("...ij,...j->...i", J, dx)
+
+    return f
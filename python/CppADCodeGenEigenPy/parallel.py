@@ -0,0 +1,140 @@
+"""Evaluation of compiled models over batches in worker processes.
+
+A CompiledModel can be pickled, which only sends the location of its library
+to the worker, where it is loaded again. Batch inputs are shared with the
+workers through shared memory rather than copied to each of them.
+"""
+import os
+import sys
+from concurrent.futures import ProcessPoolExecutor
+from multiprocessing import resource_tracker, shared_memory
+
+import numpy as np
+
+
+# Whether this process shares the resource tracker of the process that
+# started it, decided when the first block is attached
+_shares_tracker = None
+
+
+def _attach(name):
+    # Only the process that created the block should unlink it, so workers
+    # attaching to it must not leave it registered with a resource tracker of
+    # their own. Processes started by multiprocessing share their parent's
+    # tracker, which keeps a single registration per name, so unregistering
+    # the block there would drop the creator's registration instead.
+    global _shares_tracker
+    if sys.version_info >= (3, 13):
+        return shared_memory.SharedMemory(name=name, track=False)
+    if _shares_tracker is None:
+        _shares_tracker = resource_tracker._resource_tracker._fd is not None
+    shm = shared_memory.SharedMemory(name=name)
+    if not _shares_tracker:
+        resource_tracker.unregister(shm._name, "shared_memory")
+    return shm
+
+
+class SharedArray:
+    """A read-only array in shared memory.
+
+    Pickling a SharedArray only sends the name of the shared memory block, so
+    it can be handed to worker processes without copying the data. The array
+    is released when the SharedArray that created it is closed, which must
+    not happen while workers are still using it.
+    """
+
+    def __init__(self, array):
+        array = np.ascontiguousarray(array)
+        self._shape = array.shape
+        self._dtype = array.dtype
+        self._shm = shared_memory.SharedMemory(
+            create=True, size=max(array.nbytes, 1)
+        )
+        self._owner = True
+        self._make_array()[...] = array
+
+    def __getstate__(self):
+        return self._shm.name, self._shape, self._dtype.str
+
+    def __setstate__(self, state):
+        name, self._shape, dtype = state
+        self._dtype = np.dtype(dtype)
+        self._shm = _attach(name)
+        self._owner = False
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *args):
+        self.close()
+
+    def _make_array(self):
+        return np.ndarray(self._shape, dtype=self._dtype, buffer=self._shm.buf)
+
+    @property
+    def array(self):
+        """A read-only view of the shared data."""
+        array = self._make_array()
+        array.flags.writeable = False
+        return array
+
+    def close(self):
+        """Detach from the shared memory, releasing it if this is the owner.
+        Views returned by array must not be used afterward."""
+        self._shm.close()
+        if self._owner:
+            self._shm.unlink()
+
+
+def _evaluate_rows(model, inputs, parameters, begin, end, jacobian):
+    x = inputs.array
+    args = () if parameters is None else (parameters,)
+    f = model.jacobian if jacobian else model.evaluate
+    try:
+        return np.array([f(x[i], *args) for i in range(begin, end)])
+    finally:
+        inputs.close()
+
+
+def evaluate_in_processes(
+    model, inputs, parameters=None, jacobian=False, num_processes=None
+):
+    """Evaluate a model (or its Jacobian) at each row of inputs, using a pool
+    of worker processes.
+
+    Parameters:
+        model: The CompiledModel to evaluate. It is reloaded in each worker.
+        inputs: Array of shape (N, n) of inputs.
+        parameters: Parameters shared by all evaluations, if the model has
+            any.
+        jacobian: Compute the Jacobians rather than the outputs.
+        num_processes: Number of worker processes. Defaults to the number of
+            CPUs.
+
+    Returns:
+        Array of shape (N, m) of outputs, or (N, m, n) of Jacobians.
+    """
+    inputs = np.asarray(inputs, dtype=np.float64)
+    if inputs.ndim != 2:
+        raise ValueError("Inputs must be a two-dimensional array.")
+    if num_processes is None:
+        num_processes = os.cpu_count()
+    num_processes = max(1, min(num_processes, inputs.shape[0]))
+
+    bounds = np.linspace(0, inputs.shape[0], num_processes + 1).astype(int)
+    with SharedArray(inputs) as shared_inputs:
+        with ProcessPoolExecutor(num_processes) as executor:
+            futures = [
+                executor.submit(
+                    _evaluate_rows,
+                    model,
+                    shared_inputs,
+                    parameters,
+                    begin,
+                    end,
+                    jacobian,
+                )
+                for begin, end in zip(bounds[:-1], bounds[1:])
+            ]
+            results = [future.result() for future in futures]
+    return np.concatenate(results)
@@ -15,7 +15,7 @@ ext_modules = [
     # the eigen3 include directories below may be required for the compiler to
     # find Eigen
     Pybind11Extension(
-        "CppADCodeGenEigenPy",
+        "CppADCodeGenEigenPy._bindings",
         ["src/bindings.cpp"],
         include_dirs=["include", "/usr/include/eigen3", "/usr/local/include/eigen3"],
     ),
@@ -29,8 +29,11 @@ setup(
     long_description_content_type="text/markdown",
     author="Adam Heins",
     author_email="mail@adamheins.com",
+    packages=["CppADCodeGenEigenPy"],
+    package_dir={"": "python"},
+    python_requires=">=3.8",
     install_requires=["numpy"],
-    extras_require={"test": "pytest"},
+    extras_require={"test": "pytest", "jax": "jax"},
     ext_modules=ext_modules,
     cmdclass={"build_ext": build_ext},
     license="MIT",
@@ -1,14 +1,25 @@
 #include <pybind11/eigen.h>
+#include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
 
 #include <Eigen/Eigen>
+#include <sstream>
 
+#include <CppADCodeGenEigenPy/BatchDispatcher.h>
+#include <CppADCodeGenEigenPy/CompileReport.h>
 #include <CppADCodeGenEigenPy/CompiledModel.h>
+#include <CppADCodeGenEigenPy/CompositeModel.h>
+#include <CppADCodeGenEigenPy/EvaluationClient.h>
+#include <CppADCodeGenEigenPy/EvaluationServer.h>
+#include <CppADCodeGenEigenPy/ModelGroup.h>
+#include <CppADCodeGenEigenPy/RolloutEngine.h>
+#include <CppADCodeGenEigenPy/StreamingEvaluator.h>
 
 namespace py = pybind11;
 namespace ad = CppADCodeGenEigenPy;
 
-PYBIND11_MODULE(CppADCodeGenEigenPy, m) {
+PYBIND11_MODULE(_bindings, m) {
     using Scalar = double;
     using Vector = ad::CompiledModel<Scalar>::Vector;
     using Matrix = ad::CompiledModel<Scalar>::Matrix;
@@ -17,8 +28,77 @@ PYBIND11_MODULE(CppADCodeGenEigenPy, m) {
 
     // TODO I've hardcoded double into this for now---not sure if I can
     // actually get away from this...
-    py::class_<ad::CompiledModel<Scalar>>(m, "CompiledModel")
+    py::class_<ad::CompileReport>(m, "CompileReport")
+        .def_readonly("model_name", &ad::CompileReport::model_name)
+        .def_readonly("record_time", &ad::CompileReport::record_time)
+        .def_readonly("optimize_time", &ad::CompileReport::optimize_time)
+        .def_readonly("source_generation_time",
+                      &ad::CompileReport::source_generation_time)
+        .def_readonly("compile_time", &ad::CompileReport::compile_time)
+        .def_readonly("load_time", &ad::CompileReport::load_time)
+        .def_readonly("num_operations", &ad::CompileReport::num_operations)
+        .def_readonly("num_optimized_operations",
+                      &ad::CompileReport::num_optimized_operations)
+        .def_readonly("source_sizes", &ad::CompileReport::source_sizes)
+        .def_readonly("library_size", &ad::CompileReport::library_size)
+        .def_property_readonly("total_time", &ad::CompileReport::total_time)
+        .def("__repr__", [](const ad::CompileReport& report) {
+            std::ostringstream ss;
+            ss << report;
+            return ss.str();
+        });
+
+    py::class_<ad::LoadOptions>(m, "LoadOptions")
+        .def(py::init<>())
+        .def_readwrite("bind_now", &ad::LoadOptions::bind_now)
+        .def_readwrite("prefault", &ad::LoadOptions::prefault)
+        .def_readwrite("lock_memory", &ad::LoadOptions::lock_memory)
+        .def_readwrite("warmup", &ad::LoadOptions::warmup)
+        .def_readwrite("warmup_iterations",
+                       &ad::LoadOptions::warmup_iterations)
+        .def_readwrite("warmup_input", &ad::LoadOptions::warmup_input);
+
+    py::class_<ad::WarmupLatency>(m, "WarmupLatency")
+        .def_readonly("kernel", &ad::WarmupLatency::kernel)
+        .def_readonly("first_call_time", &ad::WarmupLatency::first_call_time)
+        .def_readonly("steady_state_time",
+                      &ad::WarmupLatency::steady_state_time);
+
+    // Convert an optional array to a matrix, with a 1-D array as a single row
+    auto as_rows = [](py::object array) {
+        Matrix rows;
+        if (!array.is_none()) {
+            auto a = array.cast<py::array_t<
+                Scalar, py::array::c_style | py::array::forcecast>>();
+            size_t num_rows = a.ndim() == 1 ? 1 : a.shape(0);
+            rows = Eigen::Map<const Matrix>(
+                a.data(), num_rows, num_rows == 0 ? 0 : a.size() / num_rows);
+        }
+        return rows;
+    };
+
+    py::class_<ad::CompiledModel<Scalar>::Reduction>(m, "Reduction")
+        .def_readonly("output_sum",
+                      &ad::CompiledModel<Scalar>::Reduction::output_sum)
+        .def_readonly("squared_output_sum",
+                      &ad::CompiledModel<Scalar>::Reduction::squared_output_sum)
+        .def_readonly("gradient",
+                      &ad::CompiledModel<Scalar>::Reduction::gradient)
+        .def_readonly("gauss_newton",
+                      &ad::CompiledModel<Scalar>::Reduction::gauss_newton);
+
+    // Objects that evaluate models keep the GIL during their calls: the
+    // generated code uses internal buffers, so a model must not be called
+    // from multiple threads at once, and the GIL serializes those calls.
+    // Only calls that block on other threads or processes release it.
+    py::class_<ad::CompiledModel<Scalar>>(
+        m, "CompiledModel",
+        "A compiled model. Calls hold the GIL, since a model must not be "
+        "used from multiple threads at once; use one model per thread, or a "
+        "BatchDispatcher, to evaluate concurrently.")
         .def(py::init<const std::string&, const std::string&>())
+        .def(py::init<const std::string&, const std::string&,
+                      const ad::LoadOptions&>())
         .def("evaluate", static_cast<Vector (ad::CompiledModel<Scalar>::*)(
                              const Eigen::Ref<const Vector>&) const>(
                              &ad::CompiledModel<Scalar>::evaluate),
@@ -37,6 +117,16 @@ PYBIND11_MODULE(CppADCodeGenEigenPy, m) {
                              const Eigen::Ref<const Vector>&) const>(
                              &ad::CompiledModel<Scalar>::jacobian),
              "Evaluate Jacobian with parameters.")
+        .def("gradient", static_cast<Vector (ad::CompiledModel<Scalar>::*)(
+                             const Eigen::Ref<const Vector>&) const>(
+                             &ad::CompiledModel<Scalar>::gradient),
+             "Evaluate gradient of single-output function with no "
+             "parameters.")
+        .def("gradient", static_cast<Vector (ad::CompiledModel<Scalar>::*)(
+                             const Eigen::Ref<const Vector>&,
+                             const Eigen::Ref<const Vector>&) const>(
+                             &ad::CompiledModel<Scalar>::gradient),
+             "Evaluate gradient of single-output function with parameters.")
         .def("hessian", static_cast<Matrix (ad::CompiledModel<Scalar>::*)(
                             const Eigen::Ref<const Vector>&, size_t) const>(
                             &ad::CompiledModel<Scalar>::hessian),
@@ -46,8 +136,431 @@ PYBIND11_MODULE(CppADCodeGenEigenPy, m) {
                             const Eigen::Ref<const Vector>&, size_t) const>(
                             &ad::CompiledModel<Scalar>::hessian),
              "Evaluate Hessian with parameters.")
+        .def("hessian_packed",
+             static_cast<Vector (ad::CompiledModel<Scalar>::*)(
+                 const Eigen::Ref<const Vector>&, size_t) const>(
+                 &ad::CompiledModel<Scalar>::hessian_packed),
+             "Evaluate the lower triangle of the Hessian with no parameters, "
+             "packed row by row in the order of numpy.tril_indices.")
+        .def("hessian_packed",
+             static_cast<Vector (ad::CompiledModel<Scalar>::*)(
+                 const Eigen::Ref<const Vector>&,
+                 const Eigen::Ref<const Vector>&, size_t) const>(
+                 &ad::CompiledModel<Scalar>::hessian_packed),
+             "Evaluate the lower triangle of the Hessian with parameters, "
+             "packed row by row in the order of numpy.tril_indices.")
+        .def("jacobian_block",
+             static_cast<Matrix (ad::CompiledModel<Scalar>::*)(
+                 const std::string&, const std::string&,
+                 const Eigen::Ref<const Vector>&) const>(
+                 &ad::CompiledModel<Scalar>::jacobian_block),
+             "Evaluate a single Jacobian block with no parameters.")
+        .def("jacobian_block",
+             static_cast<Matrix (ad::CompiledModel<Scalar>::*)(
+                 const std::string&, const std::string&,
+                 const Eigen::Ref<const Vector>&,
+                 const Eigen::Ref<const Vector>&) const>(
+                 &ad::CompiledModel<Scalar>::jacobian_block),
+             "Evaluate a single Jacobian block with parameters.")
+        .def("parameter_jacobian",
+             &ad::CompiledModel<Scalar>::parameter_jacobian, py::arg("input"),
+             py::arg("parameters"),
+             "Evaluate Jacobian with respect to the parameters.")
+        .def("mixed_hessian", &ad::CompiledModel<Scalar>::mixed_hessian,
+             py::arg("input"), py::arg("parameters"), py::arg("output_dim") = 0,
+             "Evaluate second derivatives with respect to the input and "
+             "parameters, of shape (input, parameters).")
+        .def("evaluate_batch", &ad::CompiledModel<Scalar>::evaluate_batch,
+             py::arg("inputs"),
+             "Evaluate function at each row of inputs, which include any "
+             "parameters.")
+        .def(
+            "jacobian_batch",
+            [](const ad::CompiledModel<Scalar>& model,
+               const Eigen::Ref<const Matrix>& inputs) {
+                return py::cast(model.jacobian_batch(inputs))
+                    .attr("reshape")(inputs.rows(), model.get_output_size(),
+                                     model.get_input_size());
+            },
+            py::arg("inputs"),
+            "Evaluate Jacobian at each row of inputs, which include any "
+            "parameters, returning an array of shape (batch, output, input).")
+        .def(
+            "reduce",
+            [as_rows](const ad::CompiledModel<Scalar>& model,
+                      py::object inputs, py::object parameters,
+                      py::object weights, bool gauss_newton,
+                      bool with_respect_to_parameters, size_t num_threads) {
+                Matrix x = as_rows(inputs);
+                Matrix p = as_rows(parameters);
+                Matrix w = as_rows(weights);
+                return model.reduce(x, p, w, gauss_newton,
+                                    with_respect_to_parameters, num_threads);
+            },
+            py::arg("inputs"), py::arg("parameters") = py::none(),
+            py::arg("weights") = py::none(), py::arg("gauss_newton") = false,
+            py::arg("with_respect_to_parameters") = false,
+            py::arg("num_threads") = 0,
+            "Sum the outputs, the gradients J_i^T w_i and optionally the "
+            "Gauss-Newton matrices J_i^T J_i over the rows of inputs and "
+            "parameters, where a single row is shared by all samples. J_i is "
+            "taken with respect to the input, or the parameters if "
+            "requested. If no weights are given, the outputs are used.")
+        .def_property_readonly("jacobian_blocks",
+                               &ad::CompiledModel<Scalar>::get_jacobian_blocks)
+        .def_property("num_threads",
+                      &ad::CompiledModel<Scalar>::get_num_threads,
+                      &ad::CompiledModel<Scalar>::set_num_threads)
+        .def_property_readonly("derivatives_ready",
+                               &ad::CompiledModel<Scalar>::derivatives_ready)
+        .def("wait_for_derivatives",
+             &ad::CompiledModel<Scalar>::wait_for_derivatives,
+             "Wait for the derivatives of a lazily compiled model.")
         .def_property_readonly("input_size",
                                &ad::CompiledModel<Scalar>::get_input_size)
         .def_property_readonly("output_size",
-                               &ad::CompiledModel<Scalar>::get_output_size);
+                               &ad::CompiledModel<Scalar>::get_output_size)
+        .def_property_readonly("library_path",
+                               &ad::CompiledModel<Scalar>::get_library_path)
+        .def_property_readonly("library_hash",
+                               &ad::CompiledModel<Scalar>::get_library_hash)
+        .def_property_readonly("compile_report",
+                               &ad::CompiledModel<Scalar>::get_compile_report)
+        .def_property_readonly(
+            "warmup_latencies",
+            &ad::CompiledModel<Scalar>::get_warmup_latencies)
+        // Only the location of the library is pickled: it is loaded again
+        // when unpickled, after checking that it is the same library. A
+        // lazily compiled model first switches to its derivative library,
+        // so that the copy has the derivatives too.
+        .def(py::pickle(
+            [](ad::CompiledModel<Scalar>& model) {
+                model.wait_for_derivatives();
+                return py::make_tuple(
+                    model.get_model_name(), model.get_library_path(),
+                    model.get_library_hash(), model.get_input_size(),
+                    model.get_output_size());
+            },
+            [](const py::tuple& state) {
+                if (state.size() != 5) {
+                    throw std::runtime_error("Invalid CompiledModel state.");
+                }
+                const std::string model_name = state[0].cast<std::string>();
+                const std::string library_path = state[1].cast<std::string>();
+                ad::CompiledModel<Scalar> model(model_name, library_path);
+
+                if (model.get_library_hash() != state[2].cast<std::string>()) {
+                    throw std::runtime_error(
+                        "Library " + library_path +
+                        " has changed since the model was pickled.");
+                }
+                if (model.get_input_size() != state[3].cast<size_t>() ||
+                    model.get_output_size() != state[4].cast<size_t>()) {
+                    throw std::runtime_error(
+                        "Model " + model_name +
+                        " does not have the same dimensions as when it was "
+                        "pickled.");
+                }
+                return model;
+            }));
+
+    py::class_<ad::StreamingEvaluator<Scalar>>(
+        m, "StreamingEvaluator",
+        "Evaluates a model over .npy files. Calls hold the GIL, since the "
+        "evaluator must not be used from multiple threads at once.")
+        .def(py::init<const ad::CompiledModel<Scalar>&, size_t, size_t>(),
+             py::arg("model"), py::arg("num_threads") = 0,
+             py::arg("chunk_size") = 0)
+        .def("evaluate", &ad::StreamingEvaluator<Scalar>::evaluate,
+             py::arg("input_path"), py::arg("output_path"),
+             py::arg("jacobian_path") = "", py::arg("parameters_path") = "",
+             "Evaluate model over .npy files, writing outputs (and "
+             "optionally Jacobians) to new .npy files.")
+        .def_property_readonly(
+            "num_threads", &ad::StreamingEvaluator<Scalar>::get_num_threads);
+
+    using ModelGroup = ad::ModelGroup<Scalar>;
+    py::class_<ModelGroup::Result>(m, "ModelGroupResult")
+        .def_readonly("name", &ModelGroup::Result::name)
+        .def_readonly("value", &ModelGroup::Result::value)
+        .def_readonly("jacobian", &ModelGroup::Result::jacobian)
+        .def_readonly("hessians", &ModelGroup::Result::hessians);
+
+    py::class_<ModelGroup>(
+        m, "ModelGroup",
+        "A group of models evaluated on a shared input. Calls hold the GIL, "
+        "since the group must not be used from multiple threads at once.")
+        .def(py::init<size_t, size_t>(), py::arg("input_size"),
+             py::arg("num_threads") = 1)
+        .def("add_model", &ModelGroup::add_model, py::arg("name"),
+             py::arg("model"), py::arg("input_indices"),
+             py::arg("jacobian") = false,
+             py::arg("hessian_outputs") = std::vector<size_t>(),
+             "Add a member model taking its input from the given indices of "
+             "the flat input.")
+        .def(
+            "evaluate",
+            [](ModelGroup& group, const Eigen::Ref<const Vector>& input) {
+                py::dict results_by_name;
+                for (const ModelGroup::Result& result : group.evaluate(input)) {
+                    results_by_name[py::str(result.name)] = result;
+                }
+                return results_by_name;
+            },
+            py::arg("input"),
+            "Evaluate all member models, returning a dict of results by "
+            "member name.")
+        .def_property_readonly("input_size", &ModelGroup::get_input_size)
+        .def_property_readonly("num_models", &ModelGroup::get_num_models)
+        .def_property_readonly("num_threads", &ModelGroup::get_num_threads);
+
+    using CompositeModel = ad::CompositeModel<Scalar>;
+    py::class_<CompositeModel>(
+        m, "CompositeModel",
+        "A chain of compiled models. Calls hold the GIL, since the composite "
+        "model must not be used from multiple threads at once.")
+        .def(py::init<size_t>(), py::arg("input_size"))
+        .def("add_model", &CompositeModel::add_model, py::arg("model"),
+             py::arg("input_indices"),
+             "Append a stage taking its input from the given indices of the "
+             "composite input and previous stage outputs. Returns the offset "
+             "of the stage's output.")
+        .def("evaluate", &CompositeModel::evaluate, py::arg("input"),
+             "Evaluate the composite model.")
+        .def("jacobian", &CompositeModel::jacobian, py::arg("input"),
+             "Compute the Jacobian of the composite model.")
+        .def("hessian", &CompositeModel::hessian, py::arg("input"),
+             py::arg("output_dim"),
+             "Compute the Hessian of one output of the composite model.")
+        .def_property_readonly("input_size", &CompositeModel::get_input_size)
+        .def_property_readonly("output_size", &CompositeModel::get_output_size)
+        .def_property_readonly("num_models", &CompositeModel::get_num_models);
+
+    // Futures are shared in Python, so that their result can be retrieved
+    // more than once
+    using VectorFuture = std::shared_future<Vector>;
+    py::class_<VectorFuture>(m, "VectorFuture")
+        .def("result", &VectorFuture::get,
+             py::call_guard<py::gil_scoped_release>(),
+             "Wait for and return the result.")
+        .def(
+            "done",
+            [](const VectorFuture& future) {
+                return future.wait_for(std::chrono::seconds(0)) ==
+                       std::future_status::ready;
+            },
+            "Check if the result is available.");
+
+    using MatrixFuture = std::shared_future<Matrix>;
+    py::class_<MatrixFuture>(m, "MatrixFuture")
+        .def("result", &MatrixFuture::get,
+             py::call_guard<py::gil_scoped_release>(),
+             "Wait for and return the result.")
+        .def(
+            "done",
+            [](const MatrixFuture& future) {
+                return future.wait_for(std::chrono::seconds(0)) ==
+                       std::future_status::ready;
+            },
+            "Check if the result is available.");
+
+    py::class_<ad::DispatcherOptions>(m, "DispatcherOptions")
+        .def(py::init<>())
+        .def_readwrite("max_batch_size",
+                       &ad::DispatcherOptions::max_batch_size)
+        .def_readwrite("max_wait_time", &ad::DispatcherOptions::max_wait_time)
+        .def_readwrite("num_threads", &ad::DispatcherOptions::num_threads);
+
+    py::class_<ad::DispatcherStatistics>(m, "DispatcherStatistics")
+        .def_readonly("num_requests", &ad::DispatcherStatistics::num_requests)
+        .def_readonly("num_batches", &ad::DispatcherStatistics::num_batches)
+        .def_readonly("mean_batch_size",
+                      &ad::DispatcherStatistics::mean_batch_size)
+        .def_readonly("max_batch_size",
+                      &ad::DispatcherStatistics::max_batch_size)
+        .def_readonly("mean_wait_time",
+                      &ad::DispatcherStatistics::mean_wait_time)
+        .def_readonly("queue_depth", &ad::DispatcherStatistics::queue_depth)
+        .def_readonly("max_queue_depth",
+                      &ad::DispatcherStatistics::max_queue_depth);
+
+    using BatchDispatcher = ad::BatchDispatcher<Scalar>;
+    py::class_<BatchDispatcher>(m, "BatchDispatcher")
+        .def(py::init<const ad::CompiledModel<Scalar>&,
+                      const ad::DispatcherOptions&>(),
+             py::arg("model"), py::arg("options") = ad::DispatcherOptions())
+        .def(
+            "evaluate",
+            [](BatchDispatcher& dispatcher,
+               const Eigen::Ref<const Vector>& input) {
+                return dispatcher.evaluate(input).share();
+            },
+            py::arg("input"),
+            "Submit a request to evaluate the function, returning a future.")
+        .def(
+            "jacobian",
+            [](BatchDispatcher& dispatcher,
+               const Eigen::Ref<const Vector>& input) {
+                return dispatcher.jacobian(input).share();
+            },
+            py::arg("input"),
+            "Submit a request to compute the Jacobian, returning a future.")
+        .def_property_readonly("statistics", &BatchDispatcher::get_statistics)
+        .def("reset_statistics", &BatchDispatcher::reset_statistics);
+
+    py::enum_<ad::Kernel>(m, "Kernel")
+        .value("Evaluate", ad::Kernel::Evaluate)
+        .value("Jacobian", ad::Kernel::Jacobian);
+
+    py::class_<ad::ServerOptions>(m, "ServerOptions")
+        .def(py::init<>())
+        .def_readwrite("num_threads", &ad::ServerOptions::num_threads)
+        .def_readwrite("cpus", &ad::ServerOptions::cpus)
+        .def_readwrite("num_slots", &ad::ServerOptions::num_slots)
+        .def_readwrite("ring_capacity", &ad::ServerOptions::ring_capacity)
+        .def_readwrite("max_batch_size", &ad::ServerOptions::max_batch_size)
+        .def_readwrite("spin_iterations",
+                       &ad::ServerOptions::spin_iterations);
+
+    using EvaluationServer = ad::EvaluationServer<Scalar>;
+    py::class_<EvaluationServer>(m, "EvaluationServer")
+        .def(py::init<const std::string&,
+                      const std::vector<ad::CompiledModel<Scalar>>&,
+                      const ad::ServerOptions&>(),
+             py::arg("name"), py::arg("models"),
+             py::arg("options") = ad::ServerOptions())
+        .def("stop", &EvaluationServer::stop,
+             py::call_guard<py::gil_scoped_release>(),
+             "Stop serving requests.")
+        .def_property_readonly("name", &EvaluationServer::get_name)
+        .def_property_readonly("running", &EvaluationServer::is_running)
+        .def_property_readonly("num_requests",
+                               &EvaluationServer::get_num_requests)
+        .def_property_readonly("num_batches",
+                               &EvaluationServer::get_num_batches);
+
+    // Models may be referred to by name or by index
+    using EvaluationClient = ad::EvaluationClient<Scalar>;
+    py::class_<EvaluationClient>(
+        m, "EvaluationClient",
+        "A connection to an evaluation server. Calls hold the GIL, since a "
+        "client must not be used from multiple threads at once; use one "
+        "client per thread instead.")
+        .def(py::init<const std::string&, double, size_t>(),
+             py::arg("server_name"), py::arg("connect_timeout") = 0,
+             py::arg("spin_iterations") = 10000,
+             py::call_guard<py::gil_scoped_release>())
+        .def("model_index", &EvaluationClient::get_model_index,
+             py::arg("model_name"))
+        .def(
+            "evaluate",
+            [](EvaluationClient& client, const std::string& model_name,
+               const Eigen::Ref<const Vector>& input) {
+                size_t model = client.get_model_index(model_name);
+                return client.evaluate(model, input);
+            },
+            py::arg("model"), py::arg("input"),
+            "Evaluate a model on the server.")
+        .def("evaluate", &EvaluationClient::evaluate, py::arg("model"),
+             py::arg("input"))
+        .def(
+            "jacobian",
+            [](EvaluationClient& client, const std::string& model_name,
+               const Eigen::Ref<const Vector>& input) {
+                size_t model = client.get_model_index(model_name);
+                return client.jacobian(model, input);
+            },
+            py::arg("model"), py::arg("input"),
+            "Compute the Jacobian of a model on the server.")
+        .def("jacobian", &EvaluationClient::jacobian, py::arg("model"),
+             py::arg("input"))
+        .def(
+            "submit",
+            [](EvaluationClient& client, const std::string& model_name,
+               ad::Kernel kernel, const Eigen::Ref<const Vector>& input) {
+                return client.submit(client.get_model_index(model_name),
+                                     kernel, input);
+            },
+            py::arg("model"), py::arg("kernel"), py::arg("input"),
+            "Submit a request without waiting for its result, returning a "
+            "ticket.")
+        .def("submit", &EvaluationClient::submit, py::arg("model"),
+             py::arg("kernel"), py::arg("input"))
+        .def("collect", &EvaluationClient::collect, py::arg("ticket"),
+             "Wait for the result of a submitted request. Jacobians are "
+             "flattened in row-major order.")
+        .def_property_readonly("model_names",
+                               &EvaluationClient::get_model_names)
+        .def_property_readonly("ring_capacity",
+                               &EvaluationClient::get_ring_capacity);
+
+    py::enum_<ad::Integrator>(m, "Integrator")
+        .value("Euler", ad::Integrator::Euler)
+        .value("RK4", ad::Integrator::RK4);
+
+    using RolloutEngine = ad::RolloutEngine<Scalar>;
+    using Array = py::array_t<Scalar, py::array::c_style>;
+    py::class_<RolloutEngine>(
+        m, "RolloutEngine",
+        "Rolls out environments in parallel. Calls hold the GIL, since the "
+        "engine must not be used from multiple threads at once.")
+        .def(py::init<const ad::CompiledModel<Scalar>&, size_t, size_t,
+                      ad::Integrator, size_t>(),
+             py::arg("model"), py::arg("state_size"), py::arg("control_size"),
+             py::arg("integrator") = ad::Integrator::RK4,
+             py::arg("num_threads") = 0)
+        .def(
+            "rollout",
+            [as_rows](RolloutEngine& engine,
+                      const Eigen::Ref<const Matrix>& x0s,
+                      py::array_t<Scalar,
+                                  py::array::c_style | py::array::forcecast>
+                          controls,
+                      Scalar dt, py::object parameters, py::object out) {
+                // Controls are (N, K, control_size) and trajectories are
+                // (N, K, state_size); both are viewed as (N, K * size)
+                if (controls.ndim() != 3) {
+                    throw std::runtime_error("Controls must be of shape "
+                                             "(N, K, control_size).");
+                }
+                const size_t N = controls.shape(0);
+                const size_t K = controls.shape(1);
+                const size_t S = engine.get_state_size();
+
+                // Casting any other array would write into a temporary copy
+                if (!out.is_none() && !py::isinstance<Array>(out)) {
+                    throw std::runtime_error(
+                        "Output must be a C-contiguous array of type "
+                        "float64.");
+                }
+                Array trajectories =
+                    out.is_none() ? Array({N, K, S}) : out.cast<Array>();
+                if (trajectories.ndim() != 3 ||
+                    static_cast<size_t>(trajectories.shape(0)) != N ||
+                    static_cast<size_t>(trajectories.shape(1)) != K ||
+                    static_cast<size_t>(trajectories.shape(2)) != S) {
+                    throw std::runtime_error(
+                        "Output must be a C-contiguous array of shape "
+                        "(N, K, state_size).");
+                }
+
+                Matrix p = as_rows(parameters);
+
+                Eigen::Map<const Matrix> u(controls.data(), N,
+                                           K * controls.shape(2));
+                Eigen::Map<Matrix> xs(trajectories.mutable_data(), N, K * S);
+                engine.rollout(x0s, u, dt, xs, p);
+                return trajectories;
+            },
+            py::arg("initial_states"), py::arg("controls"), py::arg("dt"),
+            py::arg("parameters") = py::none(), py::arg("out") = py::none(),
+            "Roll out N environments for K steps, returning the states "
+            "after each step as an array of shape (N, K, state_size). If out "
+            "is given, the states are written into it.")
+        .def_property_readonly("state_size", &RolloutEngine::get_state_size)
+        .def_property_readonly("control_size",
+                               &RolloutEngine::get_control_size)
+        .def_property_readonly("parameter_size",
+                               &RolloutEngine::get_parameter_size)
+        .def_property_readonly("num_threads", &RolloutEngine::get_num_threads);
 }
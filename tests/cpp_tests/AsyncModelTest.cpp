@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+
+#include <Eigen/Eigen>
+#include <boost/filesystem.hpp>
+
+#include <CppADCodeGenEigenPy/ADModel.h>
+#include <CppADCodeGenEigenPy/AsyncModel.h>
+#include <CppADCodeGenEigenPy/CompiledModel.h>
+
+#include "testing/models/ParameterizedTestModel.h"
+
+namespace CppADCodeGenEigenPy {
+namespace AsyncModelTest {
+
+using namespace ParameterizedModelTest;
+
+class AsyncModelFixture : public ::testing::Test {
+   protected:
+    using Vector = CompiledModel<Scalar>::Vector;
+    using Matrix = CompiledModel<Scalar>::Matrix;
+
+    static void SetUpTestSuite() {
+        boost::filesystem::create_directories(DIRECTORY_PATH);
+        compiled_model_ptr_.reset(new CompiledModel<Scalar>(
+            ParameterizedTestModel<Scalar>().compile(
+                MODEL_NAME, DIRECTORY_PATH, DerivativeOrder::Second)));
+    }
+
+    static void TearDownTestSuite() {
+        // Delete the compiled shared objects.
+        boost::filesystem::remove_all(DIRECTORY_PATH);
+    }
+
+    // Check that the model gives the same results as the compiled one
+    static void expect_same_results(const AsyncModel<Scalar>& model) {
+        Vector input = Vector::Random(NUM_INPUT);
+        Vector parameters = Vector::Random(NUM_PARAM);
+        Vector xp(NUM_INPUT + NUM_PARAM);
+        xp << input, parameters;
+        const CompiledModel<Scalar>& expected = *compiled_model_ptr_;
+
+        EXPECT_TRUE(model.evaluate(input, parameters)
+                        .isApprox(expected.evaluate(input, parameters)))
+            << "Function evaluation is incorrect.";
+        EXPECT_TRUE(model.jacobian(input, parameters)
+                        .isApprox(expected.jacobian(input, parameters)))
+            << "Jacobian is incorrect.";
+        EXPECT_TRUE(model.jacobian(xp).isApprox(expected.jacobian(xp)))
+            << "Jacobian with respect to parameters is incorrect.";
+        EXPECT_TRUE(model.hessian(input, parameters, 0)
+                        .isApprox(expected.hessian(input, parameters, 0)))
+            << "Hessian is incorrect.";
+        EXPECT_TRUE(model.hessian(xp, 0).isApprox(expected.hessian(xp, 0)))
+            << "Hessian with respect to parameters is incorrect.";
+    }
+
+    static std::unique_ptr<CompiledModel<Scalar>> compiled_model_ptr_;
+};
+
+std::unique_ptr<CompiledModel<Scalar>> AsyncModelFixture::compiled_model_ptr_ =
+    nullptr;
+
+TEST_F(AsyncModelFixture, TapeThenCompiled) {
+    std::unique_ptr<AsyncModel<Scalar>> model =
+        ParameterizedTestModel<Scalar>().compile_async(MODEL_NAME + "Async",
+                                                       DIRECTORY_PATH);
+    EXPECT_EQ(model->get_input_size(), NUM_INPUT + NUM_PARAM);
+    EXPECT_EQ(model->get_output_size(), NUM_OUTPUT);
+
+    // Served by the tape if compilation is still in progress
+    expect_same_results(*model);
+
+    model->wait();
+    EXPECT_TRUE(model->is_compiled());
+    ASSERT_NE(model->get_model(), nullptr);
+    EXPECT_TRUE(boost::filesystem::exists(get_library_real_path(
+        MODEL_NAME + "Async", DIRECTORY_PATH)));
+    expect_same_results(*model);
+}
+
+TEST_F(AsyncModelFixture, TapeOrder) {
+    CompileOptions options;
+    options.order = DerivativeOrder::First;
+    options.compiler_path = "/nonexistent/gcc";
+    std::unique_ptr<AsyncModel<Scalar>> model =
+        ParameterizedTestModel<Scalar>().compile_async(
+            MODEL_NAME + "AsyncFailed", DIRECTORY_PATH, options);
+
+    // Compilation fails, so the tape keeps serving calls, providing the
+    // same derivatives as the compiled model would
+    EXPECT_THROW(model->wait(), std::exception)
+        << "Failed compilation did not throw.";
+    EXPECT_FALSE(model->is_compiled());
+
+    Vector input = Vector::Random(NUM_INPUT);
+    Vector parameters = Vector::Random(NUM_PARAM);
+    EXPECT_TRUE(model->jacobian(input, parameters)
+                    .isApprox(compiled_model_ptr_->jacobian(input, parameters)))
+        << "Jacobian is incorrect.";
+    EXPECT_THROW(model->hessian(input, parameters, 0), std::runtime_error)
+        << "Hessian of first-order model did not throw.";
+    EXPECT_THROW(model->evaluate(input), std::runtime_error)
+        << "Input of wrong size did not throw.";
+}
+
+}  // namespace AsyncModelTest
+}  // namespace CppADCodeGenEigenPy
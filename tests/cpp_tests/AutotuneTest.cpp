@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+
+#include <Eigen/Eigen>
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <sstream>
+
+#include <CppADCodeGenEigenPy/ADModel.h>
+#include <CppADCodeGenEigenPy/CompileReport.h>
+#include <CppADCodeGenEigenPy/CompiledModel.h>
+
+#include "testing/models/ParameterizedTestModel.h"
+
+namespace CppADCodeGenEigenPy {
+namespace AutotuneTest {
+
+using namespace ParameterizedModelTest;
+
+const std::string TUNED_MODEL_NAME = MODEL_NAME + "Autotuned";
+const std::string REPORT_PATH =
+    get_library_generic_path(TUNED_MODEL_NAME, DIRECTORY_PATH) +
+    ".autotune.txt";
+
+class AutotuneFixture : public ::testing::Test {
+   protected:
+    using Vector = CompiledModel<Scalar>::Vector;
+
+    static void SetUpTestSuite() {
+        boost::filesystem::create_directories(DIRECTORY_PATH);
+        ParameterizedTestModel<Scalar>().compile(MODEL_NAME, DIRECTORY_PATH,
+                                                 DerivativeOrder::Second);
+        compiled_model_ptr_.reset(
+            new CompiledModel<Scalar>(MODEL_NAME, LIB_GENERIC_PATH));
+
+        for (int i = 0; i < 5; ++i) {
+            sample_inputs_.push_back(Vector::Random(NUM_INPUT + NUM_PARAM));
+        }
+
+        // The last configuration cannot compile and must be skipped
+        AutotuneOptions options;
+        options.configurations = {
+            {Compiler::GCC, {"-O0"}},
+            {Compiler::GCC, {"-O2"}},
+            {Compiler::GCC, {"-fno-such-option"}},
+        };
+        options.repetitions = 10;
+        tuned_model_ptr_.reset(
+            new CompiledModel<Scalar>(ParameterizedTestModel<Scalar>().autotune(
+                TUNED_MODEL_NAME, DIRECTORY_PATH, sample_inputs_, options)));
+    }
+
+    static void TearDownTestSuite() {
+        // Delete the compiled shared objects.
+        boost::filesystem::remove_all(DIRECTORY_PATH);
+    }
+
+    static std::unique_ptr<CompiledModel<Scalar>> compiled_model_ptr_;
+    static std::unique_ptr<CompiledModel<Scalar>> tuned_model_ptr_;
+    static std::vector<Vector> sample_inputs_;
+};
+
+std::unique_ptr<CompiledModel<Scalar>> AutotuneFixture::compiled_model_ptr_ =
+    nullptr;
+std::unique_ptr<CompiledModel<Scalar>> AutotuneFixture::tuned_model_ptr_ =
+    nullptr;
+std::vector<AutotuneFixture::Vector> AutotuneFixture::sample_inputs_;
+
+TEST_F(AutotuneFixture, MatchesUntuned) {
+    Vector x = Vector::Random(NUM_INPUT);
+    Vector p = Vector::Random(NUM_PARAM);
+
+    EXPECT_TRUE(tuned_model_ptr_->evaluate(x, p).isApprox(
+        compiled_model_ptr_->evaluate(x, p)));
+    EXPECT_TRUE(tuned_model_ptr_->jacobian(x, p).isApprox(
+        compiled_model_ptr_->jacobian(x, p)));
+    EXPECT_TRUE(tuned_model_ptr_->hessian(x, p, 0).isApprox(
+        compiled_model_ptr_->hessian(x, p, 0)));
+}
+
+TEST_F(AutotuneFixture, Report) {
+    std::ifstream file(REPORT_PATH);
+    ASSERT_TRUE(file.good());
+    std::stringstream report;
+    report << file.rdbuf();
+
+    EXPECT_NE(report.str().find("reference"), std::string::npos);
+    EXPECT_NE(report.str().find("failed to compile"), std::string::npos);
+    EXPECT_NE(report.str().find("Chosen configuration"), std::string::npos);
+
+    // The compile report of the chosen library is kept with it
+    CompileReport compile_report;
+    ASSERT_NO_THROW(compile_report = tuned_model_ptr_->get_compile_report());
+    EXPECT_EQ(compile_report.nominal_input.size(),
+              static_cast<size_t>(NUM_INPUT + NUM_PARAM));
+
+    // Candidate libraries are cleaned up
+    EXPECT_FALSE(boost::filesystem::exists(DIRECTORY_PATH + "/" +
+                                           TUNED_MODEL_NAME + "_autotune"));
+}
+
+TEST_F(AutotuneFixture, ReferenceMustCompile) {
+    AutotuneOptions options;
+    options.configurations = {{Compiler::GCC, {"-fno-such-option"}}};
+    EXPECT_THROW(ParameterizedTestModel<Scalar>().autotune(
+                     TUNED_MODEL_NAME + "Broken", DIRECTORY_PATH,
+                     sample_inputs_, options),
+                 std::runtime_error);
+}
+
+}  // namespace AutotuneTest
+}  // namespace CppADCodeGenEigenPy
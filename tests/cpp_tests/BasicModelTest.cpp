@@ -2,6 +2,7 @@
 
 #include <Eigen/Eigen>
 #include <boost/filesystem.hpp>
+#include <fstream>
 
 #include <CppADCodeGenEigenPy/ADModel.h>
 #include <CppADCodeGenEigenPy/CompiledModel.h>
@@ -104,5 +105,119 @@ TEST_F(BasicTestModelFixture, Hessian) {
         << "Hessian with too-large output_dim did not throw.";
 }
 
+TEST_F(BasicTestModelFixture, Batch) {
+    Matrix inputs = Matrix::Random(5, NUM_INPUT);
+    Matrix outputs = compiled_model_ptr_->evaluate_batch(inputs);
+    Matrix jacobians = compiled_model_ptr_->jacobian_batch(inputs);
+
+    ASSERT_EQ(outputs.rows(), 5);
+    ASSERT_EQ(outputs.cols(), NUM_OUTPUT);
+    ASSERT_EQ(jacobians.rows(), 5);
+    ASSERT_EQ(jacobians.cols(), NUM_OUTPUT * NUM_INPUT);
+    for (int i = 0; i < 5; ++i) {
+        Vector input = inputs.row(i).transpose();
+        Matrix J = compiled_model_ptr_->jacobian(input);
+        EXPECT_TRUE(outputs.row(i).transpose().isApprox(
+            compiled_model_ptr_->evaluate(input)))
+            << "Batch output " << i << " is incorrect.";
+        EXPECT_TRUE(jacobians.row(i).isApprox(
+            Eigen::Map<const Eigen::RowVectorXd>(J.data(), J.size())))
+            << "Batch Jacobian " << i << " is incorrect.";
+    }
+
+    EXPECT_THROW(
+        compiled_model_ptr_->evaluate_batch(Matrix::Ones(5, NUM_INPUT + 1)),
+        std::runtime_error)
+        << "Batch evaluate with inputs of wrong size did not throw.";
+}
+
+TEST_F(BasicTestModelFixture, CompileReport) {
+    CompileReport report = compiled_model_ptr_->get_compile_report();
+    EXPECT_EQ(report.model_name, MODEL_NAME) << "Model name is incorrect.";
+    EXPECT_GT(report.compile_time, 0) << "Compile time is missing.";
+    EXPECT_GE(report.num_operations, report.num_optimized_operations)
+        << "Optimization increased the number of operations.";
+    EXPECT_GT(report.num_optimized_operations, 0u)
+        << "Number of operations is missing.";
+    EXPECT_EQ(report.library_size, boost::filesystem::file_size(LIB_REAL_PATH))
+        << "Library size is incorrect.";
+    EXPECT_FALSE(report.source_sizes.empty()) << "Source sizes are missing.";
+
+    // Saving and loading the report gives back the same report
+    const std::string path = DIRECTORY_PATH + "/test.report";
+    report.save(path);
+    CompileReport loaded = CompileReport::load(path);
+    EXPECT_EQ(loaded.total_time(), report.total_time())
+        << "Loaded report has different times.";
+    EXPECT_EQ(loaded.source_sizes, report.source_sizes)
+        << "Loaded report has different source sizes.";
+
+    EXPECT_THROW(CompileReport::load(DIRECTORY_PATH + "/nonexistent.report"),
+                 std::runtime_error)
+        << "Loading nonexistent report did not throw.";
+}
+
+TEST_F(BasicTestModelFixture, LoadOptions) {
+    LoadOptions options;
+    options.prefault = true;
+    options.warmup = true;
+    CompiledModel<Scalar> model(MODEL_NAME, LIB_GENERIC_PATH, options);
+
+    // All kernels are warmed up, on the nominal input saved when compiling
+    const std::vector<WarmupLatency>& latencies = model.get_warmup_latencies();
+    ASSERT_EQ(latencies.size(), 3u);
+    EXPECT_EQ(latencies[0].kernel, "evaluate");
+    EXPECT_EQ(latencies[1].kernel, "jacobian");
+    EXPECT_EQ(latencies[2].kernel, "hessian");
+    for (const WarmupLatency& latency : latencies) {
+        EXPECT_GT(latency.first_call_time, 0);
+        EXPECT_GT(latency.steady_state_time, 0);
+    }
+    EXPECT_EQ(compiled_model_ptr_->get_compile_report().nominal_input,
+              std::vector<double>(NUM_INPUT, 1.0));
+
+    Vector input = Vector::Ones(NUM_INPUT);
+    EXPECT_TRUE(model.evaluate(input).isApprox(evaluate<Scalar>(input)));
+
+    options.warmup_input = {1, 2};
+    EXPECT_THROW(CompiledModel<Scalar>(MODEL_NAME, LIB_GENERIC_PATH, options),
+                 std::runtime_error)
+        << "Warmup input of wrong size did not throw.";
+}
+
+TEST_F(BasicTestModelFixture, LibraryIdentity) {
+    EXPECT_EQ(compiled_model_ptr_->get_library_path(), LIB_GENERIC_PATH)
+        << "Library path is incorrect.";
+
+    // The hash identifies the library contents, so it is the same for a
+    // copy of the model and changes if the library is replaced
+    std::string hash = compiled_model_ptr_->get_library_hash();
+    EXPECT_EQ(hash.size(), 16u) << "Library hash has the wrong length.";
+    EXPECT_EQ(CompiledModel<Scalar>(*compiled_model_ptr_).get_library_hash(),
+              hash)
+        << "Copied model has a different library hash.";
+    EXPECT_EQ(hash_file(LIB_REAL_PATH), hash)
+        << "Library hash does not match the library file.";
+
+    // Modify a copy of the library, so that the other tests are not
+    // affected. The hash of a loaded model describes the library as it was
+    // loaded.
+    const std::string copy_generic_path =
+        get_library_generic_path(MODEL_NAME + "Identity", DIRECTORY_PATH);
+    const std::string copy_real_path =
+        get_library_real_path(MODEL_NAME + "Identity", DIRECTORY_PATH);
+    boost::filesystem::remove(copy_real_path);
+    boost::filesystem::copy_file(LIB_REAL_PATH, copy_real_path);
+    CompiledModel<Scalar> copy(MODEL_NAME, copy_generic_path);
+    EXPECT_EQ(copy.get_library_hash(), hash)
+        << "Library hash of a copy of the library is different.";
+
+    std::ofstream(copy_real_path, std::ios::app) << "modified";
+    EXPECT_NE(hash_file(copy_real_path), hash)
+        << "Library hash did not change with the library contents.";
+    EXPECT_EQ(copy.get_library_hash(), hash)
+        << "Library hash changed after the library was loaded.";
+}
+
 }  // namespace BasicModelTest
 }  // namespace CppADCodeGenEigenPy
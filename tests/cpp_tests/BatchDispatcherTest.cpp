@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+
+#include <Eigen/Eigen>
+#include <boost/filesystem.hpp>
+#include <thread>
+
+#include <CppADCodeGenEigenPy/ADModel.h>
+#include <CppADCodeGenEigenPy/BatchDispatcher.h>
+#include <CppADCodeGenEigenPy/CompiledModel.h>
+
+#include "testing/models/BasicTestModel.h"
+
+namespace CppADCodeGenEigenPy {
+namespace BatchDispatcherTest {
+
+using Scalar = double;
+using Vector = CompiledModel<Scalar>::Vector;
+using Matrix = CompiledModel<Scalar>::Matrix;
+
+const std::string DIRECTORY_PATH = BasicModelTest::DIRECTORY_PATH;
+const std::string LOW_ORDER_MODEL_NAME = "LowOrderDispatcherTestModel";
+
+class BatchDispatcherFixture : public ::testing::Test {
+   protected:
+    static void SetUpTestSuite() {
+        boost::filesystem::create_directories(DIRECTORY_PATH);
+        BasicModelTest::BasicTestModel<Scalar>().compile(
+            BasicModelTest::MODEL_NAME, DIRECTORY_PATH,
+            DerivativeOrder::First);
+        BasicModelTest::BasicTestModel<Scalar>().compile(
+            LOW_ORDER_MODEL_NAME, DIRECTORY_PATH, DerivativeOrder::Zero);
+        model_ptr_.reset(new CompiledModel<Scalar>(
+            BasicModelTest::MODEL_NAME, BasicModelTest::LIB_GENERIC_PATH));
+    }
+
+    static void TearDownTestSuite() {
+        // Delete the compiled shared objects.
+        boost::filesystem::remove_all(DIRECTORY_PATH);
+    }
+
+    static std::unique_ptr<CompiledModel<Scalar>> model_ptr_;
+};
+
+std::unique_ptr<CompiledModel<Scalar>> BatchDispatcherFixture::model_ptr_ =
+    nullptr;
+
+TEST_F(BatchDispatcherFixture, FullBatch) {
+    // With a long wait time, the requests are only dispatched once the
+    // batch is full
+    DispatcherOptions options;
+    options.max_batch_size = 8;
+    options.max_wait_time = 10.0;
+    BatchDispatcher<Scalar> dispatcher(*model_ptr_, options);
+
+    std::vector<Vector> inputs;
+    std::vector<std::future<Vector>> futures;
+    for (size_t i = 0; i < options.max_batch_size; ++i) {
+        inputs.push_back(Vector::Random(BasicModelTest::NUM_INPUT));
+        futures.push_back(dispatcher.evaluate(inputs.back()));
+    }
+    for (size_t i = 0; i < futures.size(); ++i) {
+        EXPECT_TRUE(futures[i].get().isApprox(model_ptr_->evaluate(inputs[i])))
+            << "Function evaluation is incorrect.";
+    }
+
+    DispatcherStatistics statistics = dispatcher.get_statistics();
+    EXPECT_EQ(statistics.num_requests, options.max_batch_size);
+    EXPECT_EQ(statistics.num_batches, 1u);
+    EXPECT_EQ(statistics.max_batch_size, options.max_batch_size);
+    EXPECT_DOUBLE_EQ(statistics.mean_batch_size, options.max_batch_size);
+    EXPECT_EQ(statistics.max_queue_depth, options.max_batch_size);
+    EXPECT_EQ(statistics.queue_depth, 0u);
+
+    dispatcher.reset_statistics();
+    EXPECT_EQ(dispatcher.get_statistics().num_requests, 0u);
+}
+
+TEST_F(BatchDispatcherFixture, Jacobian) {
+    DispatcherOptions options;
+    options.max_wait_time = 0;
+    BatchDispatcher<Scalar> dispatcher(*model_ptr_, options);
+
+    Vector x = Vector::Random(BasicModelTest::NUM_INPUT);
+    EXPECT_TRUE(dispatcher.jacobian(x).get().isApprox(model_ptr_->jacobian(x)))
+        << "Jacobian is incorrect.";
+}
+
+TEST_F(BatchDispatcherFixture, MultipleThreads) {
+    const int num_threads = 4;
+    const int num_requests = 1000;
+    DispatcherOptions options;
+    options.num_threads = 2;
+    options.max_batch_size = 16;
+    options.max_wait_time = 20e-6;
+    BatchDispatcher<Scalar> dispatcher(*model_ptr_, options);
+
+    std::vector<std::thread> threads;
+    std::vector<int> num_correct(num_threads, 0);
+    for (int i = 0; i < num_threads; ++i) {
+        threads.emplace_back([&, i]() {
+            for (int j = 0; j < num_requests; ++j) {
+                Vector x = Vector::Constant(BasicModelTest::NUM_INPUT,
+                                            i * num_requests + j);
+                if (j % 2 == 0) {
+                    num_correct[i] += dispatcher.evaluate(x).get().isApprox(
+                        model_ptr_->evaluate(x));
+                } else {
+                    num_correct[i] += dispatcher.jacobian(x).get().isApprox(
+                        model_ptr_->jacobian(x));
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    for (int i = 0; i < num_threads; ++i) {
+        EXPECT_EQ(num_correct[i], num_requests)
+            << "Thread " << i << " got incorrect results.";
+    }
+
+    DispatcherStatistics statistics = dispatcher.get_statistics();
+    EXPECT_EQ(statistics.num_requests,
+              static_cast<size_t>(num_threads * num_requests));
+    EXPECT_LE(statistics.num_batches, statistics.num_requests);
+    EXPECT_LE(statistics.max_batch_size, options.max_batch_size);
+}
+
+TEST_F(BatchDispatcherFixture, Errors) {
+    DispatcherOptions options;
+    options.max_batch_size = 0;
+    EXPECT_THROW(BatchDispatcher<Scalar>(*model_ptr_, options),
+                 std::runtime_error);
+
+    BatchDispatcher<Scalar> dispatcher(*model_ptr_);
+    EXPECT_THROW(dispatcher.evaluate(Vector::Ones(1)), std::runtime_error)
+        << "Evaluating with input of wrong size did not throw.";
+
+    CompiledModel<Scalar> low_order_model(
+        LOW_ORDER_MODEL_NAME,
+        get_library_generic_path(LOW_ORDER_MODEL_NAME, DIRECTORY_PATH));
+    BatchDispatcher<Scalar> low_order_dispatcher(low_order_model);
+    EXPECT_THROW(
+        low_order_dispatcher.jacobian(Vector::Ones(BasicModelTest::NUM_INPUT)),
+        std::runtime_error)
+        << "Jacobian of zero-order model did not throw.";
+}
+
+}  // namespace BatchDispatcherTest
+}  // namespace CppADCodeGenEigenPy
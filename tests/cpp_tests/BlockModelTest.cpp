@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+
+#include <Eigen/Eigen>
+#include <boost/filesystem.hpp>
+
+#include <CppADCodeGenEigenPy/ADModel.h>
+#include <CppADCodeGenEigenPy/CompiledModel.h>
+#include <CppADCodeGenEigenPy/Util.h>
+
+#include "testing/models/BlockTestModel.h"
+
+namespace CppADCodeGenEigenPy {
+namespace BlockModelTest {
+
+class BlockTestModelFixture : public ::testing::Test {
+   protected:
+    using Vector = CompiledModel<Scalar>::Vector;
+    using Matrix = CompiledModel<Scalar>::Matrix;
+
+    static void SetUpTestSuite() {
+        // Compile and load our model
+        boost::filesystem::create_directories(DIRECTORY_PATH);
+        ad_model_ptr_.reset(new BlockTestModel<Scalar>());
+        ad_model_ptr_->compile(MODEL_NAME, DIRECTORY_PATH,
+                               DerivativeOrder::First);
+        compiled_model_ptr_.reset(
+            new CompiledModel<Scalar>(MODEL_NAME, LIB_GENERIC_PATH));
+    }
+
+    static void TearDownTestSuite() {
+        // Delete the compiled shared object.
+        boost::filesystem::remove_all(DIRECTORY_PATH);
+    }
+
+    static std::unique_ptr<ADModel<Scalar>> ad_model_ptr_;
+    static std::unique_ptr<CompiledModel<Scalar>> compiled_model_ptr_;
+};
+
+std::unique_ptr<ADModel<Scalar>> BlockTestModelFixture::ad_model_ptr_ = nullptr;
+std::unique_ptr<CompiledModel<Scalar>>
+    BlockTestModelFixture::compiled_model_ptr_ = nullptr;
+
+TEST_F(BlockTestModelFixture, AvailableBlocks) {
+    std::vector<CompiledModel<Scalar>::JacobianBlock> blocks =
+        compiled_model_ptr_->get_jacobian_blocks();
+    ASSERT_EQ(blocks.size(), 2) << "Wrong number of Jacobian blocks.";
+    EXPECT_EQ(blocks[0], CompiledModel<Scalar>::JacobianBlock("first", "a"));
+    EXPECT_EQ(blocks[1], CompiledModel<Scalar>::JacobianBlock("rest", "b"));
+}
+
+TEST_F(BlockTestModelFixture, JacobianBlocks) {
+    Vector input(NUM_INPUT);
+    input << 1, 2, 3, 4;
+    Vector parameters = 2 * Vector::Ones(NUM_PARAM);
+
+    // Blocks should match the corresponding parts of the full Jacobian
+    Matrix J = compiled_model_ptr_->jacobian(input, parameters);
+    Matrix J_first_a =
+        compiled_model_ptr_->jacobian_block("first", "a", input, parameters);
+    Matrix J_rest_b =
+        compiled_model_ptr_->jacobian_block("rest", "b", input, parameters);
+
+    ASSERT_EQ(J_first_a.rows(), 1);
+    ASSERT_EQ(J_first_a.cols(), 2);
+    ASSERT_EQ(J_rest_b.rows(), 2);
+    ASSERT_EQ(J_rest_b.cols(), 2);
+
+    EXPECT_TRUE(J_first_a.isApprox(J.block(0, 0, 1, 2)))
+        << "Jacobian block (first, a) is incorrect.";
+    EXPECT_TRUE(J_rest_b.isApprox(J.block(1, 2, 2, 2)))
+        << "Jacobian block (rest, b) is incorrect.";
+}
+
+TEST_F(BlockTestModelFixture, ThrowsOnUnavailableBlock) {
+    Vector input = Vector::Ones(NUM_INPUT);
+    Vector parameters = Vector::Ones(NUM_PARAM);
+
+    EXPECT_THROW(
+        compiled_model_ptr_->jacobian_block("first", "b", input, parameters),
+        std::runtime_error)
+        << "Jacobian block that was not generated did not throw.";
+    EXPECT_THROW(compiled_model_ptr_->jacobian_block("first", "a", input),
+                 std::runtime_error)
+        << "Missing parameters did not throw error.";
+}
+
+// Segment names are joined by a double underscore in the names of the
+// Jacobian block kernels, so they cannot begin or end with an underscore
+struct InvalidSegmentModel : public BlockTestModel<Scalar> {
+    std::vector<Segment> input_segments() const override {
+        return {{"a_", 0, 2}, {"b", 2, 2}};
+    }
+
+    std::vector<JacobianBlock> jacobian_blocks() const override {
+        return {{"first", "a_"}};
+    }
+};
+
+TEST(BlockModelTest, RejectsInvalidSegmentNames) {
+    EXPECT_THROW(InvalidSegmentModel().compile(MODEL_NAME + "Invalid",
+                                               DIRECTORY_PATH,
+                                               DerivativeOrder::First),
+                 std::runtime_error)
+        << "Segment name with a trailing underscore did not throw error.";
+}
+
+struct DuplicateSegmentModel : public BlockTestModel<Scalar> {
+    std::vector<Segment> input_segments() const override {
+        return {{"a", 0, 2}, {"a", 2, 2}};
+    }
+};
+
+struct DuplicateBlockModel : public BlockTestModel<Scalar> {
+    std::vector<JacobianBlock> jacobian_blocks() const override {
+        return {{"first", "a"}, {"rest", "b"}, {"first", "a"}};
+    }
+};
+
+TEST(BlockModelTest, RejectsDuplicates) {
+    EXPECT_THROW(DuplicateSegmentModel().compile(MODEL_NAME + "Duplicate",
+                                                 DIRECTORY_PATH,
+                                                 DerivativeOrder::First),
+                 std::runtime_error)
+        << "Duplicate segment name did not throw error.";
+    EXPECT_THROW(DuplicateBlockModel().compile(MODEL_NAME + "Duplicate",
+                                               DIRECTORY_PATH,
+                                               DerivativeOrder::First),
+                 std::runtime_error)
+        << "Duplicate Jacobian block did not throw error.";
+}
+
+}  // namespace BlockModelTest
+}  // namespace CppADCodeGenEigenPy
@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+
+#include <Eigen/Eigen>
+#include <boost/filesystem.hpp>
+
+#include <CppADCodeGenEigenPy/ADModel.h>
+#include <CppADCodeGenEigenPy/CompiledModel.h>
+#include <CppADCodeGenEigenPy/CompositeModel.h>
+
+#include "testing/models/BasicTestModel.h"
+#include "testing/models/ParameterizedTestModel.h"
+
+namespace CppADCodeGenEigenPy {
+namespace CompositeModelTest {
+
+using Scalar = double;
+using Vector = CompiledModel<Scalar>::Vector;
+using Matrix = CompiledModel<Scalar>::Matrix;
+
+const std::string DIRECTORY_PATH = BasicModelTest::DIRECTORY_PATH;
+
+// The composite input is (x, p). The basic model computes y = 2x, which is
+// passed along with p to the parameterized model, giving
+//   f(x, p) = 0.5 * sum(p * y^2) = 2 * sum(p * x^2).
+const size_t COMPOSITE_INPUT_SIZE = 6;
+
+class CompositeModelFixture : public ::testing::Test {
+   protected:
+    static void SetUpTestSuite() {
+        boost::filesystem::create_directories(DIRECTORY_PATH);
+        BasicModelTest::BasicTestModel<Scalar>().compile(
+            BasicModelTest::MODEL_NAME, DIRECTORY_PATH,
+            DerivativeOrder::Second);
+        ParameterizedModelTest::ParameterizedTestModel<Scalar>().compile(
+            ParameterizedModelTest::MODEL_NAME, DIRECTORY_PATH,
+            DerivativeOrder::Second);
+        basic_model_ptr_.reset(new CompiledModel<Scalar>(
+            BasicModelTest::MODEL_NAME, BasicModelTest::LIB_GENERIC_PATH));
+        param_model_ptr_.reset(
+            new CompiledModel<Scalar>(ParameterizedModelTest::MODEL_NAME,
+                                      ParameterizedModelTest::LIB_GENERIC_PATH));
+    }
+
+    static void TearDownTestSuite() {
+        // Delete the compiled shared objects.
+        boost::filesystem::remove_all(DIRECTORY_PATH);
+    }
+
+    static std::unique_ptr<CompiledModel<Scalar>> basic_model_ptr_;
+    static std::unique_ptr<CompiledModel<Scalar>> param_model_ptr_;
+};
+
+std::unique_ptr<CompiledModel<Scalar>>
+    CompositeModelFixture::basic_model_ptr_ = nullptr;
+std::unique_ptr<CompiledModel<Scalar>>
+    CompositeModelFixture::param_model_ptr_ = nullptr;
+
+TEST_F(CompositeModelFixture, ChainRule) {
+    CompositeModel<Scalar> composite(COMPOSITE_INPUT_SIZE);
+    size_t y_offset = composite.add_model(*basic_model_ptr_, {0, 1, 2});
+    EXPECT_EQ(y_offset, COMPOSITE_INPUT_SIZE);
+    composite.add_model(*param_model_ptr_,
+                        {y_offset, y_offset + 1, y_offset + 2, 3, 4, 5});
+    EXPECT_EQ(composite.get_num_models(), 2u);
+    EXPECT_EQ(composite.get_output_size(), 1u);
+
+    Vector input = Vector::Random(COMPOSITE_INPUT_SIZE);
+    Vector x = input.head(3);
+    Vector p = input.tail(3);
+
+    Vector f_expected(1);
+    f_expected << 2 * p.dot(x.cwiseProduct(x));
+    EXPECT_TRUE(composite.evaluate(input).isApprox(f_expected))
+        << "Function evaluation is incorrect.";
+
+    Matrix J_expected(1, COMPOSITE_INPUT_SIZE);
+    J_expected << 4 * p.cwiseProduct(x).transpose(),
+        2 * x.cwiseProduct(x).transpose();
+    EXPECT_TRUE(composite.jacobian(input).isApprox(J_expected))
+        << "Jacobian is incorrect.";
+
+    Matrix H_expected =
+        Matrix::Zero(COMPOSITE_INPUT_SIZE, COMPOSITE_INPUT_SIZE);
+    H_expected.topLeftCorner(3, 3).diagonal() = 4 * p;
+    H_expected.topRightCorner(3, 3).diagonal() = 4 * x;
+    H_expected.bottomLeftCorner(3, 3).diagonal() = 4 * x;
+    EXPECT_TRUE(composite.hessian(input, 0).isApprox(H_expected))
+        << "Hessian is incorrect.";
+
+    EXPECT_THROW(composite.hessian(input, 1), std::runtime_error)
+        << "Hessian with too-large output_dim did not throw.";
+    EXPECT_THROW(composite.evaluate(Vector::Ones(COMPOSITE_INPUT_SIZE + 1)),
+                 std::runtime_error)
+        << "Evaluate with input of wrong size did not throw.";
+}
+
+TEST_F(CompositeModelFixture, InvalidModels) {
+    CompositeModel<Scalar> composite(COMPOSITE_INPUT_SIZE);
+    EXPECT_THROW(composite.evaluate(Vector::Ones(COMPOSITE_INPUT_SIZE)),
+                 std::runtime_error)
+        << "Evaluate with no models did not throw.";
+
+    // Wrong number of indices
+    EXPECT_THROW(composite.add_model(*basic_model_ptr_, {0, 1}),
+                 std::runtime_error);
+
+    // Index of a value that is not yet available
+    EXPECT_THROW(composite.add_model(*basic_model_ptr_,
+                                     {0, 1, COMPOSITE_INPUT_SIZE}),
+                 std::runtime_error);
+}
+
+}  // namespace CompositeModelTest
+}  // namespace CppADCodeGenEigenPy
@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <Eigen/Eigen>
+#include <boost/filesystem.hpp>
+
+#include <CppADCodeGenEigenPy/ADModel.h>
+#include <CppADCodeGenEigenPy/CompiledModel.h>
+#include <CppADCodeGenEigenPy/EvaluationClient.h>
+#include <CppADCodeGenEigenPy/EvaluationServer.h>
+
+#include "testing/models/BasicTestModel.h"
+#include "testing/models/ParameterizedTestModel.h"
+
+namespace CppADCodeGenEigenPy {
+namespace EvaluationServerTest {
+
+using Scalar = double;
+using Vector = CompiledModel<Scalar>::Vector;
+using Matrix = CompiledModel<Scalar>::Matrix;
+
+const std::string DIRECTORY_PATH = BasicModelTest::DIRECTORY_PATH;
+const std::string SERVER_NAME =
+    "EvaluationServerTest." + std::to_string(getpid());
+
+class EvaluationServerFixture : public ::testing::Test {
+   protected:
+    static void SetUpTestSuite() {
+        boost::filesystem::create_directories(DIRECTORY_PATH);
+        BasicModelTest::BasicTestModel<Scalar>().compile(
+            BasicModelTest::MODEL_NAME, DIRECTORY_PATH,
+            DerivativeOrder::First);
+        ParameterizedModelTest::ParameterizedTestModel<Scalar>().compile(
+            ParameterizedModelTest::MODEL_NAME, DIRECTORY_PATH,
+            DerivativeOrder::First);
+        basic_model_ptr_.reset(new CompiledModel<Scalar>(
+            BasicModelTest::MODEL_NAME, BasicModelTest::LIB_GENERIC_PATH));
+        param_model_ptr_.reset(
+            new CompiledModel<Scalar>(ParameterizedModelTest::MODEL_NAME,
+                                      ParameterizedModelTest::LIB_GENERIC_PATH));
+    }
+
+    static void TearDownTestSuite() {
+        // Delete the compiled shared objects.
+        boost::filesystem::remove_all(DIRECTORY_PATH);
+    }
+
+    void SetUp() override {
+        ServerOptions options;
+        options.num_threads = 2;
+        options.ring_capacity = 4;
+        server_ptr_.reset(new EvaluationServer<Scalar>(
+            SERVER_NAME, {*basic_model_ptr_, *param_model_ptr_}, options));
+    }
+
+    void TearDown() override { server_ptr_.reset(); }
+
+    static std::unique_ptr<CompiledModel<Scalar>> basic_model_ptr_;
+    static std::unique_ptr<CompiledModel<Scalar>> param_model_ptr_;
+    std::unique_ptr<EvaluationServer<Scalar>> server_ptr_;
+};
+
+std::unique_ptr<CompiledModel<Scalar>>
+    EvaluationServerFixture::basic_model_ptr_ = nullptr;
+std::unique_ptr<CompiledModel<Scalar>>
+    EvaluationServerFixture::param_model_ptr_ = nullptr;
+
+TEST_F(EvaluationServerFixture, Evaluate) {
+    EvaluationClient<Scalar> client(SERVER_NAME);
+    ASSERT_EQ(client.get_model_names().size(), 2u);
+    size_t basic = client.get_model_index(BasicModelTest::MODEL_NAME);
+    size_t param = client.get_model_index(ParameterizedModelTest::MODEL_NAME);
+    EXPECT_EQ(client.get_input_size(param),
+              param_model_ptr_->get_input_size());
+
+    Vector x = Vector::Random(BasicModelTest::NUM_INPUT);
+    EXPECT_TRUE(
+        client.evaluate(basic, x).isApprox(basic_model_ptr_->evaluate(x)))
+        << "Function evaluation is incorrect.";
+    EXPECT_TRUE(
+        client.jacobian(basic, x).isApprox(basic_model_ptr_->jacobian(x)))
+        << "Jacobian is incorrect.";
+
+    // Models with parameters take the input and parameters concatenated
+    Vector p = Vector::Random(ParameterizedModelTest::NUM_PARAM);
+    Vector xp(x.size() + p.size());
+    xp << x, p;
+    EXPECT_TRUE(client.evaluate(param, xp).isApprox(
+        param_model_ptr_->evaluate(x, p)))
+        << "Function evaluation with parameters is incorrect.";
+}
+
+TEST_F(EvaluationServerFixture, Pipelined) {
+    EvaluationClient<Scalar> client(SERVER_NAME);
+    size_t basic = client.get_model_index(BasicModelTest::MODEL_NAME);
+    Vector x = Vector::Random(BasicModelTest::NUM_INPUT);
+
+    std::vector<uint64_t> tickets;
+    for (size_t i = 0; i < client.get_ring_capacity(); ++i) {
+        tickets.push_back(client.submit(basic, Kernel::Evaluate, i * x));
+    }
+    EXPECT_THROW(client.submit(basic, Kernel::Evaluate, x), std::runtime_error)
+        << "Submitting beyond the ring capacity did not throw.";
+
+    // Results can be collected in any order
+    for (size_t i = tickets.size(); i-- > 0;) {
+        EXPECT_TRUE(client.collect(tickets[i]).isApprox(
+            basic_model_ptr_->evaluate(i * x)));
+    }
+    EXPECT_THROW(client.collect(tickets[0]), std::runtime_error)
+        << "Collecting a result twice did not throw.";
+}
+
+TEST_F(EvaluationServerFixture, MultipleProcesses) {
+    const int num_processes = 4;
+    const int num_requests = 1000;
+    for (int i = 0; i < num_processes; ++i) {
+        if (fork() == 0) {
+            bool correct = true;
+            {
+                EvaluationClient<Scalar> client(SERVER_NAME);
+                for (int j = 0; j < num_requests; ++j) {
+                    Vector x = Vector::Constant(BasicModelTest::NUM_INPUT, j);
+                    correct = correct && client.evaluate(0, x).isApprox(2 * x);
+                }
+            }
+            _exit(correct ? 0 : 1);
+        }
+    }
+
+    for (int i = 0; i < num_processes; ++i) {
+        int status;
+        wait(&status);
+        EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0)
+            << "Client process got incorrect results.";
+    }
+    EXPECT_EQ(server_ptr_->get_num_requests(),
+              static_cast<size_t>(num_processes * num_requests));
+    EXPECT_LE(server_ptr_->get_num_batches(),
+              server_ptr_->get_num_requests());
+}
+
+TEST_F(EvaluationServerFixture, Errors) {
+    EXPECT_THROW(EvaluationServer<Scalar>(SERVER_NAME, {*basic_model_ptr_}),
+                 std::runtime_error)
+        << "Starting a second server with the same name did not throw.";
+    EXPECT_THROW(EvaluationClient<Scalar>("NoSuchServer"), std::runtime_error)
+        << "Connecting to a server that is not running did not throw.";
+
+    EvaluationClient<Scalar> client(SERVER_NAME);
+    EXPECT_THROW(client.get_model_index("NoSuchModel"), std::runtime_error);
+    EXPECT_THROW(client.evaluate(0, Vector::Ones(1)), std::runtime_error)
+        << "Evaluating with input of wrong size did not throw.";
+
+    server_ptr_->stop();
+    EXPECT_THROW(client.evaluate(0, Vector::Ones(BasicModelTest::NUM_INPUT)),
+                 std::runtime_error)
+        << "Evaluating after the server stopped did not throw.";
+}
+
+}  // namespace EvaluationServerTest
+}  // namespace CppADCodeGenEigenPy
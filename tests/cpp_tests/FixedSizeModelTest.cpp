@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+
+#include <Eigen/Eigen>
+#include <boost/filesystem.hpp>
+
+#include <CppADCodeGenEigenPy/ADModel.h>
+#include <CppADCodeGenEigenPy/CompiledModel.h>
+#include <CppADCodeGenEigenPy/FixedSizeCompiledModel.h>
+
+#include "testing/models/ParameterizedTestModel.h"
+
+namespace CppADCodeGenEigenPy {
+namespace FixedSizeModelTest {
+
+using namespace ParameterizedModelTest;
+
+using FixedModel =
+    FixedSizeCompiledModel<Scalar, NUM_INPUT, NUM_OUTPUT, NUM_PARAM>;
+
+class FixedSizeModelFixture : public ::testing::Test {
+   protected:
+    static void SetUpTestSuite() {
+        // Compile and load our model
+        boost::filesystem::create_directories(DIRECTORY_PATH);
+        ParameterizedTestModel<Scalar>().compile(MODEL_NAME, DIRECTORY_PATH,
+                                                 DerivativeOrder::Second);
+        compiled_model_ptr_.reset(
+            new CompiledModel<Scalar>(MODEL_NAME, LIB_GENERIC_PATH));
+        fixed_model_ptr_.reset(new FixedModel(MODEL_NAME, LIB_GENERIC_PATH));
+    }
+
+    static void TearDownTestSuite() {
+        // Delete the compiled shared object.
+        boost::filesystem::remove_all(DIRECTORY_PATH);
+    }
+
+    static std::unique_ptr<CompiledModel<Scalar>> compiled_model_ptr_;
+    static std::unique_ptr<FixedModel> fixed_model_ptr_;
+};
+
+std::unique_ptr<CompiledModel<Scalar>>
+    FixedSizeModelFixture::compiled_model_ptr_ = nullptr;
+std::unique_ptr<FixedModel> FixedSizeModelFixture::fixed_model_ptr_ =
+    nullptr;
+
+TEST_F(FixedSizeModelFixture, MatchesCompiledModel) {
+    FixedModel::Input x = FixedModel::Input::Random();
+    FixedModel::Parameters p = FixedModel::Parameters::Random();
+
+    FixedModel::Output y = fixed_model_ptr_->evaluate(x, p);
+    FixedModel::Jacobian J = fixed_model_ptr_->jacobian(x, p);
+    FixedModel::Hessian H = fixed_model_ptr_->hessian(x, p, 0);
+
+    EXPECT_TRUE(y.isApprox(compiled_model_ptr_->evaluate(x, p)));
+    EXPECT_TRUE(J.isApprox(compiled_model_ptr_->jacobian(x, p)));
+    EXPECT_TRUE(H.isApprox(compiled_model_ptr_->hessian(x, p, 0)));
+}
+
+TEST_F(FixedSizeModelFixture, SparseKernels) {
+    // Multithreaded models only have the sparse Jacobian kernel, and models
+    // with a symmetric Hessian only the sparse Hessian kernel
+    CompileOptions options;
+    options.multithreading = Multithreading::ThreadPool;
+    options.symmetric_hessian = true;
+    ParameterizedTestModel<Scalar>().compile(MODEL_NAME + "Sparse",
+                                             DIRECTORY_PATH, options);
+    FixedModel model(
+        MODEL_NAME + "Sparse",
+        get_library_generic_path(MODEL_NAME + "Sparse", DIRECTORY_PATH));
+
+    FixedModel::Input x = FixedModel::Input::Random();
+    FixedModel::Parameters p = FixedModel::Parameters::Random();
+    EXPECT_TRUE(
+        model.jacobian(x, p).isApprox(fixed_model_ptr_->jacobian(x, p)));
+    EXPECT_TRUE(
+        model.hessian(x, p, 0).isApprox(fixed_model_ptr_->hessian(x, p, 0)));
+}
+
+TEST_F(FixedSizeModelFixture, SizeMismatch) {
+    using WrongInputModel =
+        FixedSizeCompiledModel<Scalar, NUM_INPUT + 1, NUM_OUTPUT, NUM_PARAM>;
+    using WrongOutputModel =
+        FixedSizeCompiledModel<Scalar, NUM_INPUT, NUM_OUTPUT + 1, NUM_PARAM>;
+
+    EXPECT_THROW(WrongInputModel(MODEL_NAME, LIB_GENERIC_PATH),
+                 std::runtime_error);
+    EXPECT_THROW(WrongOutputModel(MODEL_NAME, LIB_GENERIC_PATH),
+                 std::runtime_error);
+}
+
+TEST_F(FixedSizeModelFixture, InvalidOutputDimension) {
+    FixedModel::Input x = FixedModel::Input::Ones();
+    FixedModel::Parameters p = FixedModel::Parameters::Ones();
+    EXPECT_THROW(fixed_model_ptr_->hessian(x, p, NUM_OUTPUT),
+                 std::runtime_error);
+}
+
+}  // namespace FixedSizeModelTest
+}  // namespace CppADCodeGenEigenPy
@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+
+#include <Eigen/Eigen>
+#include <boost/filesystem.hpp>
+
+#include <CppADCodeGenEigenPy/ADModel.h>
+#include <CppADCodeGenEigenPy/CompiledModel.h>
+#include <CppADCodeGenEigenPy/ModelGroup.h>
+
+#include "testing/models/BasicTestModel.h"
+#include "testing/models/ParameterizedTestModel.h"
+
+namespace CppADCodeGenEigenPy {
+namespace ModelGroupTest {
+
+using Scalar = double;
+using Vector = CompiledModel<Scalar>::Vector;
+
+const std::string DIRECTORY_PATH = BasicModelTest::DIRECTORY_PATH;
+
+// Flat input shared by the members: the basic model uses the first three
+// elements; the parameterized model uses all six
+const size_t GROUP_INPUT_SIZE = 6;
+
+class ModelGroupFixture : public ::testing::Test {
+   protected:
+    static void SetUpTestSuite() {
+        boost::filesystem::create_directories(DIRECTORY_PATH);
+        BasicModelTest::BasicTestModel<Scalar>().compile(
+            BasicModelTest::MODEL_NAME, DIRECTORY_PATH,
+            DerivativeOrder::Second);
+        ParameterizedModelTest::ParameterizedTestModel<Scalar>().compile(
+            ParameterizedModelTest::MODEL_NAME, DIRECTORY_PATH,
+            DerivativeOrder::Second);
+        basic_model_ptr_.reset(new CompiledModel<Scalar>(
+            BasicModelTest::MODEL_NAME, BasicModelTest::LIB_GENERIC_PATH));
+        param_model_ptr_.reset(
+            new CompiledModel<Scalar>(ParameterizedModelTest::MODEL_NAME,
+                                      ParameterizedModelTest::LIB_GENERIC_PATH));
+    }
+
+    static void TearDownTestSuite() {
+        // Delete the compiled shared objects.
+        boost::filesystem::remove_all(DIRECTORY_PATH);
+    }
+
+    static std::unique_ptr<CompiledModel<Scalar>> basic_model_ptr_;
+    static std::unique_ptr<CompiledModel<Scalar>> param_model_ptr_;
+};
+
+std::unique_ptr<CompiledModel<Scalar>> ModelGroupFixture::basic_model_ptr_ =
+    nullptr;
+std::unique_ptr<CompiledModel<Scalar>> ModelGroupFixture::param_model_ptr_ =
+    nullptr;
+
+TEST_F(ModelGroupFixture, MatchesMembers) {
+    for (size_t num_threads : {1, 2}) {
+        ModelGroup<Scalar> group(GROUP_INPUT_SIZE, num_threads);
+        group.add_model("basic", *basic_model_ptr_, {0, 1, 2});
+        group.add_model("param", *param_model_ptr_, {0, 1, 2, 3, 4, 5},
+                        /* jacobian = */ true, /* hessian_outputs = */ {0});
+        EXPECT_EQ(group.get_num_models(), 2u);
+
+        Vector input = Vector::Random(GROUP_INPUT_SIZE);
+        const std::vector<ModelGroup<Scalar>::Result>& results =
+            group.evaluate(input);
+        ASSERT_EQ(results.size(), 2u);
+
+        EXPECT_EQ(results[0].name, "basic");
+        EXPECT_TRUE(results[0].value.isApprox(
+            basic_model_ptr_->evaluate(input.head(3))));
+        EXPECT_EQ(results[0].jacobian.size(), 0);
+        EXPECT_TRUE(results[0].hessians.empty());
+
+        EXPECT_EQ(results[1].name, "param");
+        EXPECT_TRUE(
+            results[1].value.isApprox(param_model_ptr_->evaluate(input)));
+        EXPECT_TRUE(
+            results[1].jacobian.isApprox(param_model_ptr_->jacobian(input)));
+        ASSERT_EQ(results[1].hessians.size(), 1u);
+        EXPECT_TRUE(results[1].hessians[0].isApprox(
+            param_model_ptr_->hessian(input, 0)));
+    }
+}
+
+TEST_F(ModelGroupFixture, InvalidMembers) {
+    ModelGroup<Scalar> group(GROUP_INPUT_SIZE);
+
+    // Wrong number of indices
+    EXPECT_THROW(group.add_model("basic", *basic_model_ptr_, {0, 1}),
+                 std::runtime_error);
+
+    // Index out of range
+    EXPECT_THROW(group.add_model("basic", *basic_model_ptr_, {0, 1, 6}),
+                 std::runtime_error);
+
+    // Output dimension out of range
+    EXPECT_THROW(
+        group.add_model("basic", *basic_model_ptr_, {0, 1, 2}, false, {3}),
+        std::runtime_error);
+
+    // Duplicate name
+    group.add_model("basic", *basic_model_ptr_, {0, 1, 2});
+    EXPECT_THROW(group.add_model("basic", *basic_model_ptr_, {3, 4, 5}),
+                 std::runtime_error);
+
+    // Wrong input size
+    EXPECT_THROW(group.evaluate(Vector::Ones(GROUP_INPUT_SIZE + 1)),
+                 std::runtime_error);
+}
+
+}  // namespace ModelGroupTest
+}  // namespace CppADCodeGenEigenPy
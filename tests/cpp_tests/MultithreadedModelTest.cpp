@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+
+#include <Eigen/Eigen>
+#include <boost/filesystem.hpp>
+
+#include <CppADCodeGenEigenPy/ADModel.h>
+#include <CppADCodeGenEigenPy/CompiledModel.h>
+
+#include "testing/models/ParameterizedTestModel.h"
+
+namespace CppADCodeGenEigenPy {
+namespace MultithreadedModelTest {
+
+using namespace ParameterizedModelTest;
+
+const std::string MT_MODEL_NAME = MODEL_NAME + "Multithreaded";
+
+class MultithreadedModelFixture : public ::testing::Test {
+   protected:
+    using Vector = CompiledModel<Scalar>::Vector;
+    using Matrix = CompiledModel<Scalar>::Matrix;
+
+    static void SetUpTestSuite() {
+        // Compile the model both with and without multithreading
+        boost::filesystem::create_directories(DIRECTORY_PATH);
+        ParameterizedTestModel<Scalar>().compile(MODEL_NAME, DIRECTORY_PATH,
+                                                 DerivativeOrder::Second);
+        compiled_model_ptr_.reset(
+            new CompiledModel<Scalar>(MODEL_NAME, LIB_GENERIC_PATH));
+
+        CompileOptions options;
+        options.multithreading = Multithreading::ThreadPool;
+        ParameterizedTestModel<Scalar>().compile(MT_MODEL_NAME,
+                                                 DIRECTORY_PATH, options);
+        mt_model_ptr_.reset(new CompiledModel<Scalar>(
+            MT_MODEL_NAME,
+            get_library_generic_path(MT_MODEL_NAME, DIRECTORY_PATH)));
+    }
+
+    static void TearDownTestSuite() {
+        // Delete the compiled shared objects.
+        boost::filesystem::remove_all(DIRECTORY_PATH);
+    }
+
+    static std::unique_ptr<CompiledModel<Scalar>> compiled_model_ptr_;
+    static std::unique_ptr<CompiledModel<Scalar>> mt_model_ptr_;
+};
+
+std::unique_ptr<CompiledModel<Scalar>>
+    MultithreadedModelFixture::compiled_model_ptr_ = nullptr;
+std::unique_ptr<CompiledModel<Scalar>>
+    MultithreadedModelFixture::mt_model_ptr_ = nullptr;
+
+TEST_F(MultithreadedModelFixture, MatchesSingleThreaded) {
+    Vector x = Vector::Random(NUM_INPUT);
+    Vector p = Vector::Random(NUM_PARAM);
+
+    for (size_t num_threads : {1, 2, 4}) {
+        mt_model_ptr_->set_num_threads(num_threads);
+
+        EXPECT_TRUE(mt_model_ptr_->evaluate(x, p).isApprox(
+            compiled_model_ptr_->evaluate(x, p)));
+        EXPECT_TRUE(mt_model_ptr_->jacobian(x, p).isApprox(
+            compiled_model_ptr_->jacobian(x, p)));
+        EXPECT_TRUE(mt_model_ptr_->hessian(x, p, 0).isApprox(
+            compiled_model_ptr_->hessian(x, p, 0)));
+    }
+}
+
+TEST_F(MultithreadedModelFixture, NumThreads) {
+    mt_model_ptr_->set_num_threads(3);
+    EXPECT_EQ(mt_model_ptr_->get_num_threads(), 3u);
+
+    // Only multithreaded models have more than one thread
+    compiled_model_ptr_->set_num_threads(3);
+    EXPECT_EQ(compiled_model_ptr_->get_num_threads(), 1u);
+}
+
+}  // namespace MultithreadedModelTest
+}  // namespace CppADCodeGenEigenPy
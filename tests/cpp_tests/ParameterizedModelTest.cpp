@@ -70,6 +70,35 @@ TEST_F(ParameterizedTestModelFixture, Jacobian) {
         << "Missing parameters did not throw error.";
 }
 
+TEST_F(ParameterizedTestModelFixture, Gradient) {
+    Vector input = 2 * Vector::Ones(NUM_INPUT);
+    Vector parameters = Vector::Ones(NUM_INPUT);
+
+    Vector g_expected = parameters.cwiseProduct(input);
+    Vector g_actual = compiled_model_ptr_->gradient(input, parameters);
+    EXPECT_TRUE(g_actual.isApprox(g_expected)) << "Gradient is incorrect.";
+
+    EXPECT_THROW(compiled_model_ptr_->gradient(input), std::runtime_error)
+        << "Missing parameters did not throw error.";
+}
+
+TEST_F(ParameterizedTestModelFixture, JacobianModes) {
+    Vector input = 2 * Vector::Ones(NUM_INPUT);
+    Vector parameters = Vector::Ones(NUM_INPUT);
+    Matrix J_expected = compiled_model_ptr_->jacobian(input, parameters);
+
+    // The Jacobian is the same whichever mode it was generated with
+    CompileOptions options;
+    options.order = DerivativeOrder::First;
+    for (JacobianMode mode : {JacobianMode::Forward, JacobianMode::Reverse}) {
+        options.jacobian_mode = mode;
+        CompiledModel<Scalar> model = ad_model_ptr_->compile(
+            MODEL_NAME + "Mode", DIRECTORY_PATH, options);
+        EXPECT_TRUE(model.jacobian(input, parameters).isApprox(J_expected))
+            << "Jacobian is incorrect.";
+    }
+}
+
 TEST_F(ParameterizedTestModelFixture, Hessian) {
     Vector input = 2 * Vector::Ones(NUM_INPUT);
     Vector parameters = Vector::Ones(NUM_INPUT);
@@ -82,5 +111,273 @@ TEST_F(ParameterizedTestModelFixture, Hessian) {
         << "Missing parameters did not throw error.";
 }
 
+TEST_F(ParameterizedTestModelFixture, SymmetricHessian) {
+    Vector input = Vector::Random(NUM_INPUT);
+    Vector parameters = Vector::Random(NUM_PARAM);
+    Vector xp(NUM_INPUT + NUM_PARAM);
+    xp << input, parameters;
+
+    // The Hessian with respect to both input and parameters has
+    // off-diagonal blocks, which must be mirrored from the lower triangle
+    Matrix H_expected = compiled_model_ptr_->hessian(xp, 0);
+    Vector packed_expected((xp.size() * (xp.size() + 1)) / 2);
+    for (Eigen::Index i = 0, k = 0; i < xp.size(); ++i) {
+        for (Eigen::Index j = 0; j <= i; ++j, ++k) {
+            packed_expected(k) = H_expected(i, j);
+        }
+    }
+    EXPECT_TRUE(compiled_model_ptr_->hessian_packed(xp, 0).isApprox(
+        packed_expected))
+        << "Packed Hessian of full model is incorrect.";
+
+    CompileOptions options;
+    options.symmetric_hessian = true;
+    CompiledModel<Scalar> model = ad_model_ptr_->compile(
+        MODEL_NAME + "Symmetric", DIRECTORY_PATH, options);
+    EXPECT_TRUE(model.hessian(xp, 0).isApprox(H_expected))
+        << "Hessian is incorrect.";
+    EXPECT_TRUE(model.hessian_packed(xp, 0).isApprox(packed_expected))
+        << "Packed Hessian is incorrect.";
+
+    // With parameters, the triangle of the input block is a prefix
+    Vector packed_input = model.hessian_packed(input, parameters, 0);
+    EXPECT_EQ(packed_input.size(), NUM_INPUT * (NUM_INPUT + 1) / 2);
+    EXPECT_TRUE(packed_input.isApprox(
+        packed_expected.head(NUM_INPUT * (NUM_INPUT + 1) / 2)))
+        << "Packed Hessian with parameters is incorrect.";
+
+    EXPECT_THROW(model.hessian_packed(input, 0), std::runtime_error)
+        << "Missing parameters did not throw error.";
+    EXPECT_THROW(model.hessian_packed(xp, NUM_OUTPUT), std::runtime_error)
+        << "Invalid output dimension did not throw error.";
+}
+
+TEST_F(ParameterizedTestModelFixture, ParameterDerivatives) {
+    Vector input = Vector::Random(NUM_INPUT);
+    Vector parameters = Vector::Random(NUM_PARAM);
+    Vector xp(NUM_INPUT + NUM_PARAM);
+    xp << input, parameters;
+
+    // The parameter derivatives are blocks of the full derivatives with
+    // respect to both input and parameters
+    Matrix J_full = compiled_model_ptr_->jacobian(xp);
+    Matrix H_full = compiled_model_ptr_->hessian(xp, 0);
+
+    CompileOptions options;
+    options.parameter_derivatives = true;
+    CompiledModel<Scalar> model = ad_model_ptr_->compile(
+        MODEL_NAME + "ParameterDerivatives", DIRECTORY_PATH, options);
+
+    Matrix J_actual = model.parameter_jacobian(input, parameters);
+    EXPECT_EQ(J_actual.rows(), NUM_OUTPUT);
+    EXPECT_EQ(J_actual.cols(), NUM_PARAM);
+    EXPECT_TRUE(J_actual.isApprox(J_full.rightCols(NUM_PARAM)))
+        << "Parameter Jacobian is incorrect.";
+
+    Matrix H_actual = model.mixed_hessian(input, parameters, 0);
+    EXPECT_EQ(H_actual.rows(), NUM_INPUT);
+    EXPECT_EQ(H_actual.cols(), NUM_PARAM);
+    EXPECT_TRUE(H_actual.isApprox(H_full.topRightCorner(NUM_INPUT, NUM_PARAM)))
+        << "Mixed Hessian is incorrect.";
+
+    EXPECT_THROW(model.parameter_jacobian(xp, Vector()), std::runtime_error)
+        << "Missing parameters did not throw error.";
+    EXPECT_THROW(model.mixed_hessian(input, parameters, NUM_OUTPUT),
+                 std::runtime_error)
+        << "Invalid output dimension did not throw error.";
+
+    // Reductions with respect to the parameters use the parameter kernel
+    Matrix inputs = Matrix::Random(5, NUM_INPUT);
+    CompiledModel<Scalar>::Reduction sums = model.reduce(
+        inputs, parameters.transpose(), Matrix(), true, true);
+    CompiledModel<Scalar>::Reduction expected_sums =
+        compiled_model_ptr_->reduce(inputs, parameters.transpose(), Matrix(),
+                                    true, true);
+    EXPECT_TRUE(sums.gradient.isApprox(expected_sums.gradient))
+        << "Gradient of reduction with parameter kernel is incorrect.";
+    EXPECT_TRUE(sums.gauss_newton.isApprox(expected_sums.gauss_newton))
+        << "Gauss-Newton matrix of reduction with parameter kernel is "
+           "incorrect.";
+
+    // The kernels are only generated when requested
+    EXPECT_THROW(compiled_model_ptr_->parameter_jacobian(input, parameters),
+                 std::runtime_error)
+        << "Parameter Jacobian of model without it did not throw error.";
+
+    options.order = DerivativeOrder::First;
+    CompiledModel<Scalar> first_order_model = ad_model_ptr_->compile(
+        MODEL_NAME + "ParameterDerivativesFirst", DIRECTORY_PATH, options);
+    EXPECT_TRUE(first_order_model.parameter_jacobian(input, parameters)
+                    .isApprox(J_actual))
+        << "Parameter Jacobian of first-order model is incorrect.";
+    EXPECT_THROW(first_order_model.mixed_hessian(input, parameters, 0),
+                 std::runtime_error)
+        << "Mixed Hessian of first-order model did not throw error.";
+}
+
+TEST_F(ParameterizedTestModelFixture, LazyDerivatives) {
+    Vector input = 2 * Vector::Ones(NUM_INPUT);
+    Vector parameters = Vector::Ones(NUM_INPUT);
+    Vector f_expected = compiled_model_ptr_->evaluate(input, parameters);
+    Matrix J_expected = compiled_model_ptr_->jacobian(input, parameters);
+    Matrix H_expected = compiled_model_ptr_->hessian(input, parameters, 0);
+
+    for (bool background : {true, false}) {
+        CompiledModel<Scalar> model = ad_model_ptr_->compile_lazy(
+            MODEL_NAME + "Lazy", DIRECTORY_PATH, CompileOptions(), background);
+        if (!background) {
+            EXPECT_FALSE(model.derivatives_ready())
+                << "Deferred derivatives are ready before waiting.";
+        }
+
+        // The function is available immediately
+        EXPECT_TRUE(model.evaluate(input, parameters).isApprox(f_expected))
+            << "Function evaluation is incorrect.";
+
+        // Derivatives are served without modifying the model
+        const CompiledModel<Scalar>& const_model = model;
+        EXPECT_TRUE(
+            const_model.jacobian(input, parameters).isApprox(J_expected))
+            << "Jacobian is incorrect.";
+        EXPECT_TRUE(model.derivatives_ready())
+            << "Derivatives are not ready after waiting.";
+        EXPECT_TRUE(
+            const_model.hessian(input, parameters, 0).isApprox(H_expected))
+            << "Hessian is incorrect.";
+
+        // A copy waits for the derivatives and uses them
+        CompiledModel<Scalar> copy(model);
+        EXPECT_TRUE(copy.jacobian(input, parameters).isApprox(J_expected))
+            << "Jacobian of copy is incorrect.";
+
+        // References to the generic model stay valid when switching
+        const std::string function_path = model.get_library_path();
+        CppAD::cg::GenericModel<Scalar>& generic_model =
+            model.get_generic_model();
+        model.wait_for_derivatives();
+        EXPECT_NE(model.get_library_path(), function_path)
+            << "Model did not switch to the derivative library.";
+        EXPECT_EQ(&model.get_generic_model(), &generic_model)
+            << "Generic model changed when switching.";
+        EXPECT_TRUE(model.jacobian(input, parameters).isApprox(J_expected))
+            << "Jacobian after switching is incorrect.";
+        EXPECT_TRUE(model.evaluate(input, parameters).isApprox(f_expected))
+            << "Function evaluation after switching is incorrect.";
+    }
+
+    // Without derivatives, there is nothing to wait for
+    CompileOptions options;
+    options.order = DerivativeOrder::Zero;
+    CompiledModel<Scalar> model = ad_model_ptr_->compile_lazy(
+        MODEL_NAME + "LazyZero", DIRECTORY_PATH, options);
+    EXPECT_TRUE(model.derivatives_ready());
+    EXPECT_THROW(model.jacobian(input, parameters), std::runtime_error)
+        << "Jacobian of zero-order model did not throw.";
+
+    // The parameter kernel is only in the derivative library, so the
+    // parameter derivatives must be served from it without waiting first
+    Vector xp(NUM_INPUT + NUM_PARAM);
+    xp << input, parameters;
+    Matrix J_full = compiled_model_ptr_->jacobian(xp);
+    Matrix H_full = compiled_model_ptr_->hessian(xp, 0);
+    options.order = DerivativeOrder::Second;
+    options.parameter_derivatives = true;
+    CompiledModel<Scalar> parameter_model = ad_model_ptr_->compile_lazy(
+        MODEL_NAME + "LazyParameters", DIRECTORY_PATH, options);
+    EXPECT_TRUE(parameter_model.parameter_jacobian(input, parameters)
+                    .isApprox(J_full.rightCols(NUM_PARAM)))
+        << "Lazy parameter Jacobian is incorrect.";
+    EXPECT_TRUE(parameter_model.mixed_hessian(input, parameters, 0)
+                    .isApprox(H_full.topRightCorner(NUM_INPUT, NUM_PARAM)))
+        << "Lazy mixed Hessian is incorrect.";
+}
+
+TEST_F(ParameterizedTestModelFixture, Reduce) {
+    const size_t N = 7;
+    Matrix inputs = Matrix::Random(N, NUM_INPUT);
+    Matrix parameters = Matrix::Random(N, NUM_PARAM);
+    Matrix weights = Matrix::Random(N, NUM_OUTPUT);
+    const CompiledModel<Scalar>& model = *compiled_model_ptr_;
+
+    // Sums of the individual evaluations, with the parameters shared or not
+    for (bool shared : {false, true}) {
+        Matrix p = shared ? Matrix(parameters.topRows(1)) : parameters;
+        Vector f_sum = Vector::Zero(NUM_OUTPUT);
+        Scalar f_squared_sum = 0;
+        Vector g_sum = Vector::Zero(NUM_INPUT);
+        Vector g_weighted_sum = Vector::Zero(NUM_INPUT);
+        Matrix JTJ_sum = Matrix::Zero(NUM_INPUT, NUM_INPUT);
+        for (size_t i = 0; i < N; ++i) {
+            Vector x = inputs.row(i).transpose();
+            Vector pi = p.row(shared ? 0 : i).transpose();
+            Vector f = model.evaluate(x, pi);
+            Matrix J = model.jacobian(x, pi);
+            f_sum += f;
+            f_squared_sum += f.squaredNorm();
+            g_sum += J.transpose() * f;
+            g_weighted_sum += J.transpose() * weights.row(i).transpose();
+            JTJ_sum += J.transpose() * J;
+        }
+
+        for (size_t num_threads : {1, 3, 0}) {
+            CompiledModel<Scalar>::Reduction sums =
+                model.reduce(inputs, p, Matrix(), true, false, num_threads);
+            EXPECT_TRUE(sums.output_sum.isApprox(f_sum))
+                << "Output sum is incorrect.";
+            EXPECT_NEAR(sums.squared_output_sum, f_squared_sum, 1e-10)
+                << "Squared output sum is incorrect.";
+            EXPECT_TRUE(sums.gradient.isApprox(g_sum))
+                << "Gradient is incorrect.";
+            EXPECT_TRUE(sums.gauss_newton.isApprox(JTJ_sum))
+                << "Gauss-Newton matrix is incorrect.";
+
+            sums =
+                model.reduce(inputs, p, weights, false, false, num_threads);
+            EXPECT_TRUE(sums.gradient.isApprox(g_weighted_sum))
+                << "Weighted gradient is incorrect.";
+            EXPECT_EQ(sums.gauss_newton.size(), 0)
+                << "Gauss-Newton matrix computed without being requested.";
+        }
+    }
+
+    // With respect to the parameters, for fitting them to the inputs
+    Vector g_parameters = Vector::Zero(NUM_PARAM);
+    Matrix JTJ_parameters = Matrix::Zero(NUM_PARAM, NUM_PARAM);
+    for (size_t i = 0; i < N; ++i) {
+        Vector xp(NUM_INPUT + NUM_PARAM);
+        xp << inputs.row(i).transpose(), parameters.row(0).transpose();
+        Matrix J = model.jacobian(xp).rightCols(NUM_PARAM);
+        g_parameters += J.transpose() * model.evaluate(xp);
+        JTJ_parameters += J.transpose() * J;
+    }
+    CompiledModel<Scalar>::Reduction parameter_sums =
+        model.reduce(inputs, parameters.topRows(1), Matrix(), true, true);
+    EXPECT_TRUE(parameter_sums.gradient.isApprox(g_parameters))
+        << "Gradient with respect to the parameters is incorrect.";
+    EXPECT_TRUE(parameter_sums.gauss_newton.isApprox(JTJ_parameters))
+        << "Gauss-Newton matrix with respect to the parameters is "
+           "incorrect.";
+
+    // An empty dataset has zero sums
+    CompiledModel<Scalar>::Reduction sums = model.reduce(
+        Matrix(0, NUM_INPUT), Matrix(0, NUM_PARAM), Matrix(), true);
+    EXPECT_TRUE(sums.output_sum.isZero());
+    EXPECT_TRUE(sums.gradient.isZero());
+    EXPECT_TRUE(sums.gauss_newton.isZero());
+
+    EXPECT_THROW(model.reduce(inputs, parameters.topRows(N - 1)),
+                 std::runtime_error)
+        << "Mismatched number of samples did not throw error.";
+    EXPECT_THROW(model.reduce(inputs), std::runtime_error)
+        << "Missing parameters did not throw error.";
+    EXPECT_THROW(model.reduce(inputs, Matrix(), Matrix(), false, true),
+                 std::runtime_error)
+        << "Reduction with respect to missing parameters did not throw "
+           "error.";
+    EXPECT_THROW(model.reduce(inputs, parameters, Matrix::Ones(N, 2)),
+                 std::runtime_error)
+        << "Weights of wrong size did not throw error.";
+}
+
 }  // namespace ParameterizedModelTest
 }  // namespace CppADCodeGenEigenPy
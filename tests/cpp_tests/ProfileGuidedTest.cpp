@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+
+#include <Eigen/Eigen>
+#include <boost/filesystem.hpp>
+
+#include <CppADCodeGenEigenPy/ADModel.h>
+#include <CppADCodeGenEigenPy/CompiledModel.h>
+
+#include "testing/models/ParameterizedTestModel.h"
+
+namespace CppADCodeGenEigenPy {
+namespace ProfileGuidedTest {
+
+using namespace ParameterizedModelTest;
+
+const std::string PGO_MODEL_NAME = MODEL_NAME + "ProfileGuided";
+
+class ProfileGuidedFixture : public ::testing::Test {
+   protected:
+    using Vector = CompiledModel<Scalar>::Vector;
+    using Matrix = CompiledModel<Scalar>::Matrix;
+
+    static void SetUpTestSuite() {
+        boost::filesystem::create_directories(DIRECTORY_PATH);
+        ParameterizedTestModel<Scalar>().compile(MODEL_NAME, DIRECTORY_PATH,
+                                                 DerivativeOrder::Second);
+        compiled_model_ptr_.reset(
+            new CompiledModel<Scalar>(MODEL_NAME, LIB_GENERIC_PATH));
+
+        std::vector<Vector> profile_inputs;
+        for (int i = 0; i < 10; ++i) {
+            profile_inputs.push_back(Vector::Random(NUM_INPUT + NUM_PARAM));
+        }
+        pgo_model_ptr_.reset(new CompiledModel<Scalar>(
+            ParameterizedTestModel<Scalar>().compile_with_profile(
+                PGO_MODEL_NAME, DIRECTORY_PATH, profile_inputs)));
+    }
+
+    static void TearDownTestSuite() {
+        // Delete the compiled shared objects.
+        boost::filesystem::remove_all(DIRECTORY_PATH);
+    }
+
+    static std::unique_ptr<CompiledModel<Scalar>> compiled_model_ptr_;
+    static std::unique_ptr<CompiledModel<Scalar>> pgo_model_ptr_;
+};
+
+std::unique_ptr<CompiledModel<Scalar>>
+    ProfileGuidedFixture::compiled_model_ptr_ = nullptr;
+std::unique_ptr<CompiledModel<Scalar>>
+    ProfileGuidedFixture::pgo_model_ptr_ = nullptr;
+
+TEST_F(ProfileGuidedFixture, MatchesUnprofiled) {
+    Vector x = Vector::Random(NUM_INPUT);
+    Vector p = Vector::Random(NUM_PARAM);
+
+    EXPECT_TRUE(pgo_model_ptr_->evaluate(x, p).isApprox(
+        compiled_model_ptr_->evaluate(x, p)));
+    EXPECT_TRUE(pgo_model_ptr_->jacobian(x, p).isApprox(
+        compiled_model_ptr_->jacobian(x, p)));
+    EXPECT_TRUE(pgo_model_ptr_->hessian(x, p, 0).isApprox(
+        compiled_model_ptr_->hessian(x, p, 0)));
+}
+
+TEST_F(ProfileGuidedFixture, ProfileRemoved) {
+    EXPECT_FALSE(boost::filesystem::exists(DIRECTORY_PATH + "/" +
+                                           PGO_MODEL_NAME + "_profile"));
+}
+
+}  // namespace ProfileGuidedTest
+}  // namespace CppADCodeGenEigenPy
@@ -0,0 +1,224 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+
+#include <Eigen/Eigen>
+#include <boost/filesystem.hpp>
+
+#include <CppADCodeGenEigenPy/ADModel.h>
+#include <CppADCodeGenEigenPy/CompiledModel.h>
+#include <CppADCodeGenEigenPy/RealtimeModel.h>
+
+#include "testing/models/ParameterizedTestModel.h"
+
+// Count heap allocations made while a test has counting enabled. This
+// replaces the C allocation functions for the whole executable, which is why
+// these tests are built separately from the other model tests.
+static std::atomic<bool> count_allocations(false);
+static std::atomic<size_t> num_allocations(0);
+
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_calloc(size_t count, size_t size);
+extern "C" void* __libc_realloc(void* ptr, size_t size);
+extern "C" void* __libc_memalign(size_t alignment, size_t size);
+
+static void record_allocation() {
+    if (count_allocations) {
+        ++num_allocations;
+    }
+}
+
+extern "C" void* malloc(size_t size) {
+    record_allocation();
+    return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t count, size_t size) {
+    record_allocation();
+    return __libc_calloc(count, size);
+}
+
+extern "C" void* realloc(void* ptr, size_t size) {
+    record_allocation();
+    return __libc_realloc(ptr, size);
+}
+
+extern "C" void* memalign(size_t alignment, size_t size) {
+    record_allocation();
+    return __libc_memalign(alignment, size);
+}
+
+extern "C" void* aligned_alloc(size_t alignment, size_t size) {
+    record_allocation();
+    return __libc_memalign(alignment, size);
+}
+
+extern "C" int posix_memalign(void** ptr, size_t alignment, size_t size) {
+    if (alignment % sizeof(void*) != 0 ||
+        (alignment & (alignment - 1)) != 0) {
+        return EINVAL;
+    }
+    record_allocation();
+    void* result = __libc_memalign(alignment, size);
+    if (!result) {
+        return ENOMEM;
+    }
+    *ptr = result;
+    return 0;
+}
+
+namespace CppADCodeGenEigenPy {
+namespace RealtimeModelTest {
+
+using namespace ParameterizedModelTest;
+
+class RealtimeModelFixture : public ::testing::Test {
+   protected:
+    using Vector = CompiledModel<Scalar>::Vector;
+    using Matrix = CompiledModel<Scalar>::Matrix;
+
+    static void SetUpTestSuite() {
+        // Compile and load our model
+        boost::filesystem::create_directories(DIRECTORY_PATH);
+        ParameterizedTestModel<Scalar>().compile(MODEL_NAME, DIRECTORY_PATH,
+                                                 DerivativeOrder::Second);
+        compiled_model_ptr_.reset(
+            new CompiledModel<Scalar>(MODEL_NAME, LIB_GENERIC_PATH));
+    }
+
+    static void TearDownTestSuite() {
+        // Delete the compiled shared object.
+        boost::filesystem::remove_all(DIRECTORY_PATH);
+    }
+
+    static std::unique_ptr<CompiledModel<Scalar>> compiled_model_ptr_;
+};
+
+std::unique_ptr<CompiledModel<Scalar>>
+    RealtimeModelFixture::compiled_model_ptr_ = nullptr;
+
+TEST_F(RealtimeModelFixture, MatchesCompiledModel) {
+    RealtimeModel<Scalar> model(*compiled_model_ptr_);
+
+    Vector x = Vector::Random(NUM_INPUT);
+    Vector p = Vector::Random(NUM_PARAM);
+
+    Vector y(NUM_OUTPUT);
+    Matrix J(NUM_OUTPUT, NUM_INPUT);
+    Matrix H(NUM_INPUT, NUM_INPUT);
+
+    EXPECT_EQ(model.evaluate(x, p, y), Status::Success);
+    EXPECT_EQ(model.jacobian(x, p, J), Status::Success);
+    EXPECT_EQ(model.hessian(x, p, 0, H), Status::Success);
+
+    EXPECT_TRUE(y.isApprox(compiled_model_ptr_->evaluate(x, p)));
+    EXPECT_TRUE(J.isApprox(compiled_model_ptr_->jacobian(x, p)));
+    EXPECT_TRUE(H.isApprox(compiled_model_ptr_->hessian(x, p, 0)));
+
+    // Inputs with parameters already appended
+    Vector xp(NUM_INPUT + NUM_PARAM);
+    xp << x, p;
+    Matrix J_full(NUM_OUTPUT, NUM_INPUT + NUM_PARAM);
+    EXPECT_EQ(model.jacobian(xp, J_full), Status::Success);
+    EXPECT_TRUE(J_full.isApprox(compiled_model_ptr_->jacobian(xp)));
+}
+
+TEST_F(RealtimeModelFixture, DoesNotAllocate) {
+    RealtimeModel<Scalar> model(*compiled_model_ptr_);
+
+    Vector x = Vector::Random(NUM_INPUT);
+    Vector p = Vector::Random(NUM_PARAM);
+    Vector y(NUM_OUTPUT);
+    Matrix J(NUM_OUTPUT, NUM_INPUT);
+    Matrix H(NUM_INPUT, NUM_INPUT);
+
+    // First call outside of the counted region so that lazy symbol binding
+    // in the model library is not counted
+    model.evaluate(x, p, y);
+    model.jacobian(x, p, J);
+    model.hessian(x, p, 0, H);
+
+    num_allocations = 0;
+    count_allocations = true;
+    for (int i = 0; i < 100; ++i) {
+        model.evaluate(x, p, y);
+        model.jacobian(x, p, J);
+        model.hessian(x, p, 0, H);
+
+        // Errors must not allocate either
+        model.evaluate(x, y);
+        model.hessian(x, p, NUM_OUTPUT, H);
+    }
+    count_allocations = false;
+
+    EXPECT_EQ(num_allocations.load(), 0u);
+}
+
+TEST_F(RealtimeModelFixture, SparseKernels) {
+    Vector x = Vector::Random(NUM_INPUT);
+    Vector p = Vector::Random(NUM_PARAM);
+    Matrix J(NUM_OUTPUT, NUM_INPUT);
+    Matrix H(NUM_INPUT, NUM_INPUT);
+    Matrix J_expected = compiled_model_ptr_->jacobian(x, p);
+    Matrix H_expected = compiled_model_ptr_->hessian(x, p, 0);
+
+    // Models with a symmetric Hessian only have the sparse Hessian kernel
+    CompileOptions options;
+    options.symmetric_hessian = true;
+    CompiledModel<Scalar> symmetric_model =
+        ParameterizedTestModel<Scalar>().compile(
+            MODEL_NAME + "Symmetric", DIRECTORY_PATH, options);
+    RealtimeModel<Scalar> model(symmetric_model);
+    EXPECT_EQ(model.hessian(x, p, 0, H), Status::Success);
+    EXPECT_TRUE(H.isApprox(H_expected));
+
+    num_allocations = 0;
+    count_allocations = true;
+    model.hessian(x, p, 0, H);
+    count_allocations = false;
+    EXPECT_EQ(num_allocations.load(), 0u);
+
+    // Multithreaded models only have the sparse Jacobian and Hessian
+    // kernels. Their generated code allocates when handing work to its
+    // threads, so only the results are checked.
+    options.multithreading = Multithreading::ThreadPool;
+    CompiledModel<Scalar> multithreaded_model =
+        ParameterizedTestModel<Scalar>().compile(
+            MODEL_NAME + "Multithreaded", DIRECTORY_PATH, options);
+    RealtimeModel<Scalar> multithreaded(multithreaded_model);
+    EXPECT_EQ(multithreaded.jacobian(x, p, J), Status::Success);
+    EXPECT_EQ(multithreaded.hessian(x, p, 0, H), Status::Success);
+    EXPECT_TRUE(J.isApprox(J_expected));
+    EXPECT_TRUE(H.isApprox(H_expected));
+}
+
+TEST_F(RealtimeModelFixture, ReportsErrors) {
+    RealtimeModel<Scalar> model(*compiled_model_ptr_);
+
+    Vector x = Vector::Ones(NUM_INPUT);
+    Vector p = Vector::Ones(NUM_PARAM);
+    Vector y(NUM_OUTPUT);
+    Matrix J(NUM_OUTPUT, NUM_INPUT);
+    Matrix H(NUM_INPUT, NUM_INPUT);
+
+    // Missing parameters
+    EXPECT_EQ(model.evaluate(x, y), Status::InputSizeMismatch);
+    EXPECT_EQ(model.jacobian(x, J), Status::InputSizeMismatch);
+
+    // Wrong output buffer sizes
+    Vector y_wrong(NUM_OUTPUT + 1);
+    Matrix J_wrong(NUM_OUTPUT, NUM_INPUT + NUM_PARAM);
+    Matrix H_wrong(NUM_INPUT + 1, NUM_INPUT);
+    EXPECT_EQ(model.evaluate(x, p, y_wrong), Status::OutputSizeMismatch);
+    EXPECT_EQ(model.jacobian(x, p, J_wrong), Status::OutputSizeMismatch);
+    EXPECT_EQ(model.hessian(x, p, 0, H_wrong), Status::OutputSizeMismatch);
+
+    // Output dimension out of range
+    EXPECT_EQ(model.hessian(x, p, NUM_OUTPUT, H),
+              Status::InvalidOutputDimension);
+}
+
+}  // namespace RealtimeModelTest
+}  // namespace CppADCodeGenEigenPy
@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+
+#include <Eigen/Eigen>
+#include <atomic>
+#include <boost/filesystem.hpp>
+#include <thread>
+
+#include <CppADCodeGenEigenPy/ADModel.h>
+#include <CppADCodeGenEigenPy/ReloadableModel.h>
+
+#include "testing/models/BasicTestModel.h"
+#include "testing/models/ParameterizedTestModel.h"
+
+namespace CppADCodeGenEigenPy {
+namespace ReloadableModelTest {
+
+using namespace BasicModelTest;
+
+// Same shape as the basic test model, but with a different scale, standing
+// in for a recompiled version of it
+template <typename Scalar>
+struct ScaledTestModel : public ADModel<Scalar> {
+    using typename ADModel<Scalar>::ADScalar;
+    using typename ADModel<Scalar>::ADVector;
+
+    ScaledTestModel(double scale) : scale_(scale) {}
+
+    ADVector input() const override { return ADVector::Ones(NUM_INPUT); }
+
+    ADVector function(const ADVector& input) const override {
+        return input * ADScalar(scale_);
+    }
+
+    double scale_;
+};
+
+class ReloadableModelFixture : public ::testing::Test {
+   protected:
+    using Vector = CompiledModel<Scalar>::Vector;
+
+    void SetUp() override {
+        boost::filesystem::create_directories(DIRECTORY_PATH);
+        BasicTestModel<Scalar>().compile(MODEL_NAME, DIRECTORY_PATH,
+                                         DerivativeOrder::First);
+    }
+
+    void TearDown() override { boost::filesystem::remove_all(DIRECTORY_PATH); }
+};
+
+TEST_F(ReloadableModelFixture, Reload) {
+    ReloadableModel<Scalar> model(MODEL_NAME, LIB_GENERIC_PATH);
+    Vector input = Vector::Random(NUM_INPUT);
+    EXPECT_TRUE(model.evaluate(input).isApprox(2 * input));
+
+    // Recompile the model to the same path and swap it in
+    ScaledTestModel<Scalar>(3).compile(MODEL_NAME, DIRECTORY_PATH,
+                                       DerivativeOrder::First);
+    model.reload();
+    model.wait();
+    EXPECT_FALSE(model.is_reloading());
+    EXPECT_EQ(model.get_version(), 1u);
+    EXPECT_TRUE(model.evaluate(input).isApprox(3 * input))
+        << "Reloaded model was not swapped in.";
+
+    // The copy the new version was loaded from has the compile report too
+    std::shared_ptr<const CompiledModel<Scalar>> current = model.get_model();
+    EXPECT_EQ(current->get_library_hash(), hash_file(LIB_REAL_PATH));
+    EXPECT_NO_THROW(current->get_compile_report());
+    current.reset();
+
+    // And once more, to check that the previous copy is replaced
+    ScaledTestModel<Scalar>(4).compile(MODEL_NAME, DIRECTORY_PATH,
+                                       DerivativeOrder::First);
+    model.reload();
+    model.wait();
+    EXPECT_EQ(model.get_version(), 2u);
+    EXPECT_TRUE(model.evaluate(input).isApprox(4 * input))
+        << "Reloaded model was not swapped in.";
+}
+
+TEST_F(ReloadableModelFixture, InvalidReload) {
+    ReloadableModel<Scalar> model(MODEL_NAME, LIB_GENERIC_PATH);
+    Vector input = Vector::Random(NUM_INPUT);
+
+    // A model of a different size is rejected
+    ParameterizedModelTest::ParameterizedTestModel<Scalar>().compile(
+        MODEL_NAME, DIRECTORY_PATH, DerivativeOrder::First);
+    model.reload();
+    EXPECT_THROW(model.wait(), std::runtime_error)
+        << "Reload with different sizes did not throw.";
+
+    // As is a nonexistent library
+    model.reload(DIRECTORY_PATH + "/nonexistent");
+    EXPECT_THROW(model.wait(), std::runtime_error)
+        << "Reload of nonexistent library did not throw.";
+
+    // The original version is still in use
+    EXPECT_EQ(model.get_version(), 0u);
+    EXPECT_TRUE(model.evaluate(input).isApprox(2 * input));
+}
+
+TEST_F(ReloadableModelFixture, ReloadWhileEvaluating) {
+    ReloadableModel<Scalar> model(MODEL_NAME, LIB_GENERIC_PATH);
+    ScaledTestModel<Scalar>(3).compile(MODEL_NAME, DIRECTORY_PATH,
+                                       DerivativeOrder::First);
+
+    // Every call uses either the old or the new version, never a mix
+    std::atomic<bool> done{false};
+    std::atomic<size_t> num_invalid{0};
+    std::thread caller([&]() {
+        Vector input = Vector::Ones(NUM_INPUT);
+        while (!done) {
+            Vector output = model.evaluate(input);
+            if (!output.isApprox(2 * input) && !output.isApprox(3 * input)) {
+                ++num_invalid;
+            }
+        }
+    });
+
+    model.reload();
+    model.wait();
+    done = true;
+    caller.join();
+
+    EXPECT_EQ(num_invalid.load(), 0u);
+    EXPECT_TRUE(model.evaluate(Vector::Ones(NUM_INPUT))
+                    .isApprox(3 * Vector::Ones(NUM_INPUT)));
+}
+
+}  // namespace ReloadableModelTest
+}  // namespace CppADCodeGenEigenPy
@@ -0,0 +1,165 @@
+#include <gtest/gtest.h>
+
+#include <Eigen/Eigen>
+#include <boost/filesystem.hpp>
+#include <cmath>
+
+#include <CppADCodeGenEigenPy/ADModel.h>
+#include <CppADCodeGenEigenPy/CompiledModel.h>
+#include <CppADCodeGenEigenPy/RolloutEngine.h>
+
+#include "testing/models/BasicTestModel.h"
+
+namespace CppADCodeGenEigenPy {
+namespace RolloutEngineTest {
+
+using Scalar = double;
+using Vector = CompiledModel<Scalar>::Vector;
+using Matrix = CompiledModel<Scalar>::Matrix;
+using Engine = RolloutEngine<Scalar>;
+
+const std::string DIRECTORY_PATH = BasicModelTest::DIRECTORY_PATH;
+
+// The basic model computes f(x) = 2x, so it is used as the dynamics
+// x' = 2x with a state of size 3 and no control input.
+const size_t STATE_SIZE = 3;
+const size_t NUM_ENVS = 5;
+const size_t NUM_STEPS = 10;
+const Scalar DT = 0.01;
+
+class RolloutEngineFixture : public ::testing::Test {
+   protected:
+    static void SetUpTestSuite() {
+        boost::filesystem::create_directories(DIRECTORY_PATH);
+        BasicModelTest::BasicTestModel<Scalar>().compile(
+            BasicModelTest::MODEL_NAME, DIRECTORY_PATH,
+            DerivativeOrder::First);
+        model_ptr_.reset(new CompiledModel<Scalar>(
+            BasicModelTest::MODEL_NAME, BasicModelTest::LIB_GENERIC_PATH));
+    }
+
+    static void TearDownTestSuite() {
+        // Delete the compiled shared objects.
+        boost::filesystem::remove_all(DIRECTORY_PATH);
+    }
+
+    // Check that each step of each trajectory multiplies the state by factor.
+    static void expect_growth(const Matrix& initial_states,
+                              const Matrix& trajectories, Scalar factor) {
+        for (size_t i = 0; i < NUM_ENVS; ++i) {
+            for (size_t k = 0; k < NUM_STEPS; ++k) {
+                Vector expected = std::pow(factor, k + 1) *
+                                  initial_states.row(i).transpose();
+                Vector actual =
+                    trajectories.row(i).segment(k * STATE_SIZE, STATE_SIZE);
+                EXPECT_TRUE(actual.isApprox(expected))
+                    << "State of environment " << i << " at step " << k
+                    << " is incorrect.";
+            }
+        }
+    }
+
+    static std::unique_ptr<CompiledModel<Scalar>> model_ptr_;
+};
+
+std::unique_ptr<CompiledModel<Scalar>> RolloutEngineFixture::model_ptr_ =
+    nullptr;
+
+TEST_F(RolloutEngineFixture, Euler) {
+    Engine engine(*model_ptr_, STATE_SIZE, 0, Integrator::Euler, 1);
+    EXPECT_EQ(engine.get_parameter_size(), 0u);
+
+    Matrix initial_states = Matrix::Random(NUM_ENVS, STATE_SIZE);
+    Matrix controls(NUM_ENVS, 0);
+    Matrix trajectories(NUM_ENVS, NUM_STEPS * STATE_SIZE);
+    engine.rollout(initial_states, controls, DT, trajectories);
+
+    expect_growth(initial_states, trajectories, 1 + 2 * DT);
+}
+
+TEST_F(RolloutEngineFixture, RK4) {
+    Engine engine(*model_ptr_, STATE_SIZE, 0, Integrator::RK4, 1);
+
+    Matrix initial_states = Matrix::Random(NUM_ENVS, STATE_SIZE);
+    Matrix controls(NUM_ENVS, 0);
+    Matrix trajectories(NUM_ENVS, NUM_STEPS * STATE_SIZE);
+    engine.rollout(initial_states, controls, DT, trajectories);
+
+    // RK4 matches the Taylor series of exp(h) up to fourth order for linear
+    // dynamics
+    const Scalar h = 2 * DT;
+    expect_growth(initial_states, trajectories,
+                  1 + h + h * h / 2 + h * h * h / 6 + h * h * h * h / 24);
+}
+
+TEST_F(RolloutEngineFixture, MultipleThreads) {
+    Engine engine(*model_ptr_, STATE_SIZE, 0, Integrator::Euler, 3);
+    EXPECT_EQ(engine.get_num_threads(), 3u);
+
+    Matrix initial_states = Matrix::Random(NUM_ENVS, STATE_SIZE);
+    Matrix controls(NUM_ENVS, 0);
+    Matrix trajectories(NUM_ENVS, NUM_STEPS * STATE_SIZE);
+    engine.rollout(initial_states, controls, DT, trajectories);
+
+    expect_growth(initial_states, trajectories, 1 + 2 * DT);
+}
+
+TEST_F(RolloutEngineFixture, CustomStep) {
+    // Treat the last input as a control: the model output is then
+    // (2x, 2u), of which only the state part is used
+    const size_t state_size = 2;
+    const size_t control_size = 1;
+    Engine engine(*model_ptr_, state_size, control_size,
+                  [](const Engine::Dynamics& dynamics,
+                     const Eigen::Ref<const Vector>& x,
+                     const Eigen::Ref<const Vector>& u, Scalar dt,
+                     Eigen::Ref<Vector> x_next) {
+                      Vector output(STATE_SIZE);
+                      dynamics(x, u, output);
+                      x_next = x + dt * output.head(x.size());
+                  });
+    EXPECT_EQ(engine.get_control_size(), control_size);
+
+    Matrix initial_states = Matrix::Random(NUM_ENVS, state_size);
+    Matrix controls = Matrix::Random(NUM_ENVS, NUM_STEPS * control_size);
+    Matrix trajectories(NUM_ENVS, NUM_STEPS * state_size);
+    engine.rollout(initial_states, controls, DT, trajectories);
+
+    for (size_t i = 0; i < NUM_ENVS; ++i) {
+        Vector expected = std::pow(1 + 2 * DT, NUM_STEPS) *
+                          initial_states.row(i).transpose();
+        Vector actual = trajectories.row(i).tail(state_size);
+        EXPECT_TRUE(actual.isApprox(expected))
+            << "Final state of environment " << i << " is incorrect.";
+    }
+}
+
+TEST_F(RolloutEngineFixture, InvalidShapes) {
+    // Built-in integrators need the output to be the state derivative
+    EXPECT_THROW(Engine(*model_ptr_, 2, 1, Integrator::Euler),
+                 std::runtime_error);
+    EXPECT_THROW(Engine(*model_ptr_, STATE_SIZE, 1, Integrator::Euler),
+                 std::runtime_error);
+
+    Engine engine(*model_ptr_, STATE_SIZE, 0, Integrator::Euler, 1);
+    Matrix controls(NUM_ENVS, 0);
+    Matrix trajectories(NUM_ENVS, NUM_STEPS * STATE_SIZE);
+
+    Matrix wrong_states = Matrix::Random(NUM_ENVS, STATE_SIZE + 1);
+    EXPECT_THROW(engine.rollout(wrong_states, controls, DT, trajectories),
+                 std::runtime_error);
+
+    Matrix initial_states = Matrix::Random(NUM_ENVS, STATE_SIZE);
+    Matrix wrong_controls(NUM_ENVS + 1, 0);
+    EXPECT_THROW(
+        engine.rollout(initial_states, wrong_controls, DT, trajectories),
+        std::runtime_error);
+
+    Matrix wrong_trajectories(NUM_ENVS, NUM_STEPS * STATE_SIZE + 1);
+    EXPECT_THROW(
+        engine.rollout(initial_states, controls, DT, wrong_trajectories),
+        std::runtime_error);
+}
+
+}  // namespace RolloutEngineTest
+}  // namespace CppADCodeGenEigenPy
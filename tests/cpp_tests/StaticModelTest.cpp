@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+
+#include <Eigen/Eigen>
+#include <boost/filesystem.hpp>
+
+#include <CppADCodeGenEigenPy/ADModel.h>
+#include <CppADCodeGenEigenPy/CompiledModel.h>
+#include <CppADCodeGenEigenPy/StaticModel.h>
+
+// Generated by cppadcg_add_model
+#include <StaticParameterizedTestModel.h>
+
+#include "testing/models/ParameterizedTestModel.h"
+
+namespace CppADCodeGenEigenPy {
+namespace StaticModelTest {
+
+using namespace ParameterizedModelTest;
+
+class StaticModelFixture : public ::testing::Test {
+   protected:
+    using Vector = CompiledModel<Scalar>::Vector;
+    using Matrix = CompiledModel<Scalar>::Matrix;
+
+    static void SetUpTestSuite() {
+        // Compile and load the same model dynamically for comparison
+        boost::filesystem::create_directories(DIRECTORY_PATH);
+        ParameterizedTestModel<Scalar>().compile(MODEL_NAME, DIRECTORY_PATH,
+                                                 DerivativeOrder::Second);
+        compiled_model_ptr_.reset(
+            new CompiledModel<Scalar>(MODEL_NAME, LIB_GENERIC_PATH));
+    }
+
+    static void TearDownTestSuite() {
+        // Delete the compiled shared object.
+        boost::filesystem::remove_all(DIRECTORY_PATH);
+    }
+
+    static std::unique_ptr<CompiledModel<Scalar>> compiled_model_ptr_;
+    StaticModel<StaticParameterizedTestModelKernels> static_model_;
+};
+
+std::unique_ptr<CompiledModel<Scalar>>
+    StaticModelFixture::compiled_model_ptr_ = nullptr;
+
+TEST_F(StaticModelFixture, Sizes) {
+    EXPECT_EQ(static_model_.get_input_size(),
+              compiled_model_ptr_->get_input_size());
+    EXPECT_EQ(static_model_.get_output_size(),
+              compiled_model_ptr_->get_output_size());
+}
+
+TEST_F(StaticModelFixture, MatchesCompiledModel) {
+    Vector x = Vector::Random(NUM_INPUT);
+    Vector p = Vector::Random(NUM_PARAM);
+
+    EXPECT_TRUE(static_model_.evaluate(x, p).isApprox(
+        compiled_model_ptr_->evaluate(x, p)));
+    EXPECT_TRUE(static_model_.jacobian(x, p).isApprox(
+        compiled_model_ptr_->jacobian(x, p)));
+    EXPECT_TRUE(static_model_.hessian(x, p, 0).isApprox(
+        compiled_model_ptr_->hessian(x, p, 0)));
+}
+
+TEST_F(StaticModelFixture, InputSizeMismatch) {
+    Vector x = Vector::Ones(NUM_INPUT);
+    EXPECT_THROW(static_model_.evaluate(x), std::runtime_error);
+    EXPECT_THROW(static_model_.hessian(x, x, NUM_OUTPUT), std::runtime_error);
+}
+
+}  // namespace StaticModelTest
+}  // namespace CppADCodeGenEigenPy
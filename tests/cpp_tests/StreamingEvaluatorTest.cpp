@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+
+#include <Eigen/Eigen>
+#include <boost/filesystem.hpp>
+
+#include <CppADCodeGenEigenPy/ADModel.h>
+#include <CppADCodeGenEigenPy/CompiledModel.h>
+#include <CppADCodeGenEigenPy/NpyArray.h>
+#include <CppADCodeGenEigenPy/StreamingEvaluator.h>
+
+#include "testing/models/ParameterizedTestModel.h"
+
+namespace CppADCodeGenEigenPy {
+namespace StreamingEvaluatorTest {
+
+using namespace ParameterizedModelTest;
+
+const std::string INPUT_PATH = DIRECTORY_PATH + "/inputs.npy";
+const std::string PARAMETERS_PATH = DIRECTORY_PATH + "/parameters.npy";
+const std::string SHARED_PARAMETERS_PATH =
+    DIRECTORY_PATH + "/shared_parameters.npy";
+const std::string OUTPUT_PATH = DIRECTORY_PATH + "/outputs.npy";
+const std::string JACOBIAN_PATH = DIRECTORY_PATH + "/jacobians.npy";
+
+const size_t NUM_ROWS = 100;
+
+class StreamingEvaluatorFixture : public ::testing::Test {
+   protected:
+    using Vector = CompiledModel<Scalar>::Vector;
+    using Matrix = CompiledModel<Scalar>::Matrix;
+
+    static void SetUpTestSuite() {
+        // Compile and load our model
+        boost::filesystem::create_directories(DIRECTORY_PATH);
+        ParameterizedTestModel<Scalar>().compile(MODEL_NAME, DIRECTORY_PATH,
+                                                 DerivativeOrder::First);
+        compiled_model_ptr_.reset(
+            new CompiledModel<Scalar>(MODEL_NAME, LIB_GENERIC_PATH));
+
+        // Write the dataset
+        NpyArray<Scalar> inputs(INPUT_PATH, {NUM_ROWS, NUM_INPUT});
+        NpyArray<Scalar> parameters(PARAMETERS_PATH, {NUM_ROWS, NUM_PARAM});
+        for (size_t i = 0; i < NUM_ROWS; ++i) {
+            for (size_t j = 0; j < NUM_INPUT; ++j) {
+                inputs.row(i)[j] = 0.01 * i + j;
+                parameters.row(i)[j] = 1 + 0.1 * j;
+            }
+        }
+    }
+
+    static void TearDownTestSuite() {
+        // Delete the compiled shared object and dataset.
+        boost::filesystem::remove_all(DIRECTORY_PATH);
+    }
+
+    static std::unique_ptr<CompiledModel<Scalar>> compiled_model_ptr_;
+};
+
+std::unique_ptr<CompiledModel<Scalar>>
+    StreamingEvaluatorFixture::compiled_model_ptr_ = nullptr;
+
+TEST_F(StreamingEvaluatorFixture, MatchesEvaluate) {
+    // Small chunks so that the dataset spans many of them
+    StreamingEvaluator<Scalar> evaluator(*compiled_model_ptr_, 3, 7);
+    evaluator.evaluate(INPUT_PATH, OUTPUT_PATH, JACOBIAN_PATH,
+                       PARAMETERS_PATH);
+
+    NpyArray<Scalar> inputs(INPUT_PATH);
+    NpyArray<Scalar> parameters(PARAMETERS_PATH);
+    NpyArray<Scalar> outputs(OUTPUT_PATH);
+    NpyArray<Scalar> jacobians(JACOBIAN_PATH);
+
+    ASSERT_EQ(outputs.get_shape(), std::vector<size_t>({NUM_ROWS, NUM_OUTPUT}));
+    ASSERT_EQ(jacobians.get_shape(),
+              std::vector<size_t>({NUM_ROWS, NUM_OUTPUT, NUM_INPUT}));
+
+    for (size_t i = 0; i < NUM_ROWS; ++i) {
+        Eigen::Map<const Vector> x(inputs.row(i), NUM_INPUT);
+        Eigen::Map<const Vector> p(parameters.row(i), NUM_PARAM);
+        Eigen::Map<const Vector> y(outputs.row(i), NUM_OUTPUT);
+        Eigen::Map<const Matrix> J(jacobians.row(i), NUM_OUTPUT, NUM_INPUT);
+
+        EXPECT_TRUE(y.isApprox(compiled_model_ptr_->evaluate(x, p)))
+            << "Output of row " << i << " is incorrect.";
+        EXPECT_TRUE(J.isApprox(compiled_model_ptr_->jacobian(x, p)))
+            << "Jacobian of row " << i << " is incorrect.";
+    }
+}
+
+TEST_F(StreamingEvaluatorFixture, SharedParameters) {
+    // One-dimensional parameter file is shared by all rows
+    {
+        NpyArray<Scalar> shared_parameters(SHARED_PARAMETERS_PATH,
+                                           std::vector<size_t>{NUM_PARAM});
+        for (size_t j = 0; j < NUM_PARAM; ++j) {
+            shared_parameters.row(j)[0] = 2;
+        }
+    }
+
+    StreamingEvaluator<Scalar> evaluator(*compiled_model_ptr_, 2);
+    evaluator.evaluate(INPUT_PATH, OUTPUT_PATH, "", SHARED_PARAMETERS_PATH);
+
+    NpyArray<Scalar> inputs(INPUT_PATH);
+    NpyArray<Scalar> outputs(OUTPUT_PATH);
+    Vector p = 2 * Vector::Ones(NUM_PARAM);
+    for (size_t i = 0; i < NUM_ROWS; ++i) {
+        Eigen::Map<const Vector> x(inputs.row(i), NUM_INPUT);
+        Eigen::Map<const Vector> y(outputs.row(i), NUM_OUTPUT);
+        EXPECT_TRUE(y.isApprox(compiled_model_ptr_->evaluate(x, p)))
+            << "Output of row " << i << " is incorrect.";
+    }
+}
+
+TEST_F(StreamingEvaluatorFixture, ThrowsOnWrongSize) {
+    // Missing parameters
+    StreamingEvaluator<Scalar> evaluator(*compiled_model_ptr_, 2);
+    EXPECT_THROW(evaluator.evaluate(INPUT_PATH, OUTPUT_PATH),
+                 std::runtime_error)
+        << "Missing parameters did not throw.";
+    EXPECT_THROW(evaluator.evaluate(DIRECTORY_PATH + "/nonexistent.npy",
+                                    OUTPUT_PATH, "", PARAMETERS_PATH),
+                 std::runtime_error)
+        << "Nonexistent input file did not throw.";
+}
+
+}  // namespace StreamingEvaluatorTest
+}  // namespace CppADCodeGenEigenPy
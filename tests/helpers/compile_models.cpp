@@ -2,6 +2,7 @@
 #include <string>
 
 #include "testing/models/BasicTestModel.h"
+#include "testing/models/BlockTestModel.h"
 #include "testing/models/ParameterizedTestModel.h"
 #include "testing/models/MathFunctionsTestModel.h"
 
@@ -23,8 +24,17 @@ int main(int argc, char** argv) {
         ParameterizedModelTest::MODEL_NAME, directory_path,
         DerivativeOrder::Second,
         /* verbose = */ true);
+    // Same model with only the lower triangle of the Hessian generated
+    CompileOptions symmetric_options;
+    symmetric_options.verbose = true;
+    symmetric_options.symmetric_hessian = true;
+    ParameterizedModelTest::ParameterizedTestModel<double>().compile(
+        "SymmetricTestModel", directory_path, symmetric_options);
     MathFunctionsModelTest::MathFunctionsTestModel<double>().compile(
         MathFunctionsModelTest::MODEL_NAME, directory_path,
         DerivativeOrder::Second,
         /* verbose = */ true);
+    BlockModelTest::BlockTestModel<double>().compile(
+        BlockModelTest::MODEL_NAME, directory_path, DerivativeOrder::First,
+        /* verbose = */ true);
 }
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <Eigen/Eigen>
+
+#include <CppADCodeGenEigenPy/ADModel.h>
+#include <CppADCodeGenEigenPy/Util.h>
+
+#include "testing/Defs.h"
+
+namespace CppADCodeGenEigenPy {
+namespace BlockModelTest {
+
+using Scalar = double;
+
+const std::string MODEL_NAME = "BlockTestModel";
+const std::string DIRECTORY_PATH = "/tmp/CppADCodeGenEigenPy";
+const std::string LIB_GENERIC_PATH =
+    get_library_generic_path(MODEL_NAME, DIRECTORY_PATH);
+const std::string LIB_REAL_PATH =
+    get_library_real_path(MODEL_NAME, DIRECTORY_PATH);
+
+const int NUM_INPUT = 4;
+const int NUM_OUTPUT = 3;
+const int NUM_PARAM = 1;
+
+// Products and squares of the inputs, so that each Jacobian block is
+// distinct.
+template <typename Scalar>
+static Vector<Scalar> evaluate(const Vector<Scalar>& input,
+                               const Vector<Scalar>& parameters) {
+    Vector<Scalar> output(NUM_OUTPUT);
+    output << parameters(0) * input(0) * input(2), input(1) * input(1),
+        input(3) + input(0);
+    return output;
+}
+
+// Model with the input split into segments "a" and "b" and the output split
+// into segments "first" and "rest". Only the ("first", "a") and ("rest", "b")
+// Jacobian blocks are generated.
+template <typename Scalar>
+struct BlockTestModel : public ADModel<Scalar> {
+    using typename ADModel<Scalar>::ADScalar;
+    using typename ADModel<Scalar>::ADVector;
+    using typename ADModel<Scalar>::JacobianBlock;
+
+    // Generate the input to the function
+    ADVector input() const override { return ADVector::Ones(NUM_INPUT); }
+
+    ADVector parameters() const override { return ADVector::Ones(NUM_PARAM); }
+
+    std::vector<Segment> input_segments() const override {
+        return {{"a", 0, 2}, {"b", 2, 2}};
+    }
+
+    std::vector<Segment> output_segments() const override {
+        return {{"first", 0, 1}, {"rest", 1, 2}};
+    }
+
+    std::vector<JacobianBlock> jacobian_blocks() const override {
+        return {{"first", "a"}, {"rest", "b"}};
+    }
+
+    // Evaluate the function
+    ADVector function(const ADVector& input,
+                      const ADVector& parameters) const override {
+        return evaluate<ADScalar>(input, parameters);
+    }
+};
+
+}  // namespace BlockModelTest
+}  // namespace CppADCodeGenEigenPy
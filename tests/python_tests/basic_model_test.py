@@ -1,7 +1,7 @@
 import pytest
 import numpy as np
 
-from CppADCodeGenEigenPy import CompiledModel
+from CppADCodeGenEigenPy import CompiledModel, LoadOptions
 
 MODEL_NAME = "BasicTestModel"
 MODEL_LIB_NAME = "lib" + MODEL_NAME
@@ -81,3 +81,23 @@ def test_model_hessian(model):
     # invalid output dimension
     with pytest.raises(RuntimeError):
         model.hessian(x, 3)
+
+
+def test_model_compile_report(model):
+    report = model.compile_report
+    assert report.model_name == MODEL_NAME
+    assert report.total_time > 0
+    assert report.num_optimized_operations <= report.num_operations
+    assert report.library_size > 0
+    assert len(report.source_sizes) > 0
+
+
+def test_model_load_options(model):
+    options = LoadOptions()
+    options.prefault = True
+    options.warmup = True
+    warm_model = CompiledModel(MODEL_NAME, model.library_path, options)
+
+    kernels = [latency.kernel for latency in warm_model.warmup_latencies]
+    assert kernels == ["evaluate", "jacobian", "hessian"]
+    assert np.allclose(warm_model.evaluate(np.ones(NUM_INPUT)), 2)
@@ -0,0 +1,45 @@
+import pytest
+import numpy as np
+
+from CppADCodeGenEigenPy import CompiledModel
+
+MODEL_NAME = "BlockTestModel"
+MODEL_LIB_NAME = "lib" + MODEL_NAME
+
+NUM_INPUT = 4
+NUM_PARAM = 1
+NUM_OUTPUT = 3
+
+
+@pytest.fixture
+def model(pytestconfig):
+    lib_path = str(
+        pytestconfig.rootdir / pytestconfig.getoption("builddir") / MODEL_LIB_NAME
+    )
+    return CompiledModel(MODEL_NAME, lib_path)
+
+
+def test_model_jacobian_blocks(model):
+    assert model.jacobian_blocks == [("first", "a"), ("rest", "b")]
+
+
+def test_model_jacobian_block(model):
+    x = np.array([1.0, 2, 3, 4])
+    p = 2 * np.ones(NUM_PARAM)
+
+    J = model.jacobian(x, p)
+    J_first_a = model.jacobian_block("first", "a", x, p)
+    J_rest_b = model.jacobian_block("rest", "b", x, p)
+
+    assert J_first_a.shape == (1, 2)
+    assert J_rest_b.shape == (2, 2)
+    assert np.allclose(J_first_a, J[:1, :2])
+    assert np.allclose(J_rest_b, J[1:, 2:])
+
+    # block that was not generated
+    with pytest.raises(RuntimeError):
+        model.jacobian_block("first", "b", x, p)
+
+    # missing parameters
+    with pytest.raises(RuntimeError):
+        model.jacobian_block("first", "a", x)
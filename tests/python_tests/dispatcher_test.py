@@ -0,0 +1,67 @@
+import threading
+
+import pytest
+import numpy as np
+
+from CppADCodeGenEigenPy import BatchDispatcher, CompiledModel, DispatcherOptions
+
+MODEL_NAME = "BasicTestModel"
+NUM_INPUT = 3
+
+
+@pytest.fixture
+def model(pytestconfig):
+    lib_path = str(
+        pytestconfig.rootdir / pytestconfig.getoption("builddir") / ("lib" + MODEL_NAME)
+    )
+    return CompiledModel(MODEL_NAME, lib_path)
+
+
+def test_full_batch(model):
+    options = DispatcherOptions()
+    options.max_batch_size = 4
+    options.max_wait_time = 10.0
+    dispatcher = BatchDispatcher(model, options)
+
+    xs = np.random.random((options.max_batch_size, NUM_INPUT))
+    futures = [dispatcher.evaluate(x) for x in xs]
+    for x, future in zip(xs, futures):
+        assert np.allclose(future.result(), 2 * x)
+        assert future.done()
+
+    statistics = dispatcher.statistics
+    assert statistics.num_requests == options.max_batch_size
+    assert statistics.num_batches == 1
+    assert statistics.max_batch_size == options.max_batch_size
+
+
+def test_jacobian(model):
+    dispatcher = BatchDispatcher(model)
+    x = np.random.random(NUM_INPUT)
+    assert np.allclose(dispatcher.jacobian(x).result(), model.jacobian(x))
+
+
+def test_threads(model):
+    options = DispatcherOptions()
+    options.num_threads = 2
+    dispatcher = BatchDispatcher(model, options)
+    results = {}
+
+    def run(i):
+        xs = np.random.random((100, NUM_INPUT))
+        futures = [dispatcher.evaluate(x) for x in xs]
+        results[i] = all(np.allclose(f.result(), 2 * x) for x, f in zip(xs, futures))
+
+    threads = [threading.Thread(target=run, args=(i,)) for i in range(4)]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    assert all(results.values())
+    assert dispatcher.statistics.num_requests == 400
+
+
+def test_invalid_input(model):
+    dispatcher = BatchDispatcher(model)
+    with pytest.raises(RuntimeError):
+        dispatcher.evaluate(np.ones(NUM_INPUT + 1))
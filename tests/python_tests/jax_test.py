@@ -0,0 +1,57 @@
+import pytest
+import numpy as np
+
+from CppADCodeGenEigenPy import CompiledModel
+
+jax = pytest.importorskip("jax")
+jax.config.update("jax_enable_x64", True)
+
+from CppADCodeGenEigenPy.jax import jax_function
+
+MODEL_NAME = "ParameterizedTestModel"
+MODEL_LIB_NAME = "lib" + MODEL_NAME
+
+NUM_INPUT = 3
+NUM_PARAM = NUM_INPUT
+NUM_BATCH = 10
+
+
+@pytest.fixture
+def model(pytestconfig):
+    lib_path = str(
+        pytestconfig.rootdir / pytestconfig.getoption("builddir") / MODEL_LIB_NAME
+    )
+    return CompiledModel(MODEL_NAME, lib_path)
+
+
+def test_model_batch(model):
+    xps = np.random.random((NUM_BATCH, NUM_INPUT + NUM_PARAM))
+    ys = model.evaluate_batch(xps)
+    Js = model.jacobian_batch(xps)
+
+    assert ys.shape == (NUM_BATCH, 1)
+    assert Js.shape == (NUM_BATCH, 1, NUM_INPUT + NUM_PARAM)
+    for xp, y, J in zip(xps, ys, Js):
+        assert np.allclose(y, model.evaluate(xp))
+        assert np.allclose(J, model.jacobian(xp))
+
+
+def test_jax_function(model):
+    f = jax_function(model)
+    xp = np.random.random(NUM_INPUT + NUM_PARAM)
+
+    assert np.allclose(jax.jit(f)(xp), model.evaluate(xp))
+    assert np.allclose(jax.jacfwd(f)(xp), model.jacobian(xp))
+    assert np.allclose(jax.jacrev(f)(xp), model.jacobian(xp))
+
+    # the gradient of a scalar function of the output, within jit
+    g = jax.jit(jax.grad(lambda xp: 2 * f(xp)[0]))
+    assert np.allclose(g(xp), 2 * model.jacobian(xp)[0, :])
+
+
+def test_jax_function_vmap(model):
+    f = jax_function(model)
+    xps = np.random.random((NUM_BATCH, NUM_INPUT + NUM_PARAM))
+
+    assert np.allclose(jax.jit(jax.vmap(f))(xps), model.evaluate_batch(xps))
+    assert np.allclose(jax.vmap(jax.jacfwd(f))(xps), model.jacobian_batch(xps))
@@ -0,0 +1,64 @@
+import pytest
+import numpy as np
+
+from CppADCodeGenEigenPy import CompiledModel, ModelGroup
+
+BASIC_MODEL_NAME = "BasicTestModel"
+PARAM_MODEL_NAME = "ParameterizedTestModel"
+
+GROUP_INPUT_SIZE = 6
+
+
+def load_model(pytestconfig, name):
+    lib_path = str(
+        pytestconfig.rootdir / pytestconfig.getoption("builddir") / ("lib" + name)
+    )
+    return CompiledModel(name, lib_path)
+
+
+@pytest.fixture
+def basic_model(pytestconfig):
+    return load_model(pytestconfig, BASIC_MODEL_NAME)
+
+
+@pytest.fixture
+def param_model(pytestconfig):
+    return load_model(pytestconfig, PARAM_MODEL_NAME)
+
+
+def test_model_group_evaluate(basic_model, param_model):
+    group = ModelGroup(GROUP_INPUT_SIZE, num_threads=2)
+    group.add_model("basic", basic_model, [0, 1, 2])
+    group.add_model(
+        "param", param_model, list(range(6)), jacobian=True, hessian_outputs=[0]
+    )
+    assert group.num_models == 2
+
+    xp = np.arange(1.0, GROUP_INPUT_SIZE + 1)
+    results = group.evaluate(xp)
+
+    assert np.allclose(results["basic"].value, basic_model.evaluate(xp[:3]))
+    assert np.allclose(results["param"].value, param_model.evaluate(xp))
+    assert np.allclose(results["param"].jacobian, param_model.jacobian(xp))
+    assert len(results["param"].hessians) == 1
+    assert np.allclose(results["param"].hessians[0], param_model.hessian(xp, 0))
+
+    # incorrect input size should raise an error
+    with pytest.raises(RuntimeError):
+        group.evaluate(np.ones(GROUP_INPUT_SIZE + 1))
+
+
+def test_model_group_invalid_indices(basic_model):
+    group = ModelGroup(GROUP_INPUT_SIZE)
+    with pytest.raises(RuntimeError):
+        group.add_model("basic", basic_model, [0, 1, GROUP_INPUT_SIZE])
+
+
+def test_model_group_duplicate_name(basic_model):
+    group = ModelGroup(GROUP_INPUT_SIZE)
+    group.add_model("basic", basic_model, [0, 1, 2])
+
+    # results are returned by name, so names must be unique
+    with pytest.raises(RuntimeError):
+        group.add_model("basic", basic_model, [3, 4, 5])
+    assert group.num_models == 1
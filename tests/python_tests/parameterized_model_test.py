@@ -6,6 +6,7 @@ from CppADCodeGenEigenPy import CompiledModel
 BUILD_DIR_NAME = "build"
 MODEL_NAME = "ParameterizedTestModel"
 MODEL_LIB_NAME = "lib" + MODEL_NAME
+SYMMETRIC_MODEL_NAME = "SymmetricTestModel"
 
 NUM_INPUT = 3
 NUM_PARAM = NUM_INPUT
@@ -20,6 +21,16 @@ def model(pytestconfig):
     return CompiledModel(MODEL_NAME, lib_path)
 
 
+@pytest.fixture
+def symmetric_model(pytestconfig):
+    lib_path = str(
+        pytestconfig.rootdir
+        / pytestconfig.getoption("builddir")
+        / ("lib" + SYMMETRIC_MODEL_NAME)
+    )
+    return CompiledModel(SYMMETRIC_MODEL_NAME, lib_path)
+
+
 def test_model_evaluate(model):
     x = 2 * np.ones(NUM_INPUT)
     p = np.ones(NUM_INPUT)
@@ -55,6 +66,18 @@ def test_model_jacobian(model):
         model.jacobian(x, np.ones(1))
 
 
+def test_model_gradient(model):
+    x = 2 * np.ones(NUM_INPUT)
+    p = np.arange(NUM_PARAM, dtype=float)
+
+    g_actual = model.gradient(x, p)
+    assert g_actual.shape == (NUM_INPUT,)
+    assert np.allclose(g_actual, p * x)
+
+    with pytest.raises(RuntimeError):
+        model.gradient(x, np.ones(1))
+
+
 def test_model_hessian(model):
     x = 2 * np.ones(NUM_INPUT)
     p = np.ones(NUM_PARAM)
@@ -74,3 +97,56 @@ def test_model_hessian(model):
     # invalid output dimension
     with pytest.raises(RuntimeError):
         model.hessian(x, 3)
+
+
+def test_model_hessian_packed(model, symmetric_model):
+    x = np.random.random(NUM_INPUT)
+    p = np.random.random(NUM_PARAM)
+    xp = np.concatenate((x, p))
+
+    # the Hessian with respect to input and parameters is not diagonal
+    n = NUM_INPUT + NUM_PARAM
+    H_expected = model.hessian(xp, 0)
+    packed_expected = H_expected[np.tril_indices(n)]
+    assert np.allclose(model.hessian_packed(xp, 0), packed_expected)
+
+    # the symmetric model only computes the lower triangle, which is
+    # mirrored by hessian
+    assert np.allclose(symmetric_model.hessian(xp, 0), H_expected)
+    packed = symmetric_model.hessian_packed(xp, 0)
+    assert np.allclose(packed, packed_expected)
+
+    H = np.zeros((n, n))
+    H[np.tril_indices(n)] = packed
+    assert np.allclose(np.tril(H), np.tril(H_expected))
+
+    packed_x = symmetric_model.hessian_packed(x, p, 0)
+    assert packed_x.shape == (NUM_INPUT * (NUM_INPUT + 1) // 2,)
+    assert np.allclose(packed_x, packed_expected[: packed_x.shape[0]])
+
+
+def test_model_reduce(model):
+    xs = np.random.random((10, NUM_INPUT))
+    p = np.random.random(NUM_PARAM)
+    ys = 0.5 * (p * xs * xs).sum(axis=1)
+
+    # with respect to the input, the Jacobian of each sample is p * x
+    sums = model.reduce(xs, p, gauss_newton=True)
+    Js = p * xs
+    assert np.allclose(sums.output_sum, [ys.sum()])
+    assert np.isclose(sums.squared_output_sum, (ys * ys).sum())
+    assert np.allclose(sums.gradient, Js.T @ ys)
+    assert np.allclose(sums.gauss_newton, Js.T @ Js)
+
+    # with respect to the parameters, it is 0.5 * x * x
+    weights = np.random.random((10, NUM_OUTPUT))
+    sums = model.reduce(
+        xs, p, weights=weights, with_respect_to_parameters=True, num_threads=2
+    )
+    Js = 0.5 * xs * xs
+    assert np.allclose(sums.gradient, Js.T @ weights[:, 0])
+    assert sums.gauss_newton.size == 0
+
+    # the number of rows must match
+    with pytest.raises(RuntimeError):
+        model.reduce(xs, np.ones((3, NUM_PARAM)))
@@ -0,0 +1,66 @@
+import pickle
+import shutil
+
+import pytest
+import numpy as np
+
+from CppADCodeGenEigenPy import CompiledModel, SharedArray, evaluate_in_processes
+
+MODEL_NAME = "ParameterizedTestModel"
+MODEL_LIB_NAME = "lib" + MODEL_NAME
+
+NUM_INPUT = 3
+NUM_PARAM = 3
+NUM_BATCH = 50
+
+
+@pytest.fixture
+def model(pytestconfig):
+    lib_path = str(
+        pytestconfig.rootdir / pytestconfig.getoption("builddir") / MODEL_LIB_NAME
+    )
+    return CompiledModel(MODEL_NAME, lib_path)
+
+
+def test_model_pickle(model):
+    loaded = pickle.loads(pickle.dumps(model))
+    assert loaded.library_path == model.library_path
+    assert loaded.library_hash == model.library_hash
+
+    x = np.ones(NUM_INPUT)
+    p = np.arange(NUM_PARAM, dtype=float)
+    assert np.allclose(loaded.evaluate(x, p), model.evaluate(x, p))
+
+
+def test_model_pickle_changed_library(model, tmp_path):
+    # copy the library so it can be modified after pickling
+    lib_path = str(tmp_path / MODEL_LIB_NAME)
+    shutil.copy(model.library_path + ".so", lib_path + ".so")
+    data = pickle.dumps(CompiledModel(MODEL_NAME, lib_path))
+
+    with open(lib_path + ".so", "ab") as f:
+        f.write(b"modified")
+    with pytest.raises(RuntimeError):
+        pickle.loads(data)
+
+
+def test_shared_array():
+    a = np.random.random((NUM_BATCH, NUM_INPUT))
+    with SharedArray(a) as shared:
+        loaded = pickle.loads(pickle.dumps(shared))
+        assert np.array_equal(loaded.array, a)
+        assert not loaded.array.flags.writeable
+        loaded.close()
+
+
+def test_evaluate_in_processes(model):
+    xs = np.random.random((NUM_BATCH, NUM_INPUT))
+    p = np.arange(NUM_PARAM, dtype=float)
+
+    ys = evaluate_in_processes(model, xs, parameters=p, num_processes=2)
+    assert np.allclose(ys, [model.evaluate(x, p) for x in xs])
+
+    Js = evaluate_in_processes(
+        model, xs, parameters=p, jacobian=True, num_processes=2
+    )
+    assert np.allclose(Js, [model.jacobian(x, p) for x in xs])
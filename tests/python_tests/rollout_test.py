@@ -0,0 +1,88 @@
+import pytest
+import numpy as np
+
+from CppADCodeGenEigenPy import CompiledModel, Integrator, RolloutEngine
+
+# The basic model computes f(x) = 2x, which is used as the dynamics x' = 2x
+MODEL_NAME = "BasicTestModel"
+STATE_SIZE = 3
+NUM_ENVS = 4
+NUM_STEPS = 5
+DT = 0.01
+
+
+@pytest.fixture
+def model(pytestconfig):
+    lib_path = str(
+        pytestconfig.rootdir / pytestconfig.getoption("builddir") / ("lib" + MODEL_NAME)
+    )
+    return CompiledModel(MODEL_NAME, lib_path)
+
+
+def expected_trajectories(x0s, factor):
+    powers = factor ** np.arange(1, NUM_STEPS + 1)
+    return powers[None, :, None] * x0s[:, None, :]
+
+
+def test_euler(model):
+    engine = RolloutEngine(model, STATE_SIZE, 0, Integrator.Euler)
+    assert engine.state_size == STATE_SIZE
+    assert engine.control_size == 0
+    assert engine.parameter_size == 0
+
+    x0s = np.random.random((NUM_ENVS, STATE_SIZE))
+    us = np.zeros((NUM_ENVS, NUM_STEPS, 0))
+    xs = engine.rollout(x0s, us, DT)
+    assert xs.shape == (NUM_ENVS, NUM_STEPS, STATE_SIZE)
+    assert np.allclose(xs, expected_trajectories(x0s, 1 + 2 * DT))
+
+
+def test_rk4(model):
+    engine = RolloutEngine(model, STATE_SIZE, 0, num_threads=2)
+    assert engine.num_threads == 2
+
+    x0s = np.random.random((NUM_ENVS, STATE_SIZE))
+    us = np.zeros((NUM_ENVS, NUM_STEPS, 0))
+    xs = engine.rollout(x0s, us, DT)
+
+    h = 2 * DT
+    factor = 1 + h + h ** 2 / 2 + h ** 3 / 6 + h ** 4 / 24
+    assert np.allclose(xs, expected_trajectories(x0s, factor))
+
+
+def test_out(model):
+    engine = RolloutEngine(model, STATE_SIZE, 0, Integrator.Euler)
+    x0s = np.random.random((NUM_ENVS, STATE_SIZE))
+    us = np.zeros((NUM_ENVS, NUM_STEPS, 0))
+
+    out = np.zeros((NUM_ENVS, NUM_STEPS, STATE_SIZE))
+    xs = engine.rollout(x0s, us, DT, out=out)
+    assert np.shares_memory(xs, out)
+    assert np.allclose(out, expected_trajectories(x0s, 1 + 2 * DT))
+
+    with pytest.raises(RuntimeError):
+        engine.rollout(x0s, us, DT, out=np.zeros((NUM_ENVS, NUM_STEPS)))
+
+    # arrays that would have to be copied cannot be written into
+    with pytest.raises(RuntimeError):
+        engine.rollout(x0s, us, DT, out=out.astype(np.float32))
+    with pytest.raises(RuntimeError):
+        engine.rollout(x0s, us, DT, out=np.zeros((NUM_ENVS, NUM_STEPS, 6))[..., ::2])
+
+
+def test_invalid(model):
+    with pytest.raises(RuntimeError):
+        RolloutEngine(model, 2, 1)
+
+    engine = RolloutEngine(model, STATE_SIZE, 0)
+    us = np.zeros((NUM_ENVS, NUM_STEPS, 0))
+    with pytest.raises(RuntimeError):
+        engine.rollout(np.zeros((NUM_ENVS, STATE_SIZE + 1)), us, DT)
+    with pytest.raises(RuntimeError):
+        engine.rollout(np.zeros((NUM_ENVS, STATE_SIZE)), us[0], DT)
+
+    # empty parameters are ignored by a model without them
+    xs = engine.rollout(
+        np.zeros((NUM_ENVS, STATE_SIZE)), us, DT, parameters=np.zeros((0, 2))
+    )
+    assert xs.shape == (NUM_ENVS, NUM_STEPS, STATE_SIZE)
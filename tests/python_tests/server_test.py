@@ -0,0 +1,93 @@
+import multiprocessing
+import os
+
+import pytest
+import numpy as np
+
+from CppADCodeGenEigenPy import (
+    CompiledModel,
+    EvaluationClient,
+    EvaluationServer,
+    Kernel,
+    ServerOptions,
+)
+
+BASIC_MODEL_NAME = "BasicTestModel"
+PARAM_MODEL_NAME = "ParameterizedTestModel"
+
+
+def load_model(pytestconfig, name):
+    lib_path = str(
+        pytestconfig.rootdir / pytestconfig.getoption("builddir") / ("lib" + name)
+    )
+    return CompiledModel(name, lib_path)
+
+
+@pytest.fixture
+def server(pytestconfig):
+    options = ServerOptions()
+    options.num_threads = 2
+    options.ring_capacity = 4
+    models = [
+        load_model(pytestconfig, BASIC_MODEL_NAME),
+        load_model(pytestconfig, PARAM_MODEL_NAME),
+    ]
+    server = EvaluationServer("python_test_%d" % os.getpid(), models, options)
+    yield server
+    server.stop()
+
+
+def client_evaluate(server_name, inputs):
+    client = EvaluationClient(server_name)
+    return [client.evaluate(BASIC_MODEL_NAME, x) for x in inputs]
+
+
+def test_server_evaluate(server, pytestconfig):
+    basic_model = load_model(pytestconfig, BASIC_MODEL_NAME)
+    param_model = load_model(pytestconfig, PARAM_MODEL_NAME)
+    client = EvaluationClient(server.name)
+    assert client.model_names == [BASIC_MODEL_NAME, PARAM_MODEL_NAME]
+
+    x = np.array([1.0, 2.0, 3.0])
+    p = np.array([0.5, 1.0, 1.5])
+    assert np.allclose(client.evaluate(BASIC_MODEL_NAME, x), basic_model.evaluate(x))
+    assert np.allclose(client.jacobian(BASIC_MODEL_NAME, x), basic_model.jacobian(x))
+
+    # models with parameters take the input and parameters concatenated
+    xp = np.concatenate((x, p))
+    index = client.model_index(PARAM_MODEL_NAME)
+    assert np.allclose(client.evaluate(index, xp), param_model.evaluate(x, p))
+
+    # pipelined requests
+    tickets = [
+        client.submit(BASIC_MODEL_NAME, Kernel.Evaluate, i * x) for i in range(4)
+    ]
+    with pytest.raises(RuntimeError):
+        client.submit(BASIC_MODEL_NAME, Kernel.Evaluate, x)
+    for i, ticket in enumerate(tickets):
+        assert np.allclose(client.collect(ticket), basic_model.evaluate(i * x))
+
+    with pytest.raises(RuntimeError):
+        client.evaluate("NotAModel", x)
+    with pytest.raises(RuntimeError):
+        client.evaluate(BASIC_MODEL_NAME, np.ones(2))
+
+
+def test_server_multiple_processes(server):
+    inputs = [np.random.random(3) for _ in range(100)]
+    ctx = multiprocessing.get_context("spawn")
+    with ctx.Pool(4) as pool:
+        results = pool.starmap(client_evaluate, [(server.name, inputs)] * 4)
+    for outputs in results:
+        for x, y in zip(inputs, outputs):
+            assert np.allclose(y, 2 * x)
+    assert server.num_requests >= 400
+
+
+def test_server_stopped(server):
+    client = EvaluationClient(server.name)
+    server.stop()
+    with pytest.raises(RuntimeError):
+        client.evaluate(BASIC_MODEL_NAME, np.ones(3))
+    with pytest.raises(RuntimeError):
+        EvaluationClient(server.name)
@@ -0,0 +1,52 @@
+import pytest
+import numpy as np
+
+from CppADCodeGenEigenPy import CompiledModel, StreamingEvaluator
+
+MODEL_NAME = "ParameterizedTestModel"
+MODEL_LIB_NAME = "lib" + MODEL_NAME
+
+NUM_ROWS = 100
+NUM_INPUT = 3
+NUM_PARAM = NUM_INPUT
+NUM_OUTPUT = 1
+
+
+@pytest.fixture
+def model(pytestconfig):
+    lib_path = str(
+        pytestconfig.rootdir / pytestconfig.getoption("builddir") / MODEL_LIB_NAME
+    )
+    return CompiledModel(MODEL_NAME, lib_path)
+
+
+def test_streaming_evaluate(model, tmp_path):
+    xs = np.random.random((NUM_ROWS, NUM_INPUT))
+    ps = np.random.random((NUM_ROWS, NUM_PARAM))
+    np.save(tmp_path / "inputs.npy", xs)
+    np.save(tmp_path / "parameters.npy", ps)
+
+    evaluator = StreamingEvaluator(model, num_threads=2, chunk_size=7)
+    evaluator.evaluate(
+        str(tmp_path / "inputs.npy"),
+        str(tmp_path / "outputs.npy"),
+        jacobian_path=str(tmp_path / "jacobians.npy"),
+        parameters_path=str(tmp_path / "parameters.npy"),
+    )
+
+    ys = np.load(tmp_path / "outputs.npy")
+    Js = np.load(tmp_path / "jacobians.npy")
+    assert ys.shape == (NUM_ROWS, NUM_OUTPUT)
+    assert Js.shape == (NUM_ROWS, NUM_OUTPUT, NUM_INPUT)
+    for x, p, y, J in zip(xs, ps, ys, Js):
+        assert np.allclose(y, model.evaluate(x, p))
+        assert np.allclose(J, model.jacobian(x, p))
+
+
+def test_streaming_evaluate_wrong_size(model, tmp_path):
+    np.save(tmp_path / "inputs.npy", np.ones((NUM_ROWS, NUM_INPUT)))
+
+    # missing parameters
+    evaluator = StreamingEvaluator(model)
+    with pytest.raises(RuntimeError):
+        evaluator.evaluate(str(tmp_path / "inputs.npy"), str(tmp_path / "outputs.npy"))